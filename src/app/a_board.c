@@ -3,13 +3,14 @@
  * @brief   板级初始化实现
  *          按 HAL → DRVL → SRVL 顺序创建并初始化所有模块
  */
+#define LOG_MODULE  BOARD
+
 #include "a_board.h"
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
 #define USART1_BAUD             115200
-#define USART2_BAUD             115200
-#define TICK_PERIOD_MS          10
+#define USART2_BAUD             921600
 
 // 实际每毫米的脉冲数 (经测量校准)
 #define ACTUAL_PULSE_PER_MM     15.518f
@@ -38,10 +39,35 @@ static const usart_cfg_t usart1_cfg = {
     .id = USART_1,
     .baudrate = USART1_BAUD,
     .enable_rx_irq = 1,
+    .enable_tx_irq = 1,
+    .nvic_preempt = 3,
+    .nvic_sub = 3,
+};
+
+// 日志通道: 只发送, 优先级低于命令串口
+static const usart_cfg_t usart2_cfg = {
+    .id = USART_2,
+    .baudrate = USART2_BAUD,
+    .enable_rx_irq = 0,
+    .enable_tx_irq = 1,
     .nvic_preempt = 3,
     .nvic_sub = 3,
 };
 
+// 升降台位置环: 继电器只能开关控制, 以 P 输出的符号决定方向, 死区内停止
+static const pid_cfg_t lift_pid_cfg = {
+    .mode = PID_MODE_P,
+    .features = PID_FEAT_DEADBAND,
+    .kp = 1.0f,
+    .ki = 0.0f,
+    .kd = 0.0f,
+    .max_out = 0.0f,
+    .integral_separation = 0.0f,
+    .dead_band = 5.0f,
+    .diff_filter_alpha = 0.0f,
+    .output_max_rate = 0.0f,
+};
+
 static const tim_cfg_t tim_cfg_table[TIM_COUNT] = {
     [TIM_2] = {
         .id = TIM_2,
@@ -68,30 +94,44 @@ static const tim_cfg_t tim_cfg_table[TIM_COUNT] = {
             .encoder_mode = TIM_EncoderMode_TI12,
         },
     },
-    [TIM_3] = {
-        .id = TIM_3,
-        .periph = TIM3,
-        .mode = TIM_MODE_BASE,
-        .prescaler = 720 - 1,
-        .period = 1000 - 1,    // 72 MHz / 720 / 1000 = 10 ms
-        .enable_irq = 1,
-        .nvic_preempt = 1,
-        .nvic_sub = 1,
-    },
 };
 
 can_t can;
 usart_t usart1;
 usart_t usart2;
-tim_t tick;
 
 Encoder lift_encoder;
 Relay lift_relay;
 Gripper gripper;
+PID lift_pid;
 
-// ! ========================= 私 有 函 数 声 明 ========================= ! //
+// 任务函数
+static void control_task(void);
+static void comms_task(void);
+
+/**
+ * @brief   任务表 (同时就绪时按表中顺序运行)
+ */
+static const sched_task_cfg_t task_table[] = {
+    { .name = "control", .fn = control_task,     .period_ms = TICK_PERIOD_MS },
+    { .name = "comms",   .fn = comms_task,       .period_ms = 0 },
+    { .name = "fsm",     .fn = a_fsm_process,    .period_ms = 0 },
+    { .name = "tlm",     .fn = s_telemetry_task, .period_ms = 0 },
+    { .name = "log",     .fn = s_log_task,       .period_ms = 0 },
+    { .name = "trace",   .fn = s_trace_task,     .period_ms = 0 },
+    { .name = "timer",   .fn = s_timer_task,     .period_ms = 0 },
+};
+#define TASK_COUNT  (sizeof(task_table) / sizeof(task_table[0]))
+
+// CPU 占用统计 (DWT 周期, 自上次报告以来)
+static uint32_t _cpu_last_cyc = 0;
+static uint64_t _cpu_total_cyc = 0;
+static uint64_t _cpu_sleep_cyc = 0;
 
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
 
+static void telemetry_sample(telemetry_sample_t* out);
+static void estop_hook(void);
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
@@ -103,32 +143,146 @@ Gripper gripper;
 void a_board_init(void) {
     NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
 
+    /* 状态机 (事件队列需在任何中断投递前就绪, 停留超时使用软件定时器) */
+    s_timer_init(systick_get_ms, dwt_get_cycles);
+    a_fsm_init();
+
     /* 底层时基 */
-    systick_init();
     dwt_init();
+    systick_init();
+    // WFI 休眠期间保持内核时钟 (HCLK/FCLK), 使 DWT CYCCNT 继续计数: 微秒时基、DWT 延时与
+    // a_board_idle 的休眠统计都依赖于此 (毫秒时基在 CYCCNT 停止时改按 SysTick 中断计数, 见 clock_tick).
+    // 代价: 休眠时内核时钟不再门控, 休眠电流高于普通 Sleep 模式; 低功耗场合可去掉, 但 $CPU 的休眠时间将记为 0
+    DBGMCU_Config(DBGMCU_SLEEP, ENABLE);
 
     /* 创建对象 */
     lift_encoder = encoder_create();
     lift_relay = relay_create();
     gripper = gripper_create();
+    lift_pid = pid_create();
 
     /* HAL 初始化 */
     can_init(&can, &can_cfg);
     usart_init(&usart1, &usart1_cfg);
-    tim_init(&tick, &tim_cfg_table[TIM_3]);
+#if BOARD_LOG_USART2
+    usart_init(&usart2, &usart2_cfg);
+#endif
 
     /* 驱动初始化 */
-    lift_encoder.init(&lift_encoder, &tim_cfg_table[TIM_2], 10, ACTUAL_PULSE_PER_MM);
+    lift_encoder.init(&lift_encoder, &tim_cfg_table[TIM_2], TICK_PERIOD_MS, ACTUAL_PULSE_PER_MM);
     lift_relay.init(&lift_relay, &relay_cfg);
     gripper.init(&gripper, &can, 0x01);
 
     /* 服务初始化 */
-    s_delay_init(systick_get_ms, systick_is_timeout, dwt_get_us, dwt_is_timeout);
+    s_delay_init(clock_get_ms, clock_get_us);
     s_wireless_comms_init(&usart1, &lift_relay, &gripper);
+    s_fault_init(systick_get_ms, a_fsm_state_id);
+    s_timer_register_cmds();
+    s_prof_init();
+    a_fsm_register_cmds();
+    s_wireless_comms_set_target_hook(a_fsm_notify_lift_target);
+    s_wireless_comms_set_busy_hook(a_fsm_motion_busy);
+    s_estop_init(&usart1, &lift_relay, estop_hook);
+#if BOARD_LOG_USART2
+    s_log_init(&usart2, systick_get_ms);
+    s_telemetry_init(&usart2, systick_get_ms, telemetry_sample);
+    s_trace_init(&usart2, systick_get_ms);
+    s_pid_tuner_init(&usart2, systick_get_ms);
+#else
+    s_log_init(0, systick_get_ms);
+    s_telemetry_init(&usart1, systick_get_ms, telemetry_sample);
+    s_trace_init(&usart1, systick_get_ms);
+    s_pid_tuner_init(&usart1, systick_get_ms);
+#endif
+
+    lift_pid.init_cfg(&lift_pid, &lift_pid_cfg);
+    s_pid_tuner_register(&lift_pid, "lift");
 
     s_delay_ms(1000);
-    printf("Board initialized!\r\n");
+    s_log_info("Board initialized!");
+    s_fault_report();
+
+    /* 调度器 */
+    s_sched_init(task_table, TASK_COUNT, systick_get_ms, dwt_get_cycles);
+    s_sched_set_idle(a_board_idle);
+    _cpu_last_cyc = dwt_get_cycles();
+}
+
+/**
+ * @brief   调度器空闲钩子: 无待处理工作时以 WFI 休眠
+ * @note    关中断后再检查唤醒条件, 避免检查与 WFI 之间到来的中断被错过;
+ *          PRIMASK 置位时挂起的中断仍会唤醒 WFI, 开中断后立即执行.
+ *          唤醒源: SysTick (1 ms, 周期任务释放), USART1 接收, CAN 接收
+ */
+void a_board_idle(void) {
+    uint32_t start = dwt_get_cycles();
+    uint32_t end = start;
+
+    __disable_irq();
+    if(!a_fsm_has_pending() && !s_wireless_comms_rx_pending() && !s_sched_pending()) {
+        __WFI();
+        end = dwt_get_cycles();
+    }
+    __enable_irq();
+
+    _cpu_sleep_cyc += end - start;
+    _cpu_total_cyc += end - _cpu_last_cyc;
+    _cpu_last_cyc = end;
+}
+
+/**
+ * @brief   输出 CPU 占用率并清零统计
+ * @note    格式: $CPU:<负载 %>,<运行 ms>,<休眠 ms>#
+ */
+void a_board_cpu_report(void) {
+    uint64_t total = _cpu_total_cyc;
+    uint64_t sleep = _cpu_sleep_cyc;
+    uint64_t active = total - sleep;
+    float load = total ? (float)active * 100.0f / (float)total : 0.0f;
+
+    char num[NUM_FMT_BUF_SIZE];
+
+    s_num_fmt_f32(num, load, 1);
+    printf("$CPU:%s,%lu,%lu#", num,
+        (unsigned long)(active / (CPU_FREQ_MHZ * 1000u)), (unsigned long)(sleep / (CPU_FREQ_MHZ * 1000u)));
+    _cpu_total_cyc = 0;
+    _cpu_sleep_cyc = 0;
 }
 
 // ! ========================= 私 有 函 数 实 现 ========================= ! //
 
+/**
+ * @brief   控制任务: 更新编码器, 执行到期的定时命令与状态机控制周期动作, 输出 PID 流式数据
+ */
+static void control_task(void) {
+    lift_encoder.update(&lift_encoder);
+    s_wireless_comms_tick(TICK_PERIOD_MS);
+    a_fsm_control();
+    s_pid_tuner_stream();
+}
+
+/**
+ * @brief   通信任务: 处理串口命令
+ */
+static void comms_task(void) {
+    s_wireless_comms_process();
+}
+
+/**
+ * @brief   遥测采样: 升降台位置/速度/目标, 继电器方向, 夹爪指令角度, 状态机状态
+ */
+static void telemetry_sample(telemetry_sample_t* out) {
+    out->pos_mm = lift_encoder.get_position(&lift_encoder);
+    out->speed_mm_s = lift_encoder.get_speed(&lift_encoder);
+    out->target_mm = a_fsm_lift_target();
+    out->grip_rad = gripper.get_angle(&gripper);
+    out->relay_dir = (uint8_t)lift_relay.get_dir(&lift_relay);
+    out->state_id = a_fsm_state_id();
+}
+
+/**
+ * @brief   急停通知 (串口接收中断中调用): 继电器已断开, 以高优先级投递 EVENT_ERROR
+ */
+static void estop_hook(void) {
+    a_fsm_trigger_event(EVENT_ERROR);
+}
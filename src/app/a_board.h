@@ -10,31 +10,51 @@
 #include "timer.h"
 #include "systick.h"
 #include "dwt.h"
+#include "clock.h"
 
 #include "d_encoder.h"
 #include "d_relay.h"
 #include "d_gripper.h"
 
 #include "s_delay.h"
+#include "s_estop.h"
+#include "s_fault.h"
 #include "s_log.h"
+#include "s_num.h"
 #include "s_pid.h"
+#include "s_pid_tuner.h"
+#include "s_prof.h"
+#include "s_sched.h"
+#include "s_telemetry.h"
+#include "s_timer.h"
+#include "s_trace.h"
 #include "s_wireless_comms.h"
 
 #include "a_fsm.h"
 
 // ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
 
+// 控制周期 (调度器控制任务周期)
+#define TICK_PERIOD_MS          10
+
+// 日志 / 波形 / 遥测输出通道: 1 为独立的 USART2 (高波特率, 非阻塞), 0 为与命令及回复共用 USART1
+#ifndef BOARD_LOG_USART2
+#define BOARD_LOG_USART2        1
+#endif
+
 extern can_t can;
 extern usart_t usart1;
 extern usart_t usart2;
-extern tim_t tick;
 
 extern Encoder lift_encoder;
 extern Relay lift_relay;
 extern Gripper gripper;
+extern PID lift_pid;
 
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
 
 void a_board_init(void);
+void a_board_idle(void);
+void a_board_cpu_report(void);
 
 #endif
@@ -8,10 +8,17 @@
  * ├──  NormalState (state_normal)
  * |    |
  * |    ├── IdleState (state_idle)
- * |    └── LiftMovingState (state_lift_moving)
+ * |    ├── LiftMovingState (state_lift_moving)
+ * |    └── PickState (state_pick)
+ * |         |
+ * |         ├── PickApproachState (state_pick_approach)
+ * |         ├── PickGraspState (state_pick_grasp)
+ * |         ├── PickRetractState (state_pick_retract)
+ * |         └── PickReleaseState (state_pick_release)
  * |
  * └──  ErrorState (state_error)
  */
+#define LOG_MODULE  FSM
 
 #include "a_fsm.h"
 #include "a_board.h"
@@ -21,25 +28,140 @@
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
+// 升降台单次移动超时 (ms)
+#define LIFT_MOVE_TIMEOUT_MS    30000
+// 堵转判定: LIFT_STALL_TIMEOUT_MS 内位移不足 LIFT_STALL_MIN_MM 视为堵转或编码器失效
+#define LIFT_STALL_TIMEOUT_MS   1000
+#define LIFT_STALL_MIN_MM       1.0f
+// 升降台到位判定: 进入死区且速度低于该值 (mm/s)
+#define LIFT_SETTLED_SPEED      2.0f
+// 完整抓取流程超时 (ms)
+#define PICK_TIMEOUT_MS         60000
+
 event_e cur_event = EVENT_NONE;
+evq_arg_t cur_event_arg;
 State* cur_state = &state_idle;
 
+// 待处理事件队列 (主循环与中断均可投递)
+static evq_t _evq;
+
+// 升降台目标或位置已变化, 空闲状态需重新检查是否需要移动
+static bool _lift_dirty = true;
+static float _lift_last_pos = 0.0f;             // 上一控制周期的编码器位置
+
+typedef void(*fsm_fn_t)(void);
+
+// _next 表中的特殊值
+#define FSM_ROUTE_NONE      0xFF    // 无转移
+#define FSM_ROUTE_LEGACY    0xFE    // 需经由 handle_event 兼容接口运行时查找
+
+/**
+ * @brief   预计算的转移路径: 动作池 _pool[off, off+len) 依次为退出动作与进入动作
+ */
+typedef struct {
+    uint8_t dst;
+    uint8_t len;
+    uint16_t off;
+    uint16_t exit_mask;     // 退出的状态集合 (按状态 ID 置位)
+    uint16_t entry_mask;    // 进入的状态集合
+} fsm_route_t;
+
+/**
+ * @brief   预计算的持续动作序列: 当前状态 -> 父状态 -> ... -> 根状态
+ */
+typedef struct {
+    uint16_t off;
+    uint8_t len;
+} fsm_span_t;
+
+static uint8_t _next[FSM_MAX_STATES][EVENT_MAX];
+static fsm_route_t _routes[FSM_MAX_ROUTES];
+static fsm_span_t _spans[FSM_MAX_STATES];
+static fsm_fn_t _pool[FSM_ACTION_POOL];
+static uint8_t _route_count = 0;
+static uint16_t _pool_used = 0;
+
+/**
+ * @brief   定时事件 (s_timer 定时器的回调参数)
+ */
+typedef struct {
+    timer_handle_t handle;  // 所用的 s_timer 定时器, 负数为空闲
+    uint32_t period;        // 周期 (ms), 0 为单次
+    evq_arg_t arg;
+    uint8_t event;
+} fsm_timer_t;
+
+static uint32_t(*_get_ms)(void) = systick_get_ms;
+static fsm_timer_t _timers[FSM_TIMER_MAX];
+static uint16_t _timeout_mask = 0;              // 设置了停留超时的状态集合
+static timer_handle_t _state_timer[FSM_MAX_STATES];        // 各状态停留超时所用的定时器句柄
+
+// 转移耗时统计 (周期数, 含退出/进入动作本身)
+static uint32_t _trans_count = 0;
+static uint32_t _trans_last_cyc = 0;
+static uint32_t _trans_max_cyc = 0;
+
+#if FSM_PROFILE
+/**
+ * @brief   单个状态的计时统计
+ */
+typedef struct {
+    uint32_t entries;           // 进入次数
+    uint32_t time_ms;           // 累计停留时间 (不含当前这一次)
+    uint32_t action_n;          // 持续动作与控制周期动作的执行次数
+    uint32_t action_min;        // 单次动作耗时 (周期)
+    uint32_t action_max;
+    uint64_t action_sum;
+} fsm_prof_t;
+
+static fsm_prof_t _prof[FSM_MAX_STATES];
+static uint8_t _pool_owner[FSM_ACTION_POOL];    // 动作池中持续动作所属的状态 ID
+static ms_t _state_enter_ms = 0;
+static uint32_t _loop_prev_cyc = 0;
+static uint32_t _loop_hist[FSM_PROF_HIST_BINS];
+static uint32_t _process_max_cyc = 0;
+
+static void prof_reset(void);
+static void prof_loop(uint32_t now);
+static void prof_transition(const State* from, const State* to);
+static void prof_action(uint8_t id, uint32_t cyc);
+static void prof_report(void);
+
+#define FSM_PROF_LOOP(now)              prof_loop(now)
+#define FSM_PROF_TRANSITION(from, to)   prof_transition(from, to)
+#define FSM_PROF_OWNER(idx, id)         (_pool_owner[idx] = (id))
+#else
+#define FSM_PROF_LOOP(now)              ((void)0)
+#define FSM_PROF_TRANSITION(from, to)   ((void)(from), (void)(to))
+#define FSM_PROF_OWNER(idx, id)         ((void)0)
+#endif
+
 // ! ========================= 私 有 函 数 声 明 ========================= ! //
 
+static bool is_indexed(const State* state);
+static void build_tables(void);
+static uint8_t resolve_route(const State* state, event_e e);
+static uint8_t walk_path(State* from, State* to, fsm_fn_t* out, uint16_t* exit_mask, uint16_t* entry_mask);
+static bool transition(event_e e);
+static void update_timeouts(uint16_t exit_mask, uint16_t entry_mask);
+static fsm_timer_t* timer_from_handle(timer_handle_t handle);
+static void timer_fire(void* arg);
 static State* dispatch_event(State* state, event_e e);
 static State* find_lca(State* s1, State* s2);
-static void exit_up_to(State* from, State* to);
-static void enter_down_to(State* from, State* to);
 static void execute_action(State* state);
+static void run_bench(void);
+static void lift_drive_begin(float target);
+static bool lift_drive_step(float target);
+static void lift_drive_end(void);
+static void pick_phase_begin(uint8_t phase);
+static void pick_phase_end(void);
 
 /**
  * @brief   正常状态
  */
-static State* normal_handle_event(event_e e);
-static void normal_action(void);
 State state_normal = {
-    .handle_event = normal_handle_event,
-    .action = normal_action,
+    .handle_event = 0,
+    .action = 0,
     .entry = 0,
     .exit = 0,
 
@@ -50,12 +172,12 @@ State state_normal = {
 /**
  * @brief   空闲状态
  */
-static State* idle_handle_event(event_e e);
 static void idle_action(void);
+static void idle_entry(void);
 State state_idle = {
-    .handle_event = idle_handle_event,
+    .handle_event = 0,
     .action = idle_action,
-    .entry = 0,
+    .entry = idle_entry,
     .exit = 0,
 
     .name_ = "idle",
@@ -65,27 +187,125 @@ State state_idle = {
 /**
  * @brief   升降台移动状态
  */
-static State* lift_moving_handle_event(event_e e);
-static void lift_moving_action(void);
+static void lift_moving_control(void);
 static void lift_moving_entry(void);
 static void lift_moving_exit(void);
 State state_lift_moving = {
-    .handle_event = lift_moving_handle_event,
-    .action = lift_moving_action,
+    .handle_event = 0,
+    .action = 0,
+    .control = lift_moving_control,
     .entry = lift_moving_entry,
     .exit = lift_moving_exit,
 
+    .timeout_ms_ = LIFT_MOVE_TIMEOUT_MS,
+    .timeout_event_ = EVENT_ERROR,
+
     .name_ = "lift_moving",
     ._parent_ = &state_normal,
 };
 
+// 堵转检测定时器与上一次有效位移处的位置
+static timer_handle_t _lift_stall_timer = -1;
+static float _lift_stall_pos = 0.0f;
+
+/**
+ * @brief   抓取流程状态 (接近 -> 夹取 -> 抬升 -> 释放)
+ */
+static void pick_entry(void);
+static void pick_exit(void);
+State state_pick = {
+    .handle_event = 0,
+    .action = 0,
+    .entry = pick_entry,
+    .exit = pick_exit,
+
+    .timeout_ms_ = PICK_TIMEOUT_MS,
+    .timeout_event_ = EVENT_ERROR,
+
+    .name_ = "pick",
+    ._parent_ = &state_normal,
+};
+
+/**
+ * @brief   抓取-接近状态: 张开夹爪, 升降台移动到接近高度
+ */
+static void pick_lift_control(void);
+static void pick_approach_entry(void);
+static void pick_approach_exit(void);
+State state_pick_approach = {
+    .handle_event = 0,
+    .action = 0,
+    .control = pick_lift_control,
+    .entry = pick_approach_entry,
+    .exit = pick_approach_exit,
+
+    .name_ = "pick_approach",
+    ._parent_ = &state_pick,
+};
+
+/**
+ * @brief   抓取-夹取状态: 夹爪转到夹取角度
+ */
+static void pick_grasp_entry(void);
+State state_pick_grasp = {
+    .handle_event = 0,
+    .action = 0,
+    .entry = pick_grasp_entry,
+    .exit = pick_phase_end,
+
+    .name_ = "pick_grasp",
+    ._parent_ = &state_pick,
+};
+
+/**
+ * @brief   抓取-抬升状态: 升降台移动到抬升高度
+ */
+static void pick_retract_entry(void);
+State state_pick_retract = {
+    .handle_event = 0,
+    .action = 0,
+    .control = pick_lift_control,
+    .entry = pick_retract_entry,
+    .exit = pick_approach_exit,
+
+    .name_ = "pick_retract",
+    ._parent_ = &state_pick,
+};
+
+/**
+ * @brief   抓取-释放状态: 张开夹爪
+ */
+static void pick_release_entry(void);
+static void pick_release_exit(void);
+State state_pick_release = {
+    .handle_event = 0,
+    .action = 0,
+    .entry = pick_release_entry,
+    .exit = pick_release_exit,
+
+    .name_ = "pick_release",
+    ._parent_ = &state_pick,
+};
+
+// 抓取流程参数与各阶段耗时
+enum { PICK_APPROACH = 0, PICK_GRASP, PICK_RETRACT, PICK_RELEASE, PICK_PHASES };
+static float _pick_approach_mm = 0.0f;
+static float _pick_grasp_rad = 0.0f;
+static float _pick_retract_mm = 0.0f;
+static float _pick_target_mm = 0.0f;           // 当前阶段的升降目标 (不占用 lift_target_pos_mm)
+static uint32_t _pick_phase_ms[PICK_PHASES];
+static uint32_t _pick_phase_start = 0;
+static uint8_t _pick_phase = 0;
+static bool _pick_done = false;
+static bool _pick_requested = false;           // 已受理 $PICK, 尚未进入接近状态 (同一轮命令处理中拒绝再次受理)
+static timer_handle_t _pick_settle_timer = -1;
+
 /**
  * @brief   错误状态
  */
-static State* error_handle_event(event_e e);
 static void error_entry(void);
 State state_error = {
-    .handle_event = error_handle_event,
+    .handle_event = 0,
     .action = 0,
     .entry = error_entry,
     .exit = 0,
@@ -94,51 +314,521 @@ State state_error = {
     ._parent_ = 0,
 };
 
+/**
+ * @brief   状态表 (下标即状态 ID)
+ */
+static State* const _states[] = {
+    &state_normal,
+    &state_idle,
+    &state_lift_moving,
+    &state_error,
+    &state_pick,
+    &state_pick_approach,
+    &state_pick_grasp,
+    &state_pick_retract,
+    &state_pick_release,
+};
+#define FSM_STATE_COUNT  (sizeof(_states) / sizeof(_states[0]))
+
+/**
+ * @brief   转移表
+ */
+static const fsm_transition_t _transitions[] = {
+    { &state_normal,        EVENT_ERROR,        &state_error },
+    { &state_idle,          EVENT_LIFT_MOVE,    &state_lift_moving },
+    { &state_lift_moving,   EVENT_LIFT_STOP,    &state_idle },
+    { &state_error,         EVENT_OK,           &state_idle },
+    { &state_idle,          EVENT_PICK_START,   &state_pick_approach },
+    { &state_pick,          EVENT_PICK_ABORT,   &state_idle },
+    { &state_pick_approach, EVENT_PICK_NEXT,    &state_pick_grasp },
+    { &state_pick_grasp,    EVENT_PICK_NEXT,    &state_pick_retract },
+    { &state_pick_retract,  EVENT_PICK_NEXT,    &state_pick_release },
+    { &state_pick_release,  EVENT_PICK_NEXT,    &state_idle },
+};
+#define FSM_TRANSITION_COUNT  (sizeof(_transitions) / sizeof(_transitions[0]))
+
+/**
+ * @brief   串口命令表
+ */
+static comms_status_e cmd_pick(const comms_args_t* args);
+static comms_status_e cmd_pick_abort(const comms_args_t* args);
+static comms_status_e cmd_tasks(const comms_args_t* args);
+static comms_status_e cmd_tasks_clr(const comms_args_t* args);
+static comms_status_e cmd_cpu(const comms_args_t* args);
+static comms_status_e cmd_fsm_bench(const comms_args_t* args);
+static comms_status_e cmd_fsm_stats(const comms_args_t* args);
+static comms_status_e cmd_fsm_stats_clr(const comms_args_t* args);
+static comms_status_e cmd_fsm_states(const comms_args_t* args);
+static const comms_cmd_t _cmds[] = {
+    { "PICK",           "fff",  cmd_pick,           0,  COMMS_DONE_PICK },
+    { "PICK_ABORT",     "",     cmd_pick_abort,     0,  COMMS_DONE_NONE },
+    { "TASKS",          "",     cmd_tasks,          0,  COMMS_DONE_NONE },
+    { "TASKS_CLR",      "",     cmd_tasks_clr,      0,  COMMS_DONE_NONE },
+    { "CPU",            "",     cmd_cpu,            0,  COMMS_DONE_NONE },
+    { "FSM_BENCH",      "",     cmd_fsm_bench,      0,  COMMS_DONE_NONE },
+    { "FSM_STATS",      "",     cmd_fsm_stats,      0,  COMMS_DONE_NONE },
+    { "FSM_STATS_CLR",  "",     cmd_fsm_stats_clr,  0,  COMMS_DONE_NONE },
+    { "FSM_STATES",     "",     cmd_fsm_states,     0,  COMMS_DONE_NONE },
+};
+#define FSM_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
 /**
- * @brief   FSM 处理函数
+ * @brief   FSM 初始化
+ * @note    需在 s_timer_init 之后、任何事件投递之前调用; 预计算所有 (状态, 事件) 的目标状态与动作序列
  */
-void a_fsm_process(void) {
-    // 无事件时执行当前状态的持续动作
-    if(cur_event == EVENT_NONE) {
-        execute_action(cur_state);
-        return;
+void a_fsm_init(void) {
+    s_event_queue_init(&_evq);
+    cur_event = EVENT_NONE;
+    cur_event_arg.u = 0;
+
+    for(uint8_t i = 0; i < FSM_TIMER_MAX; ++i) _timers[i].handle = -1;
+    for(uint8_t i = 0; i < FSM_MAX_STATES; ++i) _state_timer[i] = -1;
+    _pick_requested = false;
+
+    build_tables();
+
+    // 初始状态链上的停留超时
+    uint16_t entry_mask = 0;
+    for(State* p = cur_state; p; p = p->_parent_) {
+        if(is_indexed(p)) entry_mask |= (uint16_t)(1u << p->_id_);
     }
+    update_timeouts(0, entry_mask);
+#if FSM_PROFILE
+    prof_reset();
+#endif
+}
 
-    // 根据当前事件和状态获取下一个状态
-    State* next_state = dispatch_event(cur_state, cur_event);
-    if(next_state != cur_state) {
-        // 找到最近公共祖先状态
-        State* lca = find_lca(cur_state, next_state);
+/**
+ * @brief   FSM 处理函数
+ */
+void a_fsm_process(void) {
+    evq_item_t ev;
+    uint8_t budget = FSM_EVENT_BUDGET;
+#if FSM_PROFILE
+    uint32_t loop_start = dwt_get_cycles();
+    FSM_PROF_LOOP(loop_start);
+#endif
 
-        // 从当前状态退出到最近公共祖先状态, 再从最近公共祖先状态进入到下一个状态
-        exit_up_to(cur_state, lca);
-        enter_down_to(lca, next_state);
+    // 依次处理待处理事件 (高优先级优先), 每个事件只分发一次
+    while(budget-- && s_event_queue_pop(&_evq, &ev)) {
+        cur_event = (event_e)ev.id;
+        cur_event_arg = ev.arg;
 
-        // 状态转移并清除事件
-        cur_state = next_state;
+        State* from = cur_state;
+        uint32_t start = dwt_get_cycles();
+        if(transition(cur_event)) {
+            _trans_last_cyc = dwt_get_cycles() - start;
+            if(_trans_last_cyc > _trans_max_cyc) _trans_max_cyc = _trans_last_cyc;
+            _trans_count++;
+            FSM_PROF_TRANSITION(from, cur_state);
+            s_trace_record(TRACE_EV_FSM, (uint8_t)cur_event,
+                (uint16_t)((is_indexed(from) ? from->_id_ : 0xFFu) << 8 | a_fsm_state_id()), cur_event_arg.u);
+        }
+        if(cur_event == EVENT_PICK_START && _pick_requested) {
+            // 受理 $PICK 后、事件处理前已离开空闲 (如先处理了移动事件): 流程未启动
+            _pick_requested = false;
+            s_wireless_comms_complete(COMMS_DONE_PICK, COMMS_ERR_ABORTED);
+        }
         cur_event = EVENT_NONE;
     }
 
     // 状态持续动作
     execute_action(cur_state);
+
+#if FSM_PROFILE
+    uint32_t process_cyc = dwt_get_cycles() - loop_start;
+    if(process_cyc > _process_max_cyc) _process_max_cyc = process_cyc;
+#endif
 }
 
 /**
- * @brief   触发事件
+ * @brief   FSM 控制周期处理函数
+ * @note    由调度器的控制任务在编码器更新之后调用; 依次执行当前状态及其祖先状态的控制周期动作,
+ *          耗时与持续动作一并计入所属状态的动作统计
+ */
+void a_fsm_control(void) {
+    // 编码器位置变化时空闲状态才需重新检查, 静止时主循环不必每个控制周期唤醒
+    float pos = lift_encoder.get_position(&lift_encoder);
+    if(pos != _lift_last_pos) {
+        _lift_last_pos = pos;
+        _lift_dirty = true;
+    }
+
+    for(State* s = cur_state; s; s = s->_parent_) {
+        if(!s->control) continue;
+#if FSM_PROFILE
+        uint32_t start = dwt_get_cycles();
+        s->control();
+        if(is_indexed(s)) prof_action(s->_id_, dwt_get_cycles() - start);
+#else
+        s->control();
+#endif
+    }
+}
+
+/**
+ * @brief   触发事件 (无负载)
  * @param   e 事件
+ * @note    EVENT_ERROR 以高优先级投递, 其余为普通优先级; 可在中断中调用
  */
 void a_fsm_trigger_event(event_e e) {
-    cur_event = e;
+    evq_arg_t arg;
+    arg.u = 0;
+    a_fsm_post_event(e, arg, e == EVENT_ERROR ? EVQ_PRIO_HIGH : EVQ_PRIO_NORMAL);
+}
+
+/**
+ * @brief   投递带负载的事件
+ * @param   e 事件
+ * @param   arg 事件负载, 处理时可通过 cur_event_arg 读取
+ * @param   prio 优先级
+ * @retval  bool - true:成功, false:队列满 (计入溢出计数)
+ * @note    可在中断中调用
+ */
+bool a_fsm_post_event(event_e e, evq_arg_t arg, evq_prio_e prio) {
+    if(e == EVENT_NONE || e >= EVENT_MAX) return false;
+    return s_event_queue_push(&_evq, prio, (uint16_t)e, arg);
+}
+
+/**
+ * @brief   获取事件队列溢出计数
+ * @param   prio 优先级
+ * @retval  uint32_t 被丢弃的事件数
+ */
+uint32_t a_fsm_event_overflow(evq_prio_e prio) {
+    return s_event_queue_overflow(&_evq, prio);
+}
+
+/**
+ * @brief   设置状态机时钟源
+ * @param   get_ms 获取当前毫秒数的函数指针 (默认 systick_get_ms, 可替换为模拟时钟)
+ * @note    需在 a_fsm_init 之前调用; 状态停留时间统计与抓取各阶段计时均经此读取
+ * @note    定时事件与状态停留超时由 s_timer 驱动, 使用 s_timer_init 传入的时钟, 两者应为同一时钟
+ */
+void a_fsm_set_clock(uint32_t(*get_ms)(void)) {
+    _get_ms = get_ms;
+}
+
+/**
+ * @brief   定时投递事件
+ * @param   e 事件
+ * @param   arg 事件负载
+ * @param   delay_ms 首次投递延时 (ms), 至少为 1
+ * @param   period_ms 之后的投递周期 (ms), 0 为单次
+ * @retval  timer_handle_t 定时器句柄, -1 表示定时事件或 s_timer 定时器已用尽
+ * @note    由 s_timer 的时间轮计时, 到期时在 timer 任务中投递事件; 单次定时器到期后句柄自动释放;
+ *          延时自当前时刻起算, timer 任务落后于当前时刻时也不会提前投递
+ */
+timer_handle_t a_fsm_schedule_event(event_e e, evq_arg_t arg, uint32_t delay_ms, uint32_t period_ms) {
+    if(e == EVENT_NONE || e >= EVENT_MAX) return -1;
+    for(uint8_t i = 0; i < FSM_TIMER_MAX; ++i) {
+        fsm_timer_t* t = &_timers[i];
+        if(t->handle >= 0) continue;
+        t->handle = s_timer_create(timer_fire, t);
+        if(t->handle < 0) return -1;
+        t->event = (uint8_t)e;
+        t->arg = arg;
+        t->period = period_ms;
+        s_timer_start(t->handle, delay_ms, period_ms);
+        return t->handle;
+    }
+    return -1;
+}
+
+/**
+ * @brief   以新的延时重新启动定时器
+ * @param   handle 定时器句柄
+ * @param   delay_ms 距下一次投递的延时 (ms)
+ * @retval  bool - true:成功, false:句柄无效或已到期释放
+ */
+bool a_fsm_restart_event(timer_handle_t handle, uint32_t delay_ms) {
+    fsm_timer_t* t = timer_from_handle(handle);
+    if(!t) return false;
+    return s_timer_start(handle, delay_ms, t->period);
+}
+
+/**
+ * @brief   取消定时器
+ * @param   handle 定时器句柄 (无效或已到期释放的句柄忽略)
+ */
+void a_fsm_cancel_event(timer_handle_t handle) {
+    fsm_timer_t* t = timer_from_handle(handle);
+    if(!t) return;
+    s_timer_delete(handle);
+    t->handle = -1;
+}
+
+/**
+ * @brief   判断状态机是否有待处理的工作
+ * @retval  bool - true:有待处理事件或待检查的数据变更, false:可进入休眠
+ * @note    到期的定时事件由 SysTick 中断唤醒后在 timer 任务中投递
+ */
+bool a_fsm_has_pending(void) {
+    return !s_event_queue_empty(&_evq) || (_lift_dirty && cur_state == &state_idle);
+}
+
+/**
+ * @brief   升降台目标位置变更通知
+ * @param   target 新的目标位置 (mm)
+ */
+void a_fsm_notify_lift_target(float target) {
+    (void)target;
+    _lift_dirty = true;
+}
+
+/**
+ * @brief   判断运动命令是否须拒绝
+ * @retval  bool - true:抓取流程进行中 (升降台与夹爪由流程控制), false:可执行
+ * @note    作为 s_wireless_comms 的忙碌判断, $LIFT_SET / $LIFT_UP / $LIFT_DOWN / $GRIP_* 据此回复 COMMS_ERR_BUSY
+ */
+bool a_fsm_motion_busy(void) {
+    for(State* s = cur_state; s; s = s->_parent_) {
+        if(s == &state_pick) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief   获取升降台当前的控制目标
+ * @retval  float 抓取流程中为当前阶段目标, 否则为 lift_target_pos_mm (mm)
+ */
+float a_fsm_lift_target(void) {
+    return a_fsm_motion_busy() ? _pick_target_mm : lift_target_pos_mm;
+}
+
+/**
+ * @brief   获取当前状态 ID
+ * @retval  uint8_t 状态表下标 (与 $FSM_STATES# 对应), 当前状态不在状态表中时为 0xFF
+ */
+uint8_t a_fsm_state_id(void) {
+    return is_indexed(cur_state) ? cur_state->_id_ : 0xFF;
+}
+
+/**
+ * @brief   注册状态机相关的串口命令
+ * @note    需在 s_wireless_comms_init 之后调用; 命令说明见 cmd_xxx 各函数
+ */
+void a_fsm_register_cmds(void) {
+    s_wireless_comms_register(_cmds, FSM_CMD_COUNT);
 }
 
 // ! ========================= 私 有 函 数 实 现 ========================= ! //
 
 /**
- * @brief   FSM 事件分发函数
+ * @brief   判断状态是否在状态表中
+ */
+static bool is_indexed(const State* state) {
+    return state->_id_ < FSM_STATE_COUNT && _states[state->_id_] == state;
+}
+
+/**
+ * @brief   预计算转移表与动作序列
+ * @note    动作池或路径表容量不足时, 对应项退化为运行时查找 (FSM_ROUTE_LEGACY)
+ */
+static void build_tables(void) {
+    _route_count = 0;
+    _pool_used = 0;
+    _timeout_mask = 0;
+
+    // 状态 ID 与深度
+    for(uint8_t i = 0; i < FSM_STATE_COUNT && i < FSM_MAX_STATES; ++i) {
+        State* s = _states[i];
+        s->_id_ = i;
+        s->_depth_ = 0;
+        for(State* p = s; p; p = p->_parent_) s->_depth_++;
+        if(s->timeout_ms_) _timeout_mask |= (uint16_t)(1u << i);
+    }
+
+    // 持续动作序列
+    for(uint8_t i = 0; i < FSM_STATE_COUNT && i < FSM_MAX_STATES; ++i) {
+        _spans[i].off = _pool_used;
+        _spans[i].len = 0;
+        for(State* p = _states[i]; p; p = p->_parent_) {
+            if(p->action && _pool_used < FSM_ACTION_POOL) {
+                FSM_PROF_OWNER(_pool_used, p->_id_);
+                _pool[_pool_used++] = p->action;
+                _spans[i].len++;
+            }
+        }
+    }
+
+    // 转移路径
+    for(uint8_t i = 0; i < FSM_STATE_COUNT && i < FSM_MAX_STATES; ++i) {
+        for(uint8_t e = 0; e < EVENT_MAX; ++e) {
+            _next[i][e] = resolve_route(_states[i], (event_e)e);
+        }
+    }
+}
+
+/**
+ * @brief   求解状态 state 收到事件 e 时的转移路径
+ * @retval  路径下标, 或 FSM_ROUTE_NONE / FSM_ROUTE_LEGACY
+ * @note    查找顺序与 dispatch_event 一致: 当前状态 -> 父状态 -> ... -> 根状态
+ */
+static uint8_t resolve_route(const State* state, event_e e) {
+    State* dst = 0;
+
+    for(const State* s = state; s && !dst; s = s->_parent_) {
+        // 提供兼容接口的状态无法预计算
+        if(s->handle_event) return FSM_ROUTE_LEGACY;
+        for(uint8_t t = 0; t < FSM_TRANSITION_COUNT; ++t) {
+            if(_transitions[t].src == s && _transitions[t].event == e) {
+                dst = _transitions[t].dst;
+                break;
+            }
+        }
+    }
+
+    if(!dst || dst == state) return FSM_ROUTE_NONE;
+    if(!is_indexed(dst) || _route_count >= FSM_MAX_ROUTES) return FSM_ROUTE_LEGACY;
+
+    fsm_fn_t path[2 * FSM_DEPTH];
+    uint16_t exit_mask, entry_mask;
+    uint8_t n = walk_path((State*)state, dst, path, &exit_mask, &entry_mask);
+
+    // 复用目标、动作序列与状态集合完全相同的已有路径
+    for(uint8_t r = 0; r < _route_count; ++r) {
+        if(_routes[r].dst != dst->_id_ || _routes[r].len != n) continue;
+        if(_routes[r].exit_mask != exit_mask || _routes[r].entry_mask != entry_mask) continue;
+        uint8_t k = 0;
+        while(k < n && _pool[_routes[r].off + k] == path[k]) k++;
+        if(k == n) return r;
+    }
+
+    if(_pool_used + n > FSM_ACTION_POOL) return FSM_ROUTE_LEGACY;
+
+    fsm_route_t* route = &_routes[_route_count];
+    route->dst = dst->_id_;
+    route->off = _pool_used;
+    route->len = n;
+    route->exit_mask = exit_mask;
+    route->entry_mask = entry_mask;
+    for(uint8_t k = 0; k < n; ++k) _pool[_pool_used++] = path[k];
+    return _route_count++;
+}
+
+/**
+ * @brief   按状态树计算从 from 到 to 的退出/进入动作序列
+ * @param   from 初始状态
+ * @param   to 目标状态
+ * @param   out 输出动作序列 (容量 2 * FSM_DEPTH)
+ * @param   exit_mask 输出退出的状态集合 (可为 0)
+ * @param   entry_mask 输出进入的状态集合 (可为 0)
+ * @retval  动作个数
+ * @note    先由 from 向上依次退出到最近公共祖先 (不含), 再由最近公共祖先 (不含) 向下依次进入到 to
+ */
+static uint8_t walk_path(State* from, State* to, fsm_fn_t* out, uint16_t* exit_mask, uint16_t* entry_mask) {
+    State* lca = find_lca(from, to);
+    State* down[FSM_DEPTH];
+    uint8_t n = 0, depth = 0;
+    uint16_t exits = 0, entries = 0;
+
+    for(State* s = from; s && s != lca; s = s->_parent_) {
+        if(s->exit) out[n++] = s->exit;
+        if(is_indexed(s)) exits |= (uint16_t)(1u << s->_id_);
+    }
+    for(State* s = to; s && s != lca && depth < FSM_DEPTH; s = s->_parent_) {
+        down[depth++] = s;
+        if(is_indexed(s)) entries |= (uint16_t)(1u << s->_id_);
+    }
+    if(exit_mask) *exit_mask = exits;
+    if(entry_mask) *entry_mask = entries;
+    while(depth--) {
+        if(down[depth]->entry) out[n++] = down[depth]->entry;
+    }
+    return n;
+}
+
+/**
+ * @brief   处理事件 e 引起的状态转移
+ * @retval  bool - true:发生转移, false:无转移
+ */
+static bool transition(event_e e) {
+    State* state = cur_state;
+    uint8_t r = is_indexed(state) ? _next[state->_id_][e] : FSM_ROUTE_LEGACY;
+
+    if(r == FSM_ROUTE_NONE) return false;
+
+    if(r == FSM_ROUTE_LEGACY) {
+        // 兼容路径: 运行时逐级查找并遍历状态树
+        fsm_fn_t path[2 * FSM_DEPTH];
+        uint16_t exit_mask, entry_mask;
+        State* next = dispatch_event(state, e);
+        if(next == state) return false;
+        uint8_t n = walk_path(state, next, path, &exit_mask, &entry_mask);
+        for(uint8_t k = 0; k < n; ++k) path[k]();
+        cur_state = next;
+        update_timeouts(exit_mask, entry_mask);
+        return true;
+    }
+
+    // 预计算路径: 依次执行退出与进入动作
+    const fsm_route_t* route = &_routes[r];
+    const fsm_fn_t* fn = &_pool[route->off];
+    for(uint8_t k = 0; k < route->len; ++k) fn[k]();
+    cur_state = _states[route->dst];
+    if((route->exit_mask | route->entry_mask) & _timeout_mask) {
+        update_timeouts(route->exit_mask, route->entry_mask);
+    }
+    return true;
+}
+
+/**
+ * @brief   取消退出状态的停留超时, 启动进入状态的停留超时
+ * @param   exit_mask 退出的状态集合
+ * @param   entry_mask 进入的状态集合
+ */
+static void update_timeouts(uint16_t exit_mask, uint16_t entry_mask) {
+    uint16_t mask = exit_mask & _timeout_mask;
+    for(uint8_t i = 0; mask; ++i, mask >>= 1) {
+        if(mask & 1u) {
+            a_fsm_cancel_event(_state_timer[i]);
+            _state_timer[i] = -1;
+        }
+    }
+    mask = entry_mask & _timeout_mask;
+    for(uint8_t i = 0; mask; ++i, mask >>= 1) {
+        if(mask & 1u) {
+            evq_arg_t arg;
+            arg.u = i;
+            a_fsm_cancel_event(_state_timer[i]);
+            _state_timer[i] = a_fsm_schedule_event(_states[i]->timeout_event_, arg, _states[i]->timeout_ms_, 0);
+        }
+    }
+}
+
+/**
+ * @brief   句柄转换为定时事件
+ * @retval  定时事件, 句柄无效或已到期释放时为 0
+ */
+static fsm_timer_t* timer_from_handle(timer_handle_t handle) {
+    if(handle < 0) return 0;
+    for(uint8_t i = 0; i < FSM_TIMER_MAX; ++i) {
+        if(_timers[i].handle == handle) return &_timers[i];
+    }
+    return 0;
+}
+
+/**
+ * @brief   s_timer 到期回调: 投递事件, 单次定时器随即释放
+ * @param   arg 定时事件
+ */
+static void timer_fire(void* arg) {
+    fsm_timer_t* t = (fsm_timer_t*)arg;
+    a_fsm_post_event((event_e)t->event, t->arg, t->event == EVENT_ERROR ? EVQ_PRIO_HIGH : EVQ_PRIO_NORMAL);
+    if(t->period == 0) {
+        s_timer_delete(t->handle);
+        t->handle = -1;
+    }
+}
+
+/**
+ * @brief   FSM 事件分发函数 (兼容接口)
  * @retval  下一个状态
- * @note    根据当前状态和事件返回下一个状态, 寻找顺序为: 当前状态 -> 父状态 -> 祖父状态 -> ... -> 根状态
+ * @note    根据当前状态和事件返回下一个状态, 寻找顺序为: 当前状态 -> 父状态 -> 祖父状态 -> ... -> 根状态;
+ *          未提供 handle_event 的层级按转移表匹配
  */
 static State* dispatch_event(State* state, event_e e) {
     State* s = state;
@@ -150,6 +840,13 @@ static State* dispatch_event(State* state, event_e e) {
                 return next;
             }
         }
+        else {
+            for(uint8_t t = 0; t < FSM_TRANSITION_COUNT; ++t) {
+                if(_transitions[t].src == s && _transitions[t].event == e) {
+                    return _transitions[t].dst;
+                }
+            }
+        }
         s = s->_parent_;
     }
     // 没有状态处理该事件, 保持当前状态不变
@@ -174,7 +871,7 @@ static State* find_lca(State* s1, State* s2) {
 
     State* deeper = depth1 > depth2 ? s1 : s2;
     State* shallower = depth1 > depth2 ? s2 : s1;
-    int diff = (int)fabs((double)(depth1 - depth2));
+    int diff = depth1 > depth2 ? depth1 - depth2 : depth2 - depth1;
 
     while(diff--) { deeper = deeper->_parent_; }
     while(deeper != shallower) {
@@ -186,118 +883,290 @@ static State* find_lca(State* s1, State* s2) {
 }
 
 /**
- * @brief   依次执行从状态 from 到状态 to 的所有退出动作
- * @param   from 初始状态
- * @param   to 最终状态
+ * @brief   执行当前状态及其所有祖先状态的持续动作
  */
-static void exit_up_to(State* from, State* to) {
-    State* s = from;
-    while(s && s != to) {
-        if(s->exit) {
-            s->exit();
+static void execute_action(State* state) {
+    if(is_indexed(state)) {
+        const fsm_span_t* span = &_spans[state->_id_];
+        const fsm_fn_t* fn = &_pool[span->off];
+#if FSM_PROFILE
+        for(uint8_t k = 0; k < span->len; ++k) {
+            uint32_t start = dwt_get_cycles();
+            fn[k]();
+            prof_action(_pool_owner[span->off + k], dwt_get_cycles() - start);
+        }
+#else
+        for(uint8_t k = 0; k < span->len; ++k) fn[k]();
+#endif
+        return;
+    }
+
+    State* s = state;
+    while(s) {
+        if(s->action) {
+            s->action();
         }
         s = s->_parent_;
     }
 }
 
 /**
- * @brief   依次从状态 from 到状态 to 执行所有进入动作
- * @param   from 初始状态
- * @param   to 最终状态
+ * @brief   转移路径求解基准测试
+ * @note    对转移表中每个可达的 (状态, 事件) 分别用查表与树遍历求解路径, 只求解不执行动作
  */
-static void enter_down_to(State* from, State* to) {
-    State* path[FSM_DEPTH];
-    int depth = 0;
-    State* s = to;
+static void run_bench(void) {
+    const uint16_t rounds = 100;
+    volatile uintptr_t sink = 0;
+    uint32_t lookup_cyc = 0, walk_cyc = 0, pairs = 0;
+    fsm_fn_t path[2 * FSM_DEPTH];
 
-    // 找到从 to 到 from 的路径
-    while(s && s != from) {
-        path[depth++] = s;
-        s = s->_parent_;
-    }
+    for(uint8_t i = 0; i < FSM_STATE_COUNT; ++i) {
+        for(uint8_t e = 0; e < EVENT_MAX; ++e) {
+            uint8_t r = _next[i][e];
+            if(r >= _route_count) continue;
+            State* from = _states[i];
+            pairs++;
 
-    // 依次执行
-    while(depth--) {
-        s = path[depth];
-        if(s->entry) {
-            s->entry();
+            uint32_t start = dwt_get_cycles();
+            for(uint16_t n = 0; n < rounds; ++n) {
+                const fsm_route_t* route = &_routes[_next[from->_id_][e]];
+                for(uint8_t k = 0; k < route->len; ++k) sink += (uintptr_t)_pool[route->off + k];
+            }
+            lookup_cyc += dwt_get_cycles() - start;
+
+            start = dwt_get_cycles();
+            for(uint16_t n = 0; n < rounds; ++n) {
+                State* next = dispatch_event(from, (event_e)e);
+                uint8_t len = walk_path(from, next, path, 0, 0);
+                for(uint8_t k = 0; k < len; ++k) sink += (uintptr_t)path[k];
+            }
+            walk_cyc += dwt_get_cycles() - start;
         }
     }
+    (void)sink;
+
+    uint32_t div = pairs ? pairs * rounds : 1;
+    printf("$FSM_BENCH:%lu,%lu,%lu,%lu,%lu,%lu#",
+        (unsigned long)pairs, (unsigned long)(lookup_cyc / div), (unsigned long)(walk_cyc / div),
+        (unsigned long)_trans_count, (unsigned long)_trans_last_cyc, (unsigned long)_trans_max_cyc);
 }
 
 /**
- * @brief   执行当前状态及其所有祖先状态的持续动作
+ * @brief   $PICK:<接近高度 mm>,<夹取角度 rad>,<抬升高度 mm># : 空闲时启动一次完整抓取流程
+ * @note    结束时回复 $PICK:DONE,<接近>,<夹取>,<抬升>,<释放>,<总计>#  (各阶段耗时 ms); 非空闲时回复 $PICK:BUSY#;
+ *          带序号时流程结束后另回复 $DONE:<seq>,<状态>#
+ * @note    cur_state 只在 a_fsm_process 中改变, 同一轮命令处理中的多条 $PICK 均看到空闲状态:
+ *          以 _pick_requested 拒绝已受理但尚未启动期间的 $PICK, 避免覆盖前一条的参数
  */
-static void execute_action(State* state) {
-    State* s = state;
-    while(s) {
-        if(s->action) {
-            s->action();
-        }
-        s = s->_parent_;
+static comms_status_e cmd_pick(const comms_args_t* args) {
+    evq_arg_t arg;
+    arg.u = 0;
+
+    if(cur_state != &state_idle || _pick_requested) {
+        printf("$PICK:BUSY#");
+        return COMMS_ERR_BUSY;
+    }
+    _pick_approach_mm = args->v[0].f;
+    _pick_grasp_rad = args->v[1].f;
+    _pick_retract_mm = args->v[2].f;
+    if(!a_fsm_post_event(EVENT_PICK_START, arg, EVQ_PRIO_NORMAL)) {
+        printf("$PICK:BUSY#");
+        return COMMS_ERR_BUSY;
     }
+    _pick_requested = true;
+    return COMMS_OK;
 }
 
 /**
- * @brief   正常状态事件处理函数
- * @param   e 事件
- * @retval  下一个状态
+ * @brief   $PICK_ABORT# : 中止抓取流程, 回复 $PICK:ABORT#
  */
-static State* normal_handle_event(event_e e) {
-    switch(e) {
-        case EVENT_ERROR:
-            return &state_error;
-        default:
-            return 0;
-    }
+static comms_status_e cmd_pick_abort(const comms_args_t* args) {
+    (void)args;
+    _pick_requested = false;
+    a_fsm_trigger_event(EVENT_PICK_ABORT);
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TASKS# : 输出调度器任务统计 (格式见 s_sched_report)
+ */
+static comms_status_e cmd_tasks(const comms_args_t* args) {
+    (void)args;
+    s_sched_report();
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TASKS_CLR# : 清零调度器任务统计
+ */
+static comms_status_e cmd_tasks_clr(const comms_args_t* args) {
+    (void)args;
+    s_sched_reset_stats();
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $CPU# : 回复 $CPU:<负载 %>,<运行 ms>,<休眠 ms>#  (自上次查询以来)
+ */
+static comms_status_e cmd_cpu(const comms_args_t* args) {
+    (void)args;
+    a_board_cpu_report();
+    return COMMS_OK;
 }
 
 /**
- * @brief   正常状态持续动作函数
+ * @brief   $FSM_BENCH# : 回复 $FSM_BENCH:<路径数>,<查表周期>,<树遍历周期>,<转移次数>,<最近转移周期>,<最大转移周期>#
+ * @note    查表/树遍历为每条转移路径求解的平均周期数 (不含动作本身)
  */
-static void normal_action(void) {
-    s_wireless_comms_process();
+static comms_status_e cmd_fsm_bench(const comms_args_t* args) {
+    (void)args;
+    run_bench();
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $FSM_STATS# : 每个状态回复 $FSM_STAT:<名称>,<进入次数>,<累计停留 ms>,<动作次数>,<动作最小/平均/最大周期>#
+ *          (动作含持续动作 action 与控制周期动作 control),
+ *          最后回复 $FSM_LOOP:<a_fsm_process 最大周期>,<主循环周期直方图 FSM_PROF_HIST_BINS 个桶>#
+ */
+static comms_status_e cmd_fsm_stats(const comms_args_t* args) {
+    (void)args;
+#if FSM_PROFILE
+    prof_report();
+#else
+    printf("$FSM_STATS:OFF#");
+#endif
+    return COMMS_OK;
+}
 
-    if(tick.flag) {
-        tick.flag = 0;
-        lift_encoder.update(&lift_encoder);
+/**
+ * @brief   $FSM_STATS_CLR# : 清零计时统计
+ */
+static comms_status_e cmd_fsm_stats_clr(const comms_args_t* args) {
+    (void)args;
+#if FSM_PROFILE
+    prof_reset();
+#endif
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $FSM_STATES# : 每个状态回复 $FSM_STATE:<ID>,<名称>#  (遥测帧中的 state_id 据此解析)
+ */
+static comms_status_e cmd_fsm_states(const comms_args_t* args) {
+    (void)args;
+    for(uint8_t i = 0; i < FSM_STATE_COUNT; ++i) {
+        printf("$FSM_STATE:%u,%s#", i, _states[i]->name_);
     }
+    return COMMS_OK;
 }
 
+#if FSM_PROFILE
 /**
- * @brief   空闲状态事件处理函数
- * @param   e 事件
- * @retval  下一个状态
+ * @brief   清零计时统计
+ * @note    各状态 ID 必须已由 build_tables 分配
  */
-static State* idle_handle_event(event_e e) {
-    switch(e) {
-        case EVENT_LIFT_MOVE:
-            return &state_lift_moving;
-        default:
-            return 0;
+static void prof_reset(void) {
+    for(uint8_t i = 0; i < FSM_MAX_STATES; ++i) {
+        _prof[i].entries = 0;
+        _prof[i].time_ms = 0;
+        _prof[i].action_n = 0;
+        _prof[i].action_min = 0;
+        _prof[i].action_max = 0;
+        _prof[i].action_sum = 0;
     }
+    for(uint8_t i = 0; i < FSM_PROF_HIST_BINS; ++i) _loop_hist[i] = 0;
+    _process_max_cyc = 0;
+    _loop_prev_cyc = 0;
+    _state_enter_ms = _get_ms();
 }
 
 /**
- * @brief   空闲状态持续动作函数
+ * @brief   记录主循环周期 (相邻两次 a_fsm_process 的间隔)
+ * @param   now 本次进入 a_fsm_process 时的周期计数
  */
-static void idle_action(void) {
-    if(fabsf(lift_target_pos_mm - lift_encoder.get_position(&lift_encoder)) > 5.0f) {
-        a_fsm_trigger_event(EVENT_LIFT_MOVE);
+static void prof_loop(uint32_t now) {
+    if(_loop_prev_cyc) {
+        uint32_t us = (now - _loop_prev_cyc) / CPU_FREQ_MHZ;
+        uint8_t bin = 0;
+        while(us && bin < FSM_PROF_HIST_BINS - 1) {
+            us >>= 1;
+            bin++;
+        }
+        _loop_hist[bin]++;
     }
+    _loop_prev_cyc = now;
 }
 
 /**
- * @brief   升降台移动状态事件处理函数
- * @param   e 事件
- * @retval  下一个状态
+ * @brief   记录状态转移: 结算离开状态的停留时间, 累加进入状态的进入次数
+ */
+static void prof_transition(const State* from, const State* to) {
+    ms_t now = _get_ms();
+    if(is_indexed(from)) _prof[from->_id_].time_ms += now - _state_enter_ms;
+    if(is_indexed(to)) _prof[to->_id_].entries++;
+    _state_enter_ms = now;
+}
+
+/**
+ * @brief   累计一次动作耗时 (持续动作或控制周期动作)
+ * @param   id 动作所属的状态 ID
+ * @param   cyc 耗时 (周期)
+ */
+static void prof_action(uint8_t id, uint32_t cyc) {
+    fsm_prof_t* p = &_prof[id];
+    if(p->action_n == 0 || cyc < p->action_min) p->action_min = cyc;
+    if(cyc > p->action_max) p->action_max = cyc;
+    p->action_sum += cyc;
+    p->action_n++;
+}
+
+/**
+ * @brief   输出计时统计
  */
-static State* lift_moving_handle_event(event_e e) {
-    switch(e) {
-        case EVENT_LIFT_STOP:
-            return &state_idle;
-        default:
-            return 0;
+static void prof_report(void) {
+    ms_t now = _get_ms();
+    for(uint8_t i = 0; i < FSM_STATE_COUNT; ++i) {
+        const fsm_prof_t* p = &_prof[i];
+        uint32_t time_ms = p->time_ms;
+        if(_states[i] == cur_state) time_ms += now - _state_enter_ms;
+        uint32_t avg = p->action_n ? (uint32_t)(p->action_sum / p->action_n) : 0;
+        printf("$FSM_STAT:%s,%lu,%lu,%lu,%lu,%lu,%lu#",
+            _states[i]->name_, (unsigned long)p->entries, (unsigned long)time_ms,
+            (unsigned long)p->action_n, (unsigned long)p->action_min,
+            (unsigned long)avg, (unsigned long)p->action_max);
+    }
+    printf("$FSM_LOOP:%lu", (unsigned long)_process_max_cyc);
+    for(uint8_t i = 0; i < FSM_PROF_HIST_BINS; ++i) {
+        printf(",%lu", (unsigned long)_loop_hist[i]);
+    }
+    printf("#");
+}
+#endif
+
+/**
+ * @brief   空闲状态进入动作函数
+ */
+static void idle_entry(void) {
+    _lift_dirty = true;
+}
+
+/**
+ * @brief   空闲状态持续动作函数
+ * @note    仅在目标位置或编码器位置变化后检查一次
+ */
+static void idle_action(void) {
+    if(!_lift_dirty) return;
+    _lift_dirty = false;
+
+    if(fabsf(lift_target_pos_mm - lift_encoder.get_position(&lift_encoder)) > lift_pid.dead_band_) {
+        evq_arg_t arg;
+        arg.f = lift_target_pos_mm;
+        a_fsm_post_event(EVENT_LIFT_MOVE, arg, EVQ_PRIO_NORMAL);
+    }
+    else {
+        // 已在目标位置 (或移动结束回到空闲)
+        s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_OK);
     }
 }
 
@@ -305,6 +1174,7 @@ static State* lift_moving_handle_event(event_e e) {
  * @brief   升降台移动状态进入动作函数
  */
 static void lift_moving_entry(void) {
+    lift_drive_begin(lift_target_pos_mm);
     printf("$LIFT:START#");
 }
 
@@ -312,40 +1182,197 @@ static void lift_moving_entry(void) {
  * @brief   升降台移动状态退出动作函数
  */
 static void lift_moving_exit(void) {
+    lift_drive_end();
     printf("$LIFT:END#");
+    // 正常到位由回到空闲后的检查通知; 超时或堵转进入错误状态
+    if(cur_event == EVENT_ERROR) s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_ERR_FAULT);
+}
+
+/**
+ * @brief   升降台移动状态控制周期动作函数
+ */
+static void lift_moving_control(void) {
+    if(lift_drive_step(lift_target_pos_mm)) {
+        a_fsm_trigger_event(EVENT_LIFT_STOP);
+    }
+}
+
+/**
+ * @brief   抓取流程进入动作函数
+ */
+static void pick_entry(void) {
+    for(uint8_t i = 0; i < PICK_PHASES; ++i) _pick_phase_ms[i] = 0;
+    _pick_done = false;
+    // 抓取流程接管升降台与夹爪, 之前未完成的 $LIFT_SET / $GRIP_* 视为被取代
+    s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_ERR_ABORTED);
+    s_wireless_comms_complete(COMMS_DONE_GRIP, COMMS_ERR_ABORTED);
+    printf("$PICK:START#");
+}
+
+/**
+ * @brief   抓取流程退出动作函数
+ * @note    正常完成时报告各阶段耗时, 否则 (中止或出错) 报告中止
+ */
+static void pick_exit(void) {
+    a_fsm_cancel_event(_pick_settle_timer);
+    _pick_settle_timer = -1;
+    lift_relay.stop(&lift_relay);
+    // 流程目标不写入 lift_target_pos_mm; 回到空闲时以当前位置为目标, 避免驱动回流程开始前的目标
+    lift_target_pos_mm = lift_encoder.get_position(&lift_encoder);
+
+    s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_ERR_ABORTED);
+    if(!_pick_done) {
+        printf("$PICK:ABORT#");
+        s_wireless_comms_complete(COMMS_DONE_PICK, cur_event == EVENT_ERROR ? COMMS_ERR_FAULT : COMMS_ERR_ABORTED);
+        return;
+    }
+    uint32_t total = 0;
+    for(uint8_t i = 0; i < PICK_PHASES; ++i) total += _pick_phase_ms[i];
+    printf("$PICK:DONE,%lu,%lu,%lu,%lu,%lu#",
+        (unsigned long)_pick_phase_ms[PICK_APPROACH], (unsigned long)_pick_phase_ms[PICK_GRASP],
+        (unsigned long)_pick_phase_ms[PICK_RETRACT], (unsigned long)_pick_phase_ms[PICK_RELEASE],
+        (unsigned long)total);
+    s_wireless_comms_complete(COMMS_DONE_PICK, COMMS_OK);
+}
+
+/**
+ * @brief   抓取-接近状态进入动作函数
+ */
+static void pick_approach_entry(void) {
+    _pick_requested = false;
+    pick_phase_begin(PICK_APPROACH);
+    gripper.open(&gripper);
+    _pick_target_mm = _pick_approach_mm;
+    lift_drive_begin(_pick_target_mm);
+}
+
+/**
+ * @brief   抓取-接近/抬升状态退出动作函数
+ */
+static void pick_approach_exit(void) {
+    lift_drive_end();
+    pick_phase_end();
+}
+
+/**
+ * @brief   抓取-接近/抬升状态控制周期动作函数
+ * @note    升降台进入死区且速度归零后进入下一阶段
+ */
+static void pick_lift_control(void) {
+    if(lift_drive_step(_pick_target_mm) && fabsf(lift_encoder.get_speed(&lift_encoder)) < LIFT_SETTLED_SPEED) {
+        a_fsm_trigger_event(EVENT_PICK_NEXT);
+    }
+}
+
+/**
+ * @brief   抓取-夹取状态进入动作函数
+ * @note    夹爪无位置反馈, 按本次角度变化量估算的到位时间投递下一阶段事件
+ */
+static void pick_grasp_entry(void) {
+    evq_arg_t arg;
+    arg.u = 0;
+    pick_phase_begin(PICK_GRASP);
+    gripper.set_angle(&gripper, _pick_grasp_rad);
+    _pick_settle_timer = a_fsm_schedule_event(EVENT_PICK_NEXT, arg, gripper.get_move_time_ms(&gripper), 0);
+}
+
+/**
+ * @brief   抓取-抬升状态进入动作函数
+ */
+static void pick_retract_entry(void) {
+    pick_phase_begin(PICK_RETRACT);
+    _pick_target_mm = _pick_retract_mm;
+    lift_drive_begin(_pick_target_mm);
+}
+
+/**
+ * @brief   抓取-释放状态进入动作函数
+ */
+static void pick_release_entry(void) {
+    evq_arg_t arg;
+    arg.u = 0;
+    pick_phase_begin(PICK_RELEASE);
+    gripper.open(&gripper);
+    _pick_settle_timer = a_fsm_schedule_event(EVENT_PICK_NEXT, arg, gripper.get_move_time_ms(&gripper), 0);
 }
 
 /**
- * @brief   升降台移动状态动作函数
+ * @brief   抓取-释放状态退出动作函数
  */
-static void lift_moving_action(void) {
-    float target = lift_target_pos_mm;
+static void pick_release_exit(void) {
+    pick_phase_end();
+    _pick_done = true;
+}
+
+/**
+ * @brief   开始驱动升降台到目标位置
+ * @param   target 目标位置 (mm), 之后每个控制周期由 lift_drive_step 传入
+ */
+static void lift_drive_begin(float target) {
+    evq_arg_t arg;
+    arg.u = 0;
+    lift_pid.reset(&lift_pid);
+    _lift_stall_pos = lift_encoder.get_position(&lift_encoder);
+    _lift_stall_timer = a_fsm_schedule_event(EVENT_ERROR, arg, LIFT_STALL_TIMEOUT_MS, 0);
+    s_log_debug("lift drive %.2f -> %.2f mm", _lift_stall_pos, target);
+}
+
+/**
+ * @brief   升降台单个控制周期: PID 计算, 继电器输出与堵转检测
+ * @param   target 目标位置 (mm): 移动状态为 lift_target_pos_mm (可被 $LIFT_SET 随时修改), 抓取流程为阶段目标
+ * @retval  bool - true:已进入死区 (继电器已停止), false:仍在移动
+ */
+static bool lift_drive_step(float target) {
     float current = lift_encoder.get_position(&lift_encoder);
+    float out = lift_pid.calculate(&lift_pid, target, current, TICK_PERIOD_MS / 1000.0f);
+    s_log_debug("lift tgt %.2f pos %.2f out %.3f", target, current, out);
+
+    // 有效位移时重新计时堵转检测
+    if(fabsf(current - _lift_stall_pos) >= LIFT_STALL_MIN_MM) {
+        _lift_stall_pos = current;
+        a_fsm_restart_event(_lift_stall_timer, LIFT_STALL_TIMEOUT_MS);
+        s_log_debug("lift stall timer rearmed at %.2f mm", current);
+    }
 
-    if(target - current > 5.0f) {
+    if(out > 0.0f) {
         lift_relay.set_dir(&lift_relay, RelayDirA);
     }
-    else if(target - current < -5.0f) {
+    else if(out < 0.0f) {
         lift_relay.set_dir(&lift_relay, RelayDirB);
     }
     else {
         lift_relay.stop(&lift_relay);
-        a_fsm_trigger_event(EVENT_LIFT_STOP);
+        // 停在死区内不属于堵转, 保持堵转计时不触发
+        a_fsm_restart_event(_lift_stall_timer, LIFT_STALL_TIMEOUT_MS);
+        return true;
     }
+    return false;
 }
 
 /**
- * @brief   错误状态事件处理函数
- * @param   e 事件
- * @retval  下一个状态
+ * @brief   结束驱动升降台
  */
-static State* error_handle_event(event_e e) {
-    switch(e) {
-        case EVENT_OK:
-            return &state_idle;
-        default:
-            return 0;
-    }
+static void lift_drive_end(void) {
+    a_fsm_cancel_event(_lift_stall_timer);
+    _lift_stall_timer = -1;
+    lift_relay.stop(&lift_relay);
+}
+
+/**
+ * @brief   记录抓取阶段开始
+ */
+static void pick_phase_begin(uint8_t phase) {
+    _pick_phase = phase;
+    _pick_phase_start = _get_ms();
+}
+
+/**
+ * @brief   结算当前抓取阶段耗时
+ */
+static void pick_phase_end(void) {
+    a_fsm_cancel_event(_pick_settle_timer);
+    _pick_settle_timer = -1;
+    _pick_phase_ms[_pick_phase] = _get_ms() - _pick_phase_start;
 }
 
 /**
@@ -353,6 +1380,12 @@ static State* error_handle_event(event_e e) {
  */
 static void error_entry(void) {
     lift_relay.stop(&lift_relay);
+    s_trace_fault(TRACE_FAULT_FSM, (uint16_t)cur_event, cur_event_arg.u);
+    // 急停在中断中锁定的继电器保持锁定, 直到 $ESTOP_RESET# 显式解除
+    // 放弃当前目标与排队中的定时命令, 避免恢复后立即重新驱动
+    lift_target_pos_mm = lift_encoder.get_position(&lift_encoder);
+    s_wireless_comms_abort_timed();
+    printf("$FSM:ERROR#");
     gripper.open(&gripper);
     a_fsm_trigger_event(EVENT_OK);
 }
@@ -8,7 +8,13 @@
  * ├──  NormalState (state_normal)
  * |    |
  * |    ├── IdleState (state_idle)
- * |    └── LiftMovingState (state_lift_moving)
+ * |    ├── LiftMovingState (state_lift_moving)
+ * |    └── PickState (state_pick)
+ * |         |
+ * |         ├── PickApproachState (state_pick_approach)
+ * |         ├── PickGraspState (state_pick_grasp)
+ * |         ├── PickRetractState (state_pick_retract)
+ * |         └── PickReleaseState (state_pick_release)
  * |
  * └──  ErrorState (state_error)
  */
@@ -16,10 +22,32 @@
 #ifndef _a_fsm_h_
 #define _a_fsm_h_
 
+#include "s_event_queue.h"
+#include "s_timer.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
 // ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
 
 // 状态机深度
 #define FSM_DEPTH 5
+// 状态表最大状态数
+#define FSM_MAX_STATES 12
+// 预计算转移路径的最大条数 / 动作池容量
+#define FSM_MAX_ROUTES 32
+#define FSM_ACTION_POOL 96
+// 单次 a_fsm_process 最多处理的事件数
+#define FSM_EVENT_BUDGET 4
+
+// 状态计时统计 (DWT), 置 0 时相关代码全部编译移除
+#ifndef FSM_PROFILE
+#define FSM_PROFILE 1
+#endif
+// 同时存在的定时事件数 (每个占用一个 s_timer 定时器)
+#define FSM_TIMER_MAX 16
+// 主循环周期直方图桶数: 桶 0 为 <1 us, 桶 k 为 [2^(k-1), 2^k) us, 最后一桶含更长周期
+#define FSM_PROF_HIST_BINS 16
 
 /**
  * @brief   事件枚举
@@ -30,11 +58,17 @@ typedef enum {
     EVENT_ERROR,
     EVENT_LIFT_MOVE,
     EVENT_LIFT_STOP,
+    EVENT_PICK_START,   // 启动抓取流程 (参数由 $PICK 命令设置)
+    EVENT_PICK_NEXT,    // 当前抓取阶段完成
+    EVENT_PICK_ABORT,   // 中止抓取流程
     EVENT_MAX
 } event_e;
 
 /**
  * @brief   状态结构体
+ * @note    handle_event 为兼容接口: 状态表中的状态推荐将其置 0 并使用转移表描述转移,
+ *          置 0 时转移与退出/进入动作序列在 a_fsm_init 中一次性预计算;
+ *          仍提供 handle_event 的状态按原有方式逐级向上查找
  */
 typedef struct State State;
 struct State {
@@ -50,6 +84,10 @@ struct State {
      * @brief   状态持续动作函数
      */
     void(*action)(void);
+    /**
+     * @brief   控制周期动作函数 (由 a_fsm_control 按控制周期调用, 先子状态后父状态)
+     */
+    void(*control)(void);
     /**
      * @brief   状态进入动作函数
      */
@@ -59,12 +97,27 @@ struct State {
      */
     void(*exit)(void);
 
+    uint32_t timeout_ms_;       // 停留超时 (ms), 0 表示不限; 进入时启动, 退出时取消
+    event_e timeout_event_;     // 超时后投递的事件
+
 // private:
     State* _parent_;
+    uint8_t _id_;       // 在状态表中的下标 (a_fsm_init 填充)
+    uint8_t _depth_;    // 深度, 根状态为 1 (a_fsm_init 填充)
 };
 
-// 当前状态和事件
+/**
+ * @brief   转移表项: 状态 src (或其未处理该事件的子状态) 收到事件 event 时转移到 dst
+ */
+typedef struct {
+    State* src;
+    event_e event;
+    State* dst;
+} fsm_transition_t;
+
+// 当前状态和正在处理的事件 (及其负载)
 extern event_e cur_event;
+extern evq_arg_t cur_event_arg;
 extern State* cur_state;
 
 /**
@@ -73,15 +126,33 @@ extern State* cur_state;
  *  - 正常状态
  *      - 空闲状态
  *      - 升降台移动状态
+ *      - 抓取流程状态
+ *          - 接近 / 夹取 / 抬升 / 释放
  *  - 错误状态
  */
 extern State state_normal;
 extern State state_idle, state_lift_moving;
+extern State state_pick;
+extern State state_pick_approach, state_pick_grasp, state_pick_retract, state_pick_release;
 extern State state_error;
 
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
 
+void a_fsm_init(void);
 void a_fsm_process(void);
+void a_fsm_control(void);
 void a_fsm_trigger_event(event_e e);
+bool a_fsm_post_event(event_e e, evq_arg_t arg, evq_prio_e prio);
+uint32_t a_fsm_event_overflow(evq_prio_e prio);
+void a_fsm_register_cmds(void);
+void a_fsm_set_clock(uint32_t(*get_ms)(void));
+timer_handle_t a_fsm_schedule_event(event_e e, evq_arg_t arg, uint32_t delay_ms, uint32_t period_ms);
+bool a_fsm_restart_event(timer_handle_t handle, uint32_t delay_ms);
+void a_fsm_cancel_event(timer_handle_t handle);
+bool a_fsm_has_pending(void);
+void a_fsm_notify_lift_target(float target);
+bool a_fsm_motion_busy(void);
+float a_fsm_lift_target(void);
+uint8_t a_fsm_state_id(void);
 
 #endif
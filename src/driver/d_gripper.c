@@ -11,6 +11,8 @@
 #define GRIPPER_OPEN_ANGLE      3.14f
 #define GRIPPER_CLOSE_ANGLE     -1.93f
 #define GRIPPER_MOVE_TIME_S     0.5f
+// 到位估算的附加裕量 (ms), 覆盖 CAN 传输与电机加减速
+#define GRIPPER_SETTLE_MARGIN_MS 50
 
 // ! ========================= 私 有 函 数 声 明 ========================= ! //
 
@@ -20,6 +22,8 @@ static void _disable(Gripper* self);
 static void _open(Gripper* self);
 static void _close(Gripper* self);
 static void _set_angle(Gripper* self, float angle);
+static float _get_angle(const Gripper* self);
+static uint32_t _get_move_time_ms(const Gripper* self);
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
@@ -31,12 +35,17 @@ static void _set_angle(Gripper* self, float angle);
 Gripper gripper_create(void) {
     Gripper obj;
     obj._can_ = 0;
+    obj._angle_ = 0.0f;
+    obj._angle_valid_ = 0;
+    obj._move_ms_ = 0;
     obj.init = _init;
     obj.enable = _enable;
     obj.disable = _disable;
     obj.open = _open;
     obj.close = _close;
     obj.set_angle = _set_angle;
+    obj.get_angle = _get_angle;
+    obj.get_move_time_ms = _get_move_time_ms;
 
     return obj;
 }
@@ -114,6 +123,13 @@ static void _set_angle(Gripper* self, float angle) {
     angle = (angle < GRIPPER_CLOSE_ANGLE) ? GRIPPER_CLOSE_ANGLE : ((angle > GRIPPER_OPEN_ANGLE) ? GRIPPER_OPEN_ANGLE : angle);
     float speed = (GRIPPER_MOVE_TIME_S > 0) ? (GRIPPER_OPEN_ANGLE - GRIPPER_CLOSE_ANGLE) / GRIPPER_MOVE_TIME_S : 10.0f;
     uint8_t* angle_bytes = (uint8_t*)&angle;
+
+    // 估算到位时间: 初始角度未知时按全行程计算
+    float delta = self->_angle_valid_ ? (angle - self->_angle_) : (GRIPPER_OPEN_ANGLE - GRIPPER_CLOSE_ANGLE);
+    if(delta < 0.0f) delta = -delta;
+    self->_move_ms_ = (uint32_t)(delta / speed * 1000.0f) + GRIPPER_SETTLE_MARGIN_MS;
+    self->_angle_ = angle;
+    self->_angle_valid_ = 1;
     uint8_t* speed_bytes = (uint8_t*)&speed;
 
     data[0] = *(angle_bytes);
@@ -127,3 +143,21 @@ static void _set_angle(Gripper* self, float angle) {
 
     can_send(self->_can_, self->_motor_id_, data, 8);
 }
+
+/**
+ * @brief   获取最近一次指令角度
+ * @param   self 夹爪对象
+ * @retval  float 角度 (rad)
+ */
+static float _get_angle(const Gripper* self) {
+    return self->_angle_;
+}
+
+/**
+ * @brief   获取最近一次指令的预计到位时间
+ * @param   self 夹爪对象
+ * @retval  uint32_t 耗时 (ms)
+ */
+static uint32_t _get_move_time_ms(const Gripper* self) {
+    return self->_move_ms_;
+}
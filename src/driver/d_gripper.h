@@ -53,10 +53,25 @@ struct Gripper {
      * @retval  None
      */
     void(*set_angle)(Gripper* self, float angle);
+    /**
+     * @brief   获取最近一次指令角度
+     * @param   self 夹爪对象
+     * @retval  float 角度 (rad)
+     */
+    float(*get_angle)(const Gripper* self);
+    /**
+     * @brief   获取最近一次指令的预计到位时间
+     * @param   self 夹爪对象
+     * @retval  uint32_t 由角度变化量与运动速度估算的耗时 (ms)
+     */
+    uint32_t(*get_move_time_ms)(const Gripper* self);
 
 // private:
     can_t* _can_;
     uint16_t _motor_id_;
+    float _angle_;
+    uint8_t _angle_valid_;
+    uint32_t _move_ms_;
 };
 
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
@@ -3,6 +3,7 @@
  * @brief   继电器驱动实现
  */
 #include "d_relay.h"
+#include "s_trace.h"
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
@@ -13,6 +14,9 @@
 static void _init(Relay* self, const relay_cfg_t* cfg);
 static void _set_dir(Relay* self, RelayDir_e dir);
 static void _stop(Relay* self);
+static RelayDir_e _get_dir(const Relay* self);
+static void _halt(Relay* self);
+static void _release(Relay* self);
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
@@ -26,6 +30,12 @@ Relay relay_create(void) {
     obj.init = _init;
     obj.set_dir = _set_dir;
     obj.stop = _stop;
+    obj.get_dir = _get_dir;
+    obj.halt = _halt;
+    obj.release = _release;
+    obj._cfg_ = 0;
+    obj._dir_ = RelayDirStop;
+    obj._halted_ = 0;
     return obj;
 }
 
@@ -59,6 +69,8 @@ static void _init(Relay* self, const relay_cfg_t* cfg) {
     GPIO_ResetBits(cfg->port, cfg->pin_b);
 
     self->_cfg_ = cfg;
+    self->_dir_ = RelayDirStop;
+    self->_halted_ = 0;
 }
 
 /**
@@ -81,8 +93,16 @@ static void _set_dir(Relay* self, RelayDir_e dir) {
         default:
             GPIO_ResetBits(self->_cfg_->port, self->_cfg_->pin_a);
             GPIO_ResetBits(self->_cfg_->port, self->_cfg_->pin_b);
+            dir = RelayDirStop;
             break;
     }
+    // 写引脚后再检查锁定: 急停中断无论发生在检查之前还是之后, 继电器最终都处于断开状态
+    if(self->_halted_) {
+        GPIO_ResetBits(self->_cfg_->port, self->_cfg_->pin_a | self->_cfg_->pin_b);
+        dir = RelayDirStop;
+    }
+    if(dir != self->_dir_) s_trace_record(TRACE_EV_RELAY, (uint8_t)dir, 0, 0);
+    self->_dir_ = dir;
 }
 
 /**
@@ -93,4 +113,36 @@ static void _set_dir(Relay* self, RelayDir_e dir) {
 static void _stop(Relay* self) {
     GPIO_ResetBits(self->_cfg_->port, self->_cfg_->pin_a);
     GPIO_ResetBits(self->_cfg_->port, self->_cfg_->pin_b);
+    if(self->_dir_ != RelayDirStop) s_trace_record(TRACE_EV_RELAY, RelayDirStop, 0, 0);
+    self->_dir_ = RelayDirStop;
+}
+
+/**
+ * @brief   获取当前方向
+ * @param   self 电机对象
+ * @retval  RelayDir_e 最近一次设置的方向
+ */
+static RelayDir_e _get_dir(const Relay* self) {
+    return self->_dir_;
+}
+
+/**
+ * @brief   急停: 立即断开并锁定
+ * @param   self 电机对象
+ * @retval  None
+ */
+static void _halt(Relay* self) {
+    self->_halted_ = 1;
+    GPIO_ResetBits(self->_cfg_->port, self->_cfg_->pin_a | self->_cfg_->pin_b);
+    s_trace_record(TRACE_EV_RELAY, RelayDirStop, 1, 0);
+    self->_dir_ = RelayDirStop;
+}
+
+/**
+ * @brief   解除急停锁定
+ * @param   self 电机对象
+ * @retval  None
+ */
+static void _release(Relay* self) {
+    self->_halted_ = 0;
 }
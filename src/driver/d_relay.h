@@ -45,9 +45,30 @@ struct Relay {
      * @retval  None
      */
     void (*stop)(Relay* self);
+    /**
+     * @brief   获取当前方向
+     * @param   self 电机对象
+     * @retval  RelayDir_e 最近一次设置的方向
+     */
+    RelayDir_e (*get_dir)(const Relay* self);
+    /**
+     * @brief   急停: 立即断开并锁定, 锁定期间 set_dir 只能停止
+     * @param   self 电机对象
+     * @retval  None
+     * @note    可在中断中调用 (只写 GPIO 的 BRR 寄存器与锁定标志)
+     */
+    void (*halt)(Relay* self);
+    /**
+     * @brief   解除急停锁定 (不恢复运行)
+     * @param   self 电机对象
+     * @retval  None
+     */
+    void (*release)(Relay* self);
 
 // private:
     const relay_cfg_t* _cfg_;
+    RelayDir_e _dir_;
+    volatile uint8_t _halted_;
 };
 
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
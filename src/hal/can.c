@@ -7,6 +7,8 @@
 #include "can.h"
 
 #include "s_delay.h"
+#include "s_prof.h"
+#include "s_trace.h"
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
@@ -43,7 +45,7 @@ static const uint8_t _mode_map[] = {
 
 // ! ========================= 私 有 函 数 声 明 ========================= ! //
 
-
+static uint32_t _data32(const uint8_t* data, uint8_t len);
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
@@ -122,6 +124,7 @@ void can_init(can_t* handle, const can_cfg_t* cfg) {
 bool can_send(can_t* handle, uint16_t std_id, const uint8_t* data, uint8_t len) {
     if(len > 8) return false;
     const can_hw_t* hw = &_hw[handle->cfg->id];
+    PROF_BEGIN(CAN_SEND);
 
     CanTxMsg tx;
     tx.StdId = std_id & 0x7FF;
@@ -132,15 +135,25 @@ bool can_send(can_t* handle, uint16_t std_id, const uint8_t* data, uint8_t len)
     for(uint8_t i = 0; i < len; ++i)
         tx.Data[i] = data[i];
 
+    s_trace_record(TRACE_EV_CAN_TX, len, (uint16_t)tx.StdId, _data32(tx.Data, len));
     uint8_t mbox = CAN_Transmit(hw->periph, &tx);
-    if(mbox == CAN_TxStatus_NoMailBox) return false;
+    if(mbox == CAN_TxStatus_NoMailBox) {
+        s_trace_fault(TRACE_FAULT_CAN_TX, (uint16_t)tx.StdId, 0);
+        PROF_END(CAN_SEND);
+        return false;
+    }
 
-    ms_t start = 0;
+    nb_delay_t wait = NB_DELAY_INIT;
     while(CAN_TransmitStatus(hw->periph, mbox) != CAN_TxStatus_Ok) {
-        if(s_nb_delay_ms(&start, 50)) return false;
+        if(s_nb_delay_ms(&wait, 50)) {
+            s_trace_fault(TRACE_FAULT_CAN_TX, (uint16_t)tx.StdId, 1);
+            PROF_END(CAN_SEND);
+            return false;
+        }
     }
 
     s_delay_ms(1);
+    PROF_END(CAN_SEND);
     return true;
 }
 
@@ -155,6 +168,15 @@ void can_set_rx_cb(can_t* handle, can_rx_cb_t cb) {
 
 // ! ========================= 私 有 函 数 实 现 ========================= ! //
 
+/**
+ * @brief   报文前 4 字节 (小端, 不足补 0), 用于跟踪记录
+ */
+static uint32_t _data32(const uint8_t* data, uint8_t len) {
+    uint32_t v = 0;
+    for(uint8_t i = 0; i < len && i < 4; ++i) v |= (uint32_t)data[i] << (8 * i);
+    return v;
+}
+
 /**
  * @brief   CAN1 RX0 中断服务函数
  * @note    由 USB_LP_CAN1_RX0_IRQHandler 调用
@@ -162,10 +184,13 @@ void can_set_rx_cb(can_t* handle, can_rx_cb_t cb) {
 void USB_LP_CAN1_RX0_IRQHandler(void) {
     can_t* handle = _handles[CAN_1];
     if(!handle) return;
+    PROF_BEGIN(ISR_CAN_RX);
     if(CAN_GetITStatus(CAN1, CAN_IT_FMP0) != RESET) {
         CanRxMsg rx;
         CAN_Receive(CAN1, CAN_FIFO0, &rx);
+        s_trace_record(TRACE_EV_CAN_RX, rx.DLC, (uint16_t)rx.StdId, _data32(rx.Data, rx.DLC));
         if(handle->rx_cb) handle->rx_cb(&rx);
         CAN_ClearITPendingBit(CAN1, CAN_IT_FMP0);
     }
+    PROF_END(ISR_CAN_RX);
 }
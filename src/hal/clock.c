@@ -0,0 +1,131 @@
+/**
+ * @file    clock.c
+ * @brief   64 位单调时基实现
+ */
+#include "clock.h"
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+/**
+ * @brief   时基副本: 已走过的整毫秒数与该毫秒起点的 DWT 周期计数
+ */
+typedef struct {
+    uint64_t ms;
+    uint32_t start;
+} clock_snap_t;
+
+static volatile clock_snap_t _snap[2];
+static volatile uint32_t _gen = 0;          // 当前副本为 _snap[_gen & 1]
+static volatile uint32_t _ms32 = 0;         // 整毫秒数低 32 位, 供单次读取
+static uint32_t _origin = 0;                // clock_init 时第 0 毫秒起点的周期计数
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static uint32_t _read(uint64_t* ms);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化时基: 以当前 SysTick 周期的起点为第 0 毫秒
+ * @note    需在 dwt_init 与 SysTick_Config 之后、开启 SysTick 中断前调用 (由 systick_init 调用)
+ */
+void clock_init(void) {
+    uint32_t elapsed = SysTick->LOAD - SysTick->VAL;
+    uint32_t now = dwt_get_cycles();
+
+    _origin = now - elapsed;
+    _snap[0].ms = 0;
+    _snap[0].start = _origin;
+    _gen = 0;
+    _ms32 = 0;
+}
+
+/**
+ * @brief   推进整毫秒数 (在 SysTick 中断中调用)
+ * @note    按 DWT 周期数推进而非按中断次数累加, 中断延迟不会累积为时间误差
+ * @note    SysTick 中断总在毫秒起点之后至少一个 SysTick 周期才执行, 此时 CYCCNT 未走满 1 ms 说明内核时钟
+ *          曾被门控 (WFI 休眠且未设置 DBGMCU_SLEEP): 改为计入一个 SysTick 周期, 并按 SysTick 当前周期内
+ *          已走过的计数重新对齐起点, 毫秒时基因此不依赖调试寄存器
+ */
+void clock_tick(void) {
+    const volatile clock_snap_t* cur = &_snap[_gen & 1];
+    volatile clock_snap_t* next = &_snap[(_gen + 1) & 1];
+    uint64_t ms = cur->ms;
+    uint32_t start = cur->start;
+    uint32_t now = dwt_get_cycles();
+
+    if(now - start < CLOCK_CYC_PER_MS) {
+        ms++;
+        start = now - (SysTick->LOAD - SysTick->VAL);
+    }
+    while(now - start >= CLOCK_CYC_PER_MS) {
+        start += CLOCK_CYC_PER_MS;
+        ms++;
+    }
+    next->ms = ms;
+    next->start = start;
+    _gen++;
+    _ms32 = (uint32_t)ms;
+}
+
+/**
+ * @brief   获取 64 位周期计数 (自 dwt_init 起)
+ * @retval  uint64_t 周期数
+ */
+uint64_t clock_get_cycles(void) {
+    uint64_t ms;
+    uint32_t cyc = _read(&ms);
+    return _origin + ms * CLOCK_CYC_PER_MS + cyc;
+}
+
+/**
+ * @brief   获取 64 位微秒时间 (自 systick_init 起)
+ * @retval  uint64_t 微秒数
+ * @note    只做 32 位除法, 不调用 64 位除法库函数
+ */
+uint64_t clock_get_us(void) {
+    uint64_t ms;
+    uint32_t cyc = _read(&ms);
+    return ms * 1000u + cyc / CPU_FREQ_MHZ;
+}
+
+/**
+ * @brief   获取 64 位毫秒时间 (自 systick_init 起)
+ * @retval  uint64_t 毫秒数
+ * @note    包含 SysTick 中断挂起期间已走过的毫秒, 与 clock_get_us / 1000 一致
+ */
+uint64_t clock_get_ms(void) {
+    uint64_t ms;
+    uint32_t cyc = _read(&ms);
+    return ms + cyc / CLOCK_CYC_PER_MS;
+}
+
+/**
+ * @brief   获取 32 位毫秒时间 (约 49.7 天回绕, 以无符号差值比较)
+ * @retval  uint32_t SysTick 中断已计入的毫秒数
+ * @note    单次读取, 开销与原 SysTick 计数相同; SysTick 中断挂起期间比 clock_get_ms 小 1
+ */
+uint32_t clock_get_ms32(void) {
+    return _ms32;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   读取一致的整毫秒数与距该毫秒起点的周期数
+ * @param   ms 输出整毫秒数
+ * @retval  uint32_t 距起点的周期数 (SysTick 中断挂起时可超过 CLOCK_CYC_PER_MS)
+ */
+static uint32_t _read(uint64_t* ms) {
+    uint32_t gen;
+    uint32_t start;
+    uint32_t now;
+
+    do {
+        gen = _gen;
+        *ms = _snap[gen & 1].ms;
+        start = _snap[gen & 1].start;
+        now = dwt_get_cycles();
+    } while(gen != _gen);
+    return now - start;
+}
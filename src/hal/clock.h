@@ -0,0 +1,34 @@
+/**
+ * @file    clock.h
+ * @brief   64 位单调时基
+ *          以 DWT 周期计数为唯一时间来源, SysTick 中断 (1 ms) 记录已走过的整毫秒数及其起点周期,
+ *          周期、微秒、毫秒均由 "整毫秒数 + 距起点的周期数" 换算, 三者严格一致且不回绕 (约 8000 年)
+ * @note    读取无锁, 任意优先级的中断与主循环均可调用: 中断在非活动副本中写入新的整毫秒数与起点周期,
+ *          写完后递增代号发布; 读取方读取代号对应的副本后确认代号未变, 否则重读 (读取方从不等待写入方,
+ *          高优先级中断打断 SysTick 中断时也不会死等)
+ * @note    要求 SysTick 中断至少每 59 s (DWT 回绕周期) 执行一次; 中断被推迟或合并时按周期数补齐整毫秒数.
+ *          WFI 休眠期间 CYCCNT 随内核时钟停止时 (未设置 DBGMCU_SLEEP), 整毫秒数改按 SysTick 中断次数推进,
+ *          毫秒仍准确, 但休眠期间的周期数与微秒不再连续
+ */
+#ifndef _clock_h_
+#define _clock_h_
+
+#include "dwt.h"
+
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 每毫秒的 CPU 周期数 (SysTick 重装值)
+#define CLOCK_CYC_PER_MS    (CPU_FREQ_MHZ * 1000u)
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void clock_init(void);
+void clock_tick(void);
+uint64_t clock_get_cycles(void);
+uint64_t clock_get_us(void);
+uint64_t clock_get_ms(void);
+uint32_t clock_get_ms32(void);
+
+#endif
@@ -3,6 +3,7 @@
  * @brief   DWT 微秒级计时器实现
  */
 #include "dwt.h"
+#include "clock.h"
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
@@ -18,6 +19,7 @@
  * @brief   初始化 DWT
  * @param   None
  * @retval  None
+ * @note    会清零周期计数, 需在 systick_init (64 位时基初始化) 之前调用
  */
 void dwt_init(void) {
     if(!(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk))
@@ -26,13 +28,22 @@ void dwt_init(void) {
     DWT->CYCCNT = 0;
 }
 
+/**
+ * @brief   获取 CPU 周期计数
+ * @param   None
+ * @retval  uint32_t 周期数 (约 59.6 s 回绕一次, 仅用于计算短时间间隔; 不回绕的计数用 clock_get_cycles)
+ */
+uint32_t dwt_get_cycles(void) {
+    return DWT->CYCCNT;
+}
+
 /**
  * @brief   获取系统运行微秒数
  * @param   None
- * @retval  us_t 微秒数
+ * @retval  us_t 微秒数 (64 位时基的低 32 位, 约 71.6 分钟回绕; 需要不回绕的时间用 clock_get_us)
  */
 us_t dwt_get_us(void) {
-    return DWT->CYCCNT / CPU_FREQ_MHZ;
+    return (us_t)clock_get_us();
 }
 
 /**
@@ -40,13 +51,10 @@ us_t dwt_get_us(void) {
  * @param   start 起始时间
  * @param   timeout_us 超时时间
  * @retval  bool true:超时, false:未超时
+ * @note    以无符号差值比较, 跨越回绕时同样正确
  */
 bool dwt_is_timeout(us_t start, us_t timeout_us) {
-    us_t now = dwt_get_us();
-    if(now >= start)
-        return (now - start) >= timeout_us ? true : false;
-    else
-        return ((0xFFFFFFFFU - start) + now + 1) >= timeout_us ? true : false;
+    return (us_t)(dwt_get_us() - start) >= timeout_us;
 }
 
 // ! ========================= 私 有 函 数 实 现 ========================= ! //
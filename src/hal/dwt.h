@@ -41,6 +41,7 @@ typedef uint32_t us_t;
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
 
 void dwt_init(void);
+uint32_t dwt_get_cycles(void);
 us_t dwt_get_us(void);
 bool dwt_is_timeout(us_t start, us_t timeout_us);
 
@@ -1,13 +1,14 @@
 /**
  * @file    systick.c
  * @brief   SysTick 1 ms 心跳实现
- *          72 MHz / 72000 = 1 kHz
+ *          72 MHz / 72000 = 1 kHz, 每次中断推进 64 位时基 (clock.c)
  */
 #include "systick.h"
+#include "clock.h"
+#include "s_prof.h"
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
-static volatile ms_t _ms = 0;
 
 // ! ========================= 私 有 函 数 声 明 ========================= ! //
 
@@ -21,18 +22,18 @@ static volatile ms_t _ms = 0;
  * @retval  None
  */
 void systick_init(void) {
-    SysTick_Config(72000);
+    SysTick_Config(CLOCK_CYC_PER_MS);
     NVIC_SetPriority(SysTick_IRQn, 15);
-    _ms = 0;
+    clock_init();
 }
 
 /**
  * @brief   获取毫秒级系统时间
  * @param   None
- * @retval  ms_t 毫秒数
+ * @retval  ms_t 毫秒数 (64 位时基的低 32 位, 约 49.7 天回绕)
  */
 ms_t systick_get_ms(void) {
-    return _ms;
+    return clock_get_ms32();
 }
 
 /**
@@ -41,7 +42,7 @@ ms_t systick_get_ms(void) {
  * @retval  ms_t 秒数
  */
 ms_t systick_get_s(void) {
-    return _ms / 1000;
+    return (ms_t)(clock_get_ms() / 1000u);
 }
 
 /**
@@ -49,13 +50,10 @@ ms_t systick_get_s(void) {
  * @param   start 起始时间
  * @param   timeout_ms 超时时间
  * @retval  bool true:超时, false:未超时
+ * @note    以无符号差值比较, 跨越回绕时同样正确
  */
 bool systick_is_timeout(ms_t start, ms_t timeout_ms) {
-    ms_t now = _ms;
-    if(now >= start)
-        return (now - start) >= timeout_ms ? true : false;
-    else
-        return ((0xFFFFFFFFU - start) + now + 1) >= timeout_ms ? true : false;
+    return (ms_t)(clock_get_ms32() - start) >= timeout_ms;
 }
 
 /**
@@ -64,7 +62,9 @@ bool systick_is_timeout(ms_t start, ms_t timeout_ms) {
  * @retval  None
  */
 void SysTick_Handler(void) {
-    _ms++;
+    PROF_BEGIN(ISR_SYSTICK);
+    clock_tick();
+    PROF_END(ISR_SYSTICK);
 }
 
 // ! ========================= 私 有 函 数 实 现 ========================= ! //
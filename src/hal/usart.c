@@ -8,6 +8,7 @@
  *              USART3: PB10-TX  PB11-RX
  */
 #include "usart.h"
+#include "s_prof.h"
 #include <stdio.h>
 
 // ! ========================= 变 量 声 明 ========================= ! //
@@ -58,6 +59,7 @@ static usart_t* _handles[USART_COUNT] = { 0 };
 
 // ! ========================= 私 有 函 数 声 明 ========================= ! //
 
+static void _tx_push(usart_t* handle, uint8_t byte);
 
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
@@ -71,6 +73,10 @@ void usart_init(usart_t* handle, const usart_cfg_t* cfg) {
     handle->cfg = cfg;
     handle->rx_head = 0;
     handle->rx_tail = 0;
+    handle->rx_overflow = 0;
+    handle->rx_cb = 0;
+    handle->tx_head = 0;
+    handle->tx_tail = 0;
 
     usart_id_e id = cfg->id;
     const usart_hw_t* hw = &_hw[id];
@@ -107,14 +113,16 @@ void usart_init(usart_t* handle, const usart_cfg_t* cfg) {
     ui.USART_Mode = USART_Mode_Rx | USART_Mode_Tx;
     USART_Init(hw->periph, &ui);
 
-    /* RX 中断 */
-    if(cfg->enable_rx_irq) {
+    /* RX / TX 中断 (TXE 中断在有数据待发时才打开) */
+    if(cfg->enable_rx_irq || cfg->enable_tx_irq) {
         NVIC_InitTypeDef ni;
         ni.NVIC_IRQChannel = hw->irqn;
         ni.NVIC_IRQChannelPreemptionPriority = cfg->nvic_preempt;
         ni.NVIC_IRQChannelSubPriority = cfg->nvic_sub;
         ni.NVIC_IRQChannelCmd = ENABLE;
         NVIC_Init(&ni);
+    }
+    if(cfg->enable_rx_irq) {
         USART_ITConfig(hw->periph, USART_IT_RXNE, ENABLE);
     }
 
@@ -125,8 +133,14 @@ void usart_init(usart_t* handle, const usart_cfg_t* cfg) {
  * @brief   发送单字节
  * @param   handle 句柄
  * @param   byte 字节数据
+ * @note    启用 TX 中断时经由发送缓冲区, 仅在缓冲区满时等待
  */
 void usart_send_byte(usart_t* handle, uint8_t byte) {
+    if(handle->cfg->enable_tx_irq) {
+        while(usart_tx_free(handle) == 0);
+        _tx_push(handle, byte);
+        return;
+    }
     const usart_hw_t* hw = &_hw[handle->cfg->id];
     while(USART_GetFlagStatus(hw->periph, USART_FLAG_TC) == RESET);
     USART_SendData(hw->periph, byte);
@@ -155,8 +169,94 @@ bool usart_read_byte(usart_t* handle, uint8_t* out) {
     return true;
 }
 
+/**
+ * @brief   获取接收缓冲区中待读取的字节数
+ * @param   handle 句柄
+ * @retval  uint16_t 字节数
+ */
+uint16_t usart_rx_count(usart_t* handle) {
+    return (uint16_t)((handle->rx_head + USART_RX_BUF_SIZE - handle->rx_tail) % USART_RX_BUF_SIZE);
+}
+
+/**
+ * @brief   原地查看接收缓冲区中待读取的数据 (不移出)
+ * @param   handle 句柄
+ * @param   count 输出待读取字节数
+ * @retval  const uint8_t* 最早一个待读取字节的地址; 其后 min(count, USART_RX_MIRROR) 字节在内存中连续
+ * @note    数据由 usart_rx_consume 移出前不会被中断覆盖
+ */
+const uint8_t* usart_rx_peek(usart_t* handle, uint16_t* count) {
+    *count = usart_rx_count(handle);
+    return &handle->rx_buf[handle->rx_tail];
+}
+
+/**
+ * @brief   移出接收缓冲区中已处理的数据
+ * @param   handle 句柄
+ * @param   n 字节数, 不超过 usart_rx_count
+ */
+void usart_rx_consume(usart_t* handle, uint16_t n) {
+    handle->rx_tail = (uint16_t)((handle->rx_tail + n) % USART_RX_BUF_SIZE);
+}
+
+/**
+ * @brief   获取接收缓冲区溢出计数
+ * @param   handle 句柄
+ * @retval  uint32_t 因缓冲区满而丢弃的字节总数
+ */
+uint32_t usart_rx_overflow(usart_t* handle) {
+    return handle->rx_overflow;
+}
+
+/**
+ * @brief   设置接收字节回调
+ * @param   handle 句柄
+ * @param   cb 回调函数, 0 表示取消
+ * @note    回调在接收中断中逐字节调用, 应只做少量判断; 字节仍照常写入接收缓冲区
+ */
+void usart_set_rx_cb(usart_t* handle, usart_rx_cb_t cb) {
+    handle->rx_cb = cb;
+}
+
+/**
+ * @brief   非阻塞发送数据块 (写入发送缓冲区, 由 TXE 中断发出)
+ * @param   handle 句柄
+ * @param   data 数据
+ * @param   len 数据长度
+ * @retval  bool - true:已全部写入, false:未启用 TX 中断或剩余空间不足 (整块丢弃)
+ */
+bool usart_write(usart_t* handle, const uint8_t* data, uint16_t len) {
+    if(!handle->cfg->enable_tx_irq) return false;
+    if(usart_tx_free(handle) < len) return false;
+    for(uint16_t i = 0; i < len; ++i)
+        _tx_push(handle, data[i]);
+    return true;
+}
+
+/**
+ * @brief   获取发送缓冲区剩余空间
+ * @param   handle 句柄
+ * @retval  uint16_t 可写入字节数
+ */
+uint16_t usart_tx_free(usart_t* handle) {
+    uint16_t used = (uint16_t)((handle->tx_head + USART_TX_BUF_SIZE - handle->tx_tail) % USART_TX_BUF_SIZE);
+    return (uint16_t)(USART_TX_BUF_SIZE - 1 - used);
+}
+
 // ! ========================= 私 有 函 数 实 现 ========================= ! //
 
+/**
+ * @brief   写入一个字节到发送缓冲区并打开 TXE 中断
+ * @param   handle 句柄
+ * @param   byte 字节数据
+ * @note    调用前需确认缓冲区未满
+ */
+static void _tx_push(usart_t* handle, uint8_t byte) {
+    handle->tx_buf[handle->tx_head] = byte;
+    handle->tx_head = (handle->tx_head + 1) % USART_TX_BUF_SIZE;
+    USART_ITConfig(_hw[handle->cfg->id].periph, USART_IT_TXE, ENABLE);
+}
+
 /**
  * @brief   USART 中断服务函数
  * @note    由 USART1_IRQHandler、USART2_IRQHandler、USART3_IRQHandler 调用
@@ -168,17 +268,40 @@ static void _usart_irq(usart_id_e id) {
     if(USART_GetITStatus(hw->periph, USART_IT_RXNE) != RESET) {
         uint8_t data = (uint8_t)USART_ReceiveData(hw->periph);
         uint16_t next = (handle->rx_head + 1) % USART_RX_BUF_SIZE;
-        // 如果缓冲区未满，则存储数据；否则丢弃数据
+        if(handle->rx_cb) handle->rx_cb(data);
+        // 如果缓冲区未满，则存储数据；否则丢弃数据并计数
         if(next != handle->rx_tail) {
             handle->rx_buf[handle->rx_head] = data;
+            if(handle->rx_head < USART_RX_MIRROR) handle->rx_buf[USART_RX_BUF_SIZE + handle->rx_head] = data;
             handle->rx_head = next;
         }
+        else {
+            handle->rx_overflow++;
+        }
         USART_ClearITPendingBit(hw->periph, USART_IT_RXNE);
     }
+    if(USART_GetITStatus(hw->periph, USART_IT_TXE) != RESET) {
+        if(handle->tx_head != handle->tx_tail) {
+            USART_SendData(hw->periph, handle->tx_buf[handle->tx_tail]);
+            handle->tx_tail = (handle->tx_tail + 1) % USART_TX_BUF_SIZE;
+        }
+        else {
+            // 发送缓冲区已空, 关闭 TXE 中断
+            USART_ITConfig(hw->periph, USART_IT_TXE, DISABLE);
+        }
+    }
 }
 
-void USART1_IRQHandler(void) { _usart_irq(USART_1); }
-void USART2_IRQHandler(void) { _usart_irq(USART_2); }
+void USART1_IRQHandler(void) {
+    PROF_BEGIN(ISR_USART1);
+    _usart_irq(USART_1);
+    PROF_END(ISR_USART1);
+}
+void USART2_IRQHandler(void) {
+    PROF_BEGIN(ISR_USART2);
+    _usart_irq(USART_2);
+    PROF_END(ISR_USART2);
+}
 void USART3_IRQHandler(void) { _usart_irq(USART_3); }
 
 #pragma import(__use_no_semihosting)
@@ -190,6 +313,12 @@ void _sys_exit(int x) { x = x; }
 
 int fputc(int ch, FILE* f) {
     (void)f;
+    // USART1 启用发送缓冲时走缓冲区, 保证与 usart_write 的输出顺序一致
+    usart_t* handle = _handles[USART_1];
+    if(handle && handle->cfg->enable_tx_irq) {
+        usart_send_byte(handle, (uint8_t)ch);
+        return ch;
+    }
     while((USART1->SR & 0x40) == 0);
     USART1->DR = (uint8_t)ch;
     return ch;
@@ -12,8 +12,16 @@
 
 // ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
 
-/// @brief USART RX 环形缓冲区大小
-#define USART_RX_BUF_SIZE  128
+/// @brief USART RX 环形缓冲区大小 (需容纳上层协议的整个发送窗口)
+#define USART_RX_BUF_SIZE  512
+/// @brief RX 缓冲区尾部镜像长度: 中断同时把写入开头的字节复制到缓冲区末尾之后,
+///        使从任意位置起长度不超过该值的数据在内存中连续, 上层可原地解析跨越回绕点的数据
+#define USART_RX_MIRROR    128
+/// @brief USART TX 环形缓冲区大小 (仅 enable_tx_irq 时使用)
+#define USART_TX_BUF_SIZE  256
+
+/// @brief 接收字节回调 (在接收中断中调用, 先于写入接收缓冲区, 缓冲区满时也会调用)
+typedef void(*usart_rx_cb_t)(uint8_t byte);
 
 /**
  * @brief USART ID 枚举
@@ -32,6 +40,7 @@ typedef struct {
     usart_id_e id;          // USART ID
     uint32_t baudrate;      // 波特率
     uint8_t enable_rx_irq;  // 是否启用 RX 中断
+    uint8_t enable_tx_irq;  // 是否启用 TX 中断 (非阻塞发送)
     uint8_t nvic_preempt;   // 抢占优先级
     uint8_t nvic_sub;       // 子优先级
 } usart_cfg_t;
@@ -41,9 +50,14 @@ typedef struct {
  */
 typedef struct {
     const usart_cfg_t* cfg;
-    uint8_t  rx_buf[USART_RX_BUF_SIZE];
+    uint8_t  rx_buf[USART_RX_BUF_SIZE + USART_RX_MIRROR];
     volatile uint16_t rx_head;
     volatile uint16_t rx_tail;
+    volatile uint32_t rx_overflow;  // 接收缓冲区满而丢弃的字节数
+    usart_rx_cb_t rx_cb;            // 接收字节回调, 0 表示无
+    uint8_t  tx_buf[USART_TX_BUF_SIZE];
+    volatile uint16_t tx_head;
+    volatile uint16_t tx_tail;
 } usart_t;
 
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
@@ -52,5 +66,12 @@ void usart_init(usart_t* handle, const usart_cfg_t* cfg);
 void usart_send_byte(usart_t* handle, uint8_t byte);
 void usart_send_string(usart_t* handle, const char* str);
 bool usart_read_byte(usart_t* handle, uint8_t* out);
+bool usart_write(usart_t* handle, const uint8_t* data, uint16_t len);
+uint16_t usart_tx_free(usart_t* handle);
+uint16_t usart_rx_count(usart_t* handle);
+const uint8_t* usart_rx_peek(usart_t* handle, uint16_t* count);
+void usart_rx_consume(usart_t* handle, uint16_t n);
+uint32_t usart_rx_overflow(usart_t* handle);
+void usart_set_rx_cb(usart_t* handle, usart_rx_cb_t cb);
 
 #endif
@@ -8,6 +8,6 @@ int main(void) {
     a_board_init();
 
     while(1) {
-        a_fsm_process();
+        s_sched_run();
     }
 }
@@ -0,0 +1,45 @@
+/**
+ * @file    s_atomic.h
+ * @brief   基于 LDREX/STREX 的无锁原子操作 (Cortex-M3)
+ *          可在中断与主循环间安全使用, 不关中断
+ */
+#ifndef _s_atomic_h_
+#define _s_atomic_h_
+
+#include "stm32f10x.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+/**
+ * @brief   比较并交换
+ * @param   addr 目标地址
+ * @param   expected 期望的旧值
+ * @param   desired 新值
+ * @retval  bool - true:交换成功, false:旧值不符或独占访问失败
+ */
+static inline bool s_atomic_cas(volatile uint32_t* addr, uint32_t expected, uint32_t desired) {
+    if(__LDREXW(addr) != expected) {
+        __CLREX();
+        return false;
+    }
+    return __STREXW(desired, addr) == 0;
+}
+
+/**
+ * @brief   原子加法
+ * @param   addr 目标地址
+ * @param   val 加数
+ * @retval  uint32_t 相加之前的值
+ */
+static inline uint32_t s_atomic_add(volatile uint32_t* addr, uint32_t val) {
+    uint32_t old;
+    do {
+        old = __LDREXW(addr);
+    } while(__STREXW(old + val, addr) != 0);
+    return old;
+}
+
+#endif
@@ -7,11 +7,8 @@
 // ! ========================= 变 量 声 明 ========================= ! //
 
 typedef struct {
-    ms_t(*get_ms)(void);
-    bool(*ms_timeout)(ms_t start, uint32_t timeout_ms);
-
-    us_t(*get_us)(void);
-    bool(*us_timeout)(us_t start, uint32_t timeout_us);
+    uint64_t(*get_ms)(void);
+    uint64_t(*get_us)(void);
 } delay_ops_t;
 
 static delay_ops_t _delay_ops = { 0 };
@@ -24,19 +21,14 @@ static delay_ops_t _delay_ops = { 0 };
 
 /**
  * @brief   延时服务初始化
- * @param   get_ms 获取当前毫秒数的函数指针
- * @param   ms_timeout 判断毫秒级是否超时的函数指针, 超时返回 true, 未超时返回 false
- * @param   get_us 获取当前微秒数的函数指针
- * @param   us_timeout 判断微秒级是否超时的函数指针, 超时返回 true, 未超时返回 false
+ * @param   get_ms 获取当前 64 位毫秒数的函数指针
+ * @param   get_us 获取当前 64 位微秒数的函数指针
  * @note    用法: 在系统初始化时调用, 传入对应的函数指针, 即可使用延时服务. 例如:
- * @note    s_delay_init(systick_get_ms, systick_is_timeout, dwt_get_us, dwt_is_timeout);
- * @note    其中: ms_t = us_t = uint32_t
+ * @note    s_delay_init(clock_get_ms, clock_get_us);
  */
-void s_delay_init(ms_t(*get_ms)(void), bool(*ms_timeout)(ms_t start, ms_t timeout_ms), us_t(*get_us)(void), bool(*us_timeout)(us_t start, us_t timeout_us)) {
+void s_delay_init(uint64_t(*get_ms)(void), uint64_t(*get_us)(void)) {
     _delay_ops.get_ms = get_ms;
-    _delay_ops.ms_timeout = ms_timeout;
     _delay_ops.get_us = get_us;
-    _delay_ops.us_timeout = us_timeout;
 }
 
 /**
@@ -45,8 +37,8 @@ void s_delay_init(ms_t(*get_ms)(void), bool(*ms_timeout)(ms_t start, ms_t timeou
  * @retval  None
  */
 void s_delay_us(us_t us) {
-    us_t start = _delay_ops.get_us();
-    while(!_delay_ops.us_timeout(start, us));
+    uint64_t end = _delay_ops.get_us() + us;
+    while(_delay_ops.get_us() < end);
 }
 
 /**
@@ -55,8 +47,8 @@ void s_delay_us(us_t us) {
  * @retval  None
  */
 void s_delay_ms(ms_t ms) {
-    ms_t start = _delay_ops.get_ms();
-    while(!_delay_ops.ms_timeout(start, ms));
+    uint64_t end = _delay_ops.get_ms() + ms;
+    while(_delay_ops.get_ms() < end);
 }
 
 /**
@@ -65,23 +57,25 @@ void s_delay_ms(ms_t ms) {
  * @retval  None
  */
 void s_delay_s(ms_t s) {
-    ms_t start = _delay_ops.get_ms();
-    while(!_delay_ops.ms_timeout(start, s * 1000));
+    uint64_t end = _delay_ops.get_ms() + (uint64_t)s * 1000u;
+    while(_delay_ops.get_ms() < end);
 }
 
 /**
  * @brief   非阻塞微秒延时
- * @param   start 指向起始时间的指针
+ * @param   d 延时状态 (首次调用时开始计时, 到期后复位, 下次调用重新开始)
  * @param   interval_us 延时间隔(us)
  * @retval  bool - true:时间到, false:未到
  */
-bool s_nb_delay_us(us_t* start, us_t interval_us) {
-    if(*start == 0) {
-        *start = _delay_ops.get_us();
+bool s_nb_delay_us(nb_delay_t* d, us_t interval_us) {
+    us_t now = (us_t)_delay_ops.get_us();
+    if(!d->running) {
+        d->start = now;
+        d->running = true;
         return false;
     }
-    if(_delay_ops.us_timeout(*start, interval_us)) {
-        *start = 0;
+    if((us_t)(now - d->start) >= interval_us) {
+        d->running = false;
         return true;
     }
     return false;
@@ -89,17 +83,19 @@ bool s_nb_delay_us(us_t* start, us_t interval_us) {
 
 /**
  * @brief   非阻塞毫秒延时
- * @param   start 指向起始时间的指针
+ * @param   d 延时状态 (首次调用时开始计时, 到期后复位, 下次调用重新开始)
  * @param   interval_ms 延时间隔(ms)
  * @retval  bool -  true:时间到, false:未到
  */
-bool s_nb_delay_ms(ms_t* start, ms_t interval_ms) {
-    if(*start == 0) {
-        *start = _delay_ops.get_ms();
+bool s_nb_delay_ms(nb_delay_t* d, ms_t interval_ms) {
+    ms_t now = (ms_t)_delay_ops.get_ms();
+    if(!d->running) {
+        d->start = now;
+        d->running = true;
         return false;
     }
-    if(_delay_ops.ms_timeout(*start, interval_ms)) {
-        *start = 0;
+    if((ms_t)(now - d->start) >= interval_ms) {
+        d->running = false;
         return true;
     }
     return false;
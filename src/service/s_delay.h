@@ -1,6 +1,10 @@
 /**
  * @file    s_delay.h
  * @brief   延时服务 (阻塞 & 非阻塞)
+ * @note    时间来源为 64 位单调时基, 阻塞延时以 64 位截止时间比较, 不受计数回绕影响;
+ *          非阻塞延时的起始时间为 32 位, 以无符号差值比较, 间隔须小于回绕周期的一半
+ * @note    非阻塞延时以 running 标志区分是否已开始计时, 起始时刻为 0 (上电或回绕到 0) 时同样正确;
+ *          需要多个定时动作或到期回调时使用 s_timer
  */
 #ifndef _s_delay_h_
 #define _s_delay_h_
@@ -13,13 +17,23 @@
 typedef uint32_t ms_t;
 typedef uint32_t us_t;
 
+/**
+ * @brief   非阻塞延时状态, 使用前以 NB_DELAY_INIT 初始化
+ */
+typedef struct {
+    uint32_t start;         // 起始时刻 (ms 或 us)
+    bool running;           // 已开始计时
+} nb_delay_t;
+
+#define NB_DELAY_INIT       { 0, false }
+
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
 
-void s_delay_init(ms_t(*get_ms)(void), bool(*ms_timeout)(ms_t start, ms_t timeout_ms), us_t(*get_us)(void), bool(*us_timeout)(us_t start, us_t timeout_us));
+void s_delay_init(uint64_t(*get_ms)(void), uint64_t(*get_us)(void));
 void s_delay_us(us_t us);
 void s_delay_ms(ms_t ms);
 void s_delay_s(ms_t s);
-bool s_nb_delay_us(us_t* start, us_t interval_us);
-bool s_nb_delay_ms(ms_t* start, ms_t interval_ms);
+bool s_nb_delay_us(nb_delay_t* d, us_t interval_us);
+bool s_nb_delay_ms(nb_delay_t* d, ms_t interval_ms);
 
 #endif
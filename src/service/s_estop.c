@@ -0,0 +1,178 @@
+/**
+ * @file    s_estop.c
+ * @brief   急停服务实现
+ */
+#include "s_estop.h"
+#include "s_proto_bin.h"
+#include "s_trace.h"
+#include "s_wireless_comms.h"
+#include "dwt.h"
+
+#include <stdio.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+// 急停帧 COBS 编码后的长度 (不含定界符): type + seq + crc16 共 4 字节, COBS 固定多 1 字节
+#define ESTOP_FRAME_ENC_LEN  5
+
+static Relay* _relay = 0;
+static estop_hook_t _hook = 0;
+
+static const char _ascii[] = "$ESTOP";
+static uint8_t _ascii_idx = 0;                      // 已匹配的 "$ESTOP" 字符数
+static uint8_t _bin_buf[ESTOP_FRAME_ENC_LEN];
+static uint8_t _bin_n = 0xFF;                       // 上一个定界符之后的字节数 (饱和于 0xFF)
+
+/**
+ * @brief   急停统计 (周期为识别到最后一个字节后至继电器断开的耗时)
+ */
+static volatile uint32_t _count = 0;
+static volatile uint32_t _last_cyc = 0;
+static volatile uint32_t _max_cyc = 0;
+
+static comms_status_e _cmd_stats(const comms_args_t* args);
+static comms_status_e _cmd_reset(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "ESTOP_STATS",    "",     _cmd_stats, 0,  COMMS_DONE_NONE },
+    { "ESTOP_RESET",    "",     _cmd_reset, 0,  COMMS_DONE_NONE },
+};
+#define ESTOP_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static bool _match_ascii(uint8_t byte);
+static bool _match_bin(uint8_t byte);
+static bool _is_estop_frame(void);
+static void _halt(uint32_t start);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化急停服务: 挂接串口接收回调并注册串口命令
+ * @param   usart 命令串口 (需启用 RX 中断)
+ * @param   relay 急停时断开的继电器
+ * @param   hook 急停通知 (在中断中调用), 可为 0
+ * @note    需在 s_wireless_comms_init 之后调用
+ */
+void s_estop_init(usart_t* usart, Relay* relay, estop_hook_t hook) {
+    _relay = relay;
+    _hook = hook;
+    _ascii_idx = 0;
+    _bin_n = 0xFF;
+    _count = 0;
+    _last_cyc = 0;
+    _max_cyc = 0;
+    s_wireless_comms_register(_cmds, ESTOP_CMD_COUNT);
+    usart_set_rx_cb(usart, s_estop_feed);
+}
+
+/**
+ * @brief   输入一个接收字节, 识别到急停命令时立即执行急停
+ * @param   byte 接收字节
+ * @note    作为串口接收回调在中断中调用; 每字节只做常数次比较, 仅在收到急停帧的结尾时计算 CRC
+ */
+void s_estop_feed(uint8_t byte) {
+    uint32_t start = dwt_get_cycles();
+    // 两种形式各自推进匹配状态, 不能短路
+    bool hit = _match_ascii(byte);
+    hit = _match_bin(byte) || hit;
+    if(hit) _halt(start);
+}
+
+/**
+ * @brief   直接触发急停 (供其他急停来源使用, 如外部中断输入)
+ * @note    可在中断中调用
+ */
+void s_estop_trigger(void) {
+    _halt(dwt_get_cycles());
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   ASCII 形式匹配: "$ESTOP" 后紧跟 '#' 或 '@'
+ */
+static bool _match_ascii(uint8_t byte) {
+    if(_ascii_idx == sizeof(_ascii) - 1) {
+        _ascii_idx = (byte == '$');
+        return byte == '#' || byte == '@';
+    }
+    if(byte == (uint8_t)_ascii[_ascii_idx]) {
+        _ascii_idx++;
+        return false;
+    }
+    _ascii_idx = (byte == '$');
+    return false;
+}
+
+/**
+ * @brief   二进制形式匹配: 记录定界符之后的字节, 在下一个定界符处检查是否为急停帧
+ */
+static bool _match_bin(uint8_t byte) {
+    if(byte == PROTO_BIN_DELIM) {
+        bool hit = (_bin_n == ESTOP_FRAME_ENC_LEN) && _is_estop_frame();
+        _bin_n = 0;
+        return hit;
+    }
+    if(_bin_n < ESTOP_FRAME_ENC_LEN) _bin_buf[_bin_n] = byte;
+    if(_bin_n < 0xFF) _bin_n++;
+    return false;
+}
+
+/**
+ * @brief   COBS 解码已记录的 ESTOP_FRAME_ENC_LEN 字节并校验类型与 CRC
+ */
+static bool _is_estop_frame(void) {
+    uint8_t raw[ESTOP_FRAME_ENC_LEN - 1];
+    uint8_t n = 0;
+    uint8_t i = 0;
+
+    while(i < ESTOP_FRAME_ENC_LEN) {
+        uint8_t code = _bin_buf[i++];
+        if(code == 0 || i + code - 1 > ESTOP_FRAME_ENC_LEN) return false;
+        for(uint8_t k = 1; k < code; ++k) raw[n++] = _bin_buf[i++];
+        if(code < 0xFF && i < ESTOP_FRAME_ENC_LEN) raw[n++] = 0;
+    }
+    if(n != sizeof(raw) || raw[0] != COMMS_MSG_ESTOP) return false;
+    return s_proto_bin_crc16(raw, 2, 0xFFFFu) == (uint16_t)(raw[2] | ((uint16_t)raw[3] << 8));
+}
+
+/**
+ * @brief   断开继电器, 记录耗时后通知上层
+ * @param   start 识别开始时的周期计数
+ */
+static void _halt(uint32_t start) {
+    if(_relay) _relay->halt(_relay);
+    uint32_t cyc = dwt_get_cycles() - start;
+
+    _count++;
+    _last_cyc = cyc;
+    if(cyc > _max_cyc) _max_cyc = cyc;
+    s_trace_fault(TRACE_FAULT_ESTOP, 0, cyc);
+    if(_hook) _hook();
+}
+
+/**
+ * @brief   $ESTOP_STATS# : 输出急停统计
+ * @note    格式: $ESTOP:<次数>,<最近一次周期>,<最大周期>#, 周期为识别到最后一个字节后至继电器断开的耗时,
+ *          不含中断进入与读取数据寄存器的固定开销
+ */
+static comms_status_e _cmd_stats(const comms_args_t* args) {
+    (void)args;
+    printf("$ESTOP:%lu,%lu,%lu#", (unsigned long)_count, (unsigned long)_last_cyc, (unsigned long)_max_cyc);
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $ESTOP_RESET# : 解除急停锁定, 继电器恢复可驱动 (不恢复运行)
+ * @note    急停后继电器一直锁定断开, 只能由此命令解除; 状态机错误状态不会自动解除
+ */
+static comms_status_e _cmd_reset(const comms_args_t* args) {
+    (void)args;
+    if(_relay) _relay->release(_relay);
+    return COMMS_OK;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file    s_estop.h
+ * @brief   急停服务
+ *          在串口接收中断中逐字节识别急停命令, 识别后立即断开继电器并通知上层 (投递 EVENT_ERROR),
+ *          不经接收缓冲区、命令解析与状态机主循环
+ * @note    识别两种形式:
+ *          ASCII : "$ESTOP" 后紧跟 '#' 或 '@' (即 $ESTOP# 与 $ESTOP@<seq>#), 收到 '#' / '@' 时触发;
+ *                  带执行时刻的 $ESTOP!<ms># 不在中断中触发, 按定时命令执行
+ *          二进制: 类型为 COMMS_MSG_ESTOP、无负载、CRC 正确的帧 (序号任意), 收到结尾定界符时触发
+ *          字节仍照常写入接收缓冲区, 由 s_wireless_comms 按普通命令回复 ACK
+ *          继电器保持锁定断开, 直到收到 $ESTOP_RESET#
+ */
+#ifndef _s_estop_h_
+#define _s_estop_h_
+
+#include "usart.h"
+#include "d_relay.h"
+
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+/**
+ * @brief   急停通知, 在中断中调用 (须可在中断中执行)
+ */
+typedef void(*estop_hook_t)(void);
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_estop_init(usart_t* usart, Relay* relay, estop_hook_t hook);
+void s_estop_feed(uint8_t byte);
+void s_estop_trigger(void);
+
+#endif
@@ -0,0 +1,138 @@
+/**
+ * @file    s_event_queue.c
+ * @brief   无锁多生产者单消费者事件队列实现
+ */
+#include "s_event_queue.h"
+#include "s_atomic.h"
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define EVQ_MASK    (EVQ_CAPACITY - 1)
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static bool _ring_push(evq_ring_t* ring, const evq_item_t* item);
+static bool _ring_pop(evq_ring_t* ring, evq_item_t* out);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化事件队列
+ * @param   q 队列句柄
+ */
+void s_event_queue_init(evq_t* q) {
+    for(uint8_t p = 0; p < EVQ_PRIO_COUNT; ++p) {
+        evq_ring_t* ring = &q->rings[p];
+        for(uint32_t i = 0; i < EVQ_CAPACITY; ++i) {
+            ring->cells[i].seq = i;
+        }
+        ring->enqueue_pos = 0;
+        ring->dequeue_pos = 0;
+        ring->overflow = 0;
+    }
+}
+
+/**
+ * @brief   投递事件 (可在中断中调用)
+ * @param   q 队列句柄
+ * @param   prio 优先级
+ * @param   id 事件 ID
+ * @param   arg 事件负载
+ * @retval  bool - true:成功, false:队列满 (丢弃并计数)
+ */
+bool s_event_queue_push(evq_t* q, evq_prio_e prio, uint16_t id, evq_arg_t arg) {
+    if(prio >= EVQ_PRIO_COUNT) prio = EVQ_PRIO_NORMAL;
+    evq_item_t item;
+    item.id = id;
+    item.arg = arg;
+    return _ring_push(&q->rings[prio], &item);
+}
+
+/**
+ * @brief   取出一个事件 (仅主循环调用)
+ * @param   q 队列句柄
+ * @param   out 输出事件
+ * @retval  bool - true:成功, false:队列空
+ */
+bool s_event_queue_pop(evq_t* q, evq_item_t* out) {
+    for(uint8_t p = 0; p < EVQ_PRIO_COUNT; ++p) {
+        if(_ring_pop(&q->rings[p], out)) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief   判断队列是否为空
+ * @param   q 队列句柄
+ * @retval  bool - true:所有优先级均无待处理事件
+ */
+bool s_event_queue_empty(const evq_t* q) {
+    for(uint8_t p = 0; p < EVQ_PRIO_COUNT; ++p) {
+        if(q->rings[p].enqueue_pos != q->rings[p].dequeue_pos) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief   获取溢出计数
+ * @param   q 队列句柄
+ * @param   prio 优先级
+ * @retval  uint32_t 因队列满被丢弃的事件数
+ */
+uint32_t s_event_queue_overflow(const evq_t* q, evq_prio_e prio) {
+    return (prio < EVQ_PRIO_COUNT) ? q->rings[prio].overflow : 0;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   入队
+ * @param   ring 单优先级环形队列
+ * @param   item 事件
+ * @retval  bool - true:成功, false:队列满
+ */
+static bool _ring_push(evq_ring_t* ring, const evq_item_t* item) {
+    evq_cell_t* cell;
+    uint32_t pos = ring->enqueue_pos;
+
+    // 抢占写入位置: 槽位序号等于 pos 表示空闲
+    for(;;) {
+        cell = &ring->cells[pos & EVQ_MASK];
+        int32_t diff = (int32_t)(cell->seq - pos);
+        if(diff == 0) {
+            if(s_atomic_cas(&ring->enqueue_pos, pos, pos + 1)) break;
+            pos = ring->enqueue_pos;
+        }
+        else if(diff < 0) {
+            s_atomic_add(&ring->overflow, 1);
+            return false;
+        }
+        else {
+            pos = ring->enqueue_pos;
+        }
+    }
+
+    // 写入数据后再发布序号
+    cell->item = *item;
+    __DMB();
+    cell->seq = pos + 1;
+    return true;
+}
+
+/**
+ * @brief   出队
+ * @param   ring 单优先级环形队列
+ * @param   out 输出事件
+ * @retval  bool - true:成功, false:队列空或槽位尚未发布
+ */
+static bool _ring_pop(evq_ring_t* ring, evq_item_t* out) {
+    uint32_t pos = ring->dequeue_pos;
+    evq_cell_t* cell = &ring->cells[pos & EVQ_MASK];
+    if((int32_t)(cell->seq - (pos + 1)) < 0) return false;
+
+    *out = cell->item;
+    __DMB();
+    cell->seq = pos + EVQ_CAPACITY;
+    ring->dequeue_pos = pos + 1;
+    return true;
+}
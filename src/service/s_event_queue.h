@@ -0,0 +1,73 @@
+/**
+ * @file    s_event_queue.h
+ * @brief   无锁多生产者单消费者事件队列
+ *          生产者: 主循环 / 任意优先级中断; 消费者: 主循环
+ *          每个优先级一个有界环形队列, 出队时高优先级优先
+ * @note    每个槽位带序号 (Vyukov 有界队列), 生产者以 CAS 抢占写入位置,
+ *          写完后发布序号; 消费者只取已发布的槽位, 因此被打断的生产者不会导致丢失或读到半写数据
+ */
+#ifndef _s_event_queue_h_
+#define _s_event_queue_h_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 每个优先级的队列容量 (必须为 2 的幂)
+#define EVQ_CAPACITY        16
+
+/**
+ * @brief 事件优先级
+ */
+typedef enum {
+    EVQ_PRIO_HIGH = 0,
+    EVQ_PRIO_NORMAL,
+    EVQ_PRIO_COUNT
+} evq_prio_e;
+
+/**
+ * @brief 事件负载
+ */
+typedef union {
+    float f;
+    int32_t i;
+    uint32_t u;
+} evq_arg_t;
+
+/**
+ * @brief 事件
+ */
+typedef struct {
+    uint16_t id;
+    evq_arg_t arg;
+} evq_item_t;
+
+typedef struct {
+    volatile uint32_t seq;
+    evq_item_t item;
+} evq_cell_t;
+
+typedef struct {
+    evq_cell_t cells[EVQ_CAPACITY];
+    volatile uint32_t enqueue_pos;
+    uint32_t dequeue_pos;
+    volatile uint32_t overflow;     // 队列满导致的丢弃次数
+} evq_ring_t;
+
+/**
+ * @brief 事件队列句柄
+ */
+typedef struct {
+    evq_ring_t rings[EVQ_PRIO_COUNT];
+} evq_t;
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_event_queue_init(evq_t* q);
+bool s_event_queue_push(evq_t* q, evq_prio_e prio, uint16_t id, evq_arg_t arg);
+bool s_event_queue_pop(evq_t* q, evq_item_t* out);
+bool s_event_queue_empty(const evq_t* q);
+uint32_t s_event_queue_overflow(const evq_t* q, evq_prio_e prio);
+
+#endif
@@ -0,0 +1,315 @@
+/**
+ * @file    s_fault.c
+ * @brief   故障捕获服务实现
+ */
+#include "s_fault.h"
+#include "s_log.h"
+#include "s_proto_bin.h"
+#include "s_wireless_comms.h"
+#include "stm32f10x.h"
+
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define FAULT_MAGIC         0x46415554u     // "FAUT"
+// 压栈帧的合法地址范围 (STM32F103 SRAM 最大 64 KB), 超出时不读取, 避免在异常中再次出错
+#define FAULT_RAM_START     0x20000000u
+#define FAULT_RAM_END       0x20010000u
+
+#if defined(__CC_ARM)
+#define FAULT_NOINIT        __attribute__((section(".noinit"), zero_init))
+#define FAULT_RETURN_ADDR() ((uint32_t)__return_address())
+#else
+#define FAULT_NOINIT        __attribute__((section(".noinit")))
+#define FAULT_RETURN_ADDR() ((uint32_t)(uintptr_t)__builtin_return_address(0))
+#endif
+
+/**
+ * @brief   故障快照 (复位后保留)
+ */
+typedef struct {
+    uint32_t magic;
+    uint16_t count;                     // 快照有效期间累计的故障次数
+    uint8_t kind;                       // fault_kind_e
+    uint8_t state;                      // 状态机状态 ID, 0xFF 为未知
+    uint32_t ms;                        // 故障时的运行时间
+    uint32_t regs[8];                   // 压栈帧 r0 r1 r2 r3 r12 lr pc xpsr (断言时只有 lr, 为调用处返回地址)
+    uint32_t sp;                        // 压栈帧地址
+    uint32_t exc_return;
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t line;
+    char file[FAULT_FILE_LEN];
+    uint8_t trace_n;
+    trace_rec_t trace[FAULT_TRACE_N];
+    uint16_t crc;
+} fault_snap_t;
+
+static FAULT_NOINIT fault_snap_t _snap;
+
+static uint32_t(*_get_ms)(void) = 0;
+static uint8_t(*_get_state)(void) = 0;
+static uint8_t _reset = 0;              // 本次启动的复位原因 (_reset_names 下标)
+
+/**
+ * @brief   复位原因, 按优先级排列 (上电复位时 PIN 标志同时置位)
+ */
+static const struct {
+    uint8_t flag;
+    const char* name;
+} _reset_names[] = {
+    { 0,                "?" },
+    { RCC_FLAG_LPWRRST, "LPWR" },
+    { RCC_FLAG_WWDGRST, "WWDG" },
+    { RCC_FLAG_IWDGRST, "IWDG" },
+    { RCC_FLAG_SFTRST,  "SW" },
+    { RCC_FLAG_PORRST,  "POR" },
+    { RCC_FLAG_PINRST,  "PIN" },
+};
+#define FAULT_RESET_COUNT  (sizeof(_reset_names) / sizeof(_reset_names[0]))
+
+static const char* const _kind_names[] = { "NONE", "HARD", "ASSERT" };
+
+static comms_status_e _cmd_fault(const comms_args_t* args);
+static comms_status_e _cmd_clear(const comms_args_t* args);
+static comms_status_e _cmd_test(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "FAULT",          "",     _cmd_fault, 0,  COMMS_DONE_NONE },
+    { "FAULT_CLEAR",    "",     _cmd_clear, 0,  COMMS_DONE_NONE },
+    { "FAULT_TEST",     "i",    _cmd_test,  0,  COMMS_DONE_NONE },
+};
+#define FAULT_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static bool _valid(void);
+static uint16_t _crc(void);
+static void _capture(uint8_t kind, uint32_t sp, uint32_t exc_return, uint32_t lr, const char* file, uint32_t line);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化故障服务: 读取并清除复位原因, 注册串口命令
+ * @param   get_ms 运行时间来源
+ * @param   get_state 状态机状态 ID 来源, 可为 0
+ * @note    需在 s_wireless_comms_init 之后调用; 之前发生的故障记录的时间与状态为 0 / 0xFF
+ */
+void s_fault_init(uint32_t(*get_ms)(void), uint8_t(*get_state)(void)) {
+    _get_ms = get_ms;
+    _get_state = get_state;
+
+    _reset = 0;
+    for(uint8_t i = 1; i < FAULT_RESET_COUNT && !_reset; ++i) {
+        if(RCC_GetFlagStatus(_reset_names[i].flag) == SET) _reset = i;
+    }
+    RCC_ClearFlag();
+    if(!_valid()) memset(&_snap, 0, sizeof(_snap));
+
+    s_wireless_comms_register(_cmds, FAULT_CMD_COUNT);
+}
+
+/**
+ * @brief   启动报告: 有故障快照时在命令串口输出完整报告, 并写一条错误日志
+ * @note    快照保留到 $FAULT_CLEAR#, 期间每次启动都会报告
+ */
+void s_fault_report(void) {
+    if(!_valid()) return;
+    _cmd_fault(0);
+    s_log_error("fault: %s #%u pc=%08lx lr=%08lx cfsr=%08lx",
+        _kind_names[_snap.kind], (unsigned)_snap.count, (unsigned long)_snap.regs[6],
+        (unsigned long)_snap.regs[5], (unsigned long)_snap.cfsr);
+}
+
+/**
+ * @brief   断言失败: 记录文件、行号与调用处后复位
+ * @param   file 源文件名
+ * @param   line 行号
+ */
+void s_fault_assert(const char* file, uint32_t line) {
+    __disable_irq();
+    _capture(FAULT_KIND_ASSERT, 0, 0, FAULT_RETURN_ADDR(), file, line);
+}
+
+/**
+ * @brief   HardFault 处理 (由 HardFault_Handler 调用): 记录压栈帧后复位
+ * @param   frame 异常压栈帧 (MSP 或 PSP)
+ * @param   exc_return 异常返回值 (进入异常时的 LR)
+ */
+void s_fault_hard(const uint32_t* frame, uint32_t exc_return) {
+    _capture(FAULT_KIND_HARD, (uint32_t)(uintptr_t)frame, exc_return, 0, 0, 0);
+}
+
+/**
+ * @brief   HardFault 入口: 按 EXC_RETURN 取得压栈帧所在的栈, 不压栈直接跳转到 s_fault_hard
+ */
+#if defined(__CC_ARM)
+__asm void HardFault_Handler(void) {
+    TST     LR, #4
+    ITE     EQ
+    MRSEQ   R0, MSP
+    MRSNE   R0, PSP
+    MOV     R1, LR
+    B       __cpp(s_fault_hard)
+}
+#elif defined(__arm__)
+__attribute__((naked)) void HardFault_Handler(void) {
+    __asm volatile(
+        "tst    lr, #4          \n"
+        "ite    eq              \n"
+        "mrseq  r0, msp         \n"
+        "mrsne  r0, psp         \n"
+        "mov    r1, lr          \n"
+        "b      s_fault_hard    \n");
+}
+#endif
+
+#ifdef USE_FULL_ASSERT
+/**
+ * @brief   标准外设库 assert_param 失败回调
+ */
+void assert_failed(uint8_t* file, uint32_t line) {
+    s_fault_assert((const char*)file, line);
+}
+#endif
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   快照是否有效 (魔数、类型与 CRC 均正确)
+ */
+static bool _valid(void) {
+    return _snap.magic == FAULT_MAGIC && _snap.kind != FAULT_KIND_NONE && _snap.kind <= FAULT_KIND_ASSERT
+        && _snap.crc == _crc();
+}
+
+/**
+ * @brief   快照 CRC (不含 crc 字段)
+ */
+static uint16_t _crc(void) {
+    return s_proto_bin_crc16((const uint8_t*)&_snap, offsetof(fault_snap_t, crc), 0xFFFFu);
+}
+
+/**
+ * @brief   写入快照并复位
+ * @param   sp 压栈帧地址, 断言时为 0 (只记录 lr)
+ * @note    先保存寄存器并计算一次 CRC, 再读取状态机状态与跟踪记录 (依赖可能已损坏的 RAM) 后重新计算,
+ *          后者再次出错导致锁定时, 前一份快照仍有效
+ */
+static void _capture(uint8_t kind, uint32_t sp, uint32_t exc_return, uint32_t lr, const char* file, uint32_t line) {
+    uint16_t count = _valid() ? _snap.count : 0;
+
+    memset(&_snap, 0, sizeof(_snap));
+    _snap.magic = FAULT_MAGIC;
+    _snap.count = (uint16_t)(count + 1);
+    _snap.kind = kind;
+    _snap.state = 0xFF;
+    if(!(sp & 3u) && sp >= FAULT_RAM_START && sp <= FAULT_RAM_END - sizeof(_snap.regs)) {
+        memcpy(_snap.regs, (const void*)(uintptr_t)sp, sizeof(_snap.regs));
+    }
+    else {
+        _snap.regs[5] = lr;
+    }
+    _snap.sp = sp;
+    _snap.exc_return = exc_return;
+    _snap.cfsr = SCB->CFSR;
+    _snap.hfsr = SCB->HFSR;
+    _snap.mmfar = SCB->MMFAR;
+    _snap.bfar = SCB->BFAR;
+    _snap.line = line;
+    if(file) {
+        size_t n = strlen(file);
+        for(size_t i = n; i > 0; --i) {
+            if(file[i - 1] == '/' || file[i - 1] == '\\') {
+                file += i;
+                n -= i;
+                break;
+            }
+        }
+        if(n >= FAULT_FILE_LEN) {
+            file += n - (FAULT_FILE_LEN - 1);
+            n = FAULT_FILE_LEN - 1;
+        }
+        memcpy(_snap.file, file, n);
+    }
+    _snap.crc = _crc();
+
+    _snap.ms = _get_ms ? _get_ms() : 0;
+    _snap.state = _get_state ? _get_state() : 0xFF;
+    _snap.trace_n = s_trace_last(_snap.trace, FAULT_TRACE_N);
+    _snap.crc = _crc();
+
+    NVIC_SystemReset();
+    while(1) {}
+}
+
+/**
+ * @brief   $FAULT# : 输出复位原因与故障快照
+ * @note    格式: $FAULT:<复位原因>,<类型>,<次数>,<ms>,<状态 ID>#  (无快照时为 $FAULT:<复位原因>,NONE#)
+ *          $FAULT_REGS:<r0>,<r1>,<r2>,<r3>,<r12>,<lr>,<pc>,<xpsr>,<sp>,<exc_return>#
+ *          $FAULT_STATUS:<CFSR>,<HFSR>,<MMFAR>,<BFAR>#
+ *          $FAULT_ASSERT:<文件>:<行号>#  (仅断言)
+ *          每条跟踪记录一行 $FAULT_TRACE:<cyc>,<ev>,<a>,<b>,<c>#
+ *          寄存器均为 8 位十六进制
+ */
+static comms_status_e _cmd_fault(const comms_args_t* args) {
+    (void)args;
+    const char* reset = _reset_names[_reset].name;
+
+    if(!_valid()) {
+        printf("$FAULT:%s,NONE#", reset);
+        return COMMS_OK;
+    }
+    printf("$FAULT:%s,%s,%u,%lu,%u#", reset, _kind_names[_snap.kind], (unsigned)_snap.count,
+        (unsigned long)_snap.ms, (unsigned)_snap.state);
+    printf("$FAULT_REGS:");
+    for(uint8_t i = 0; i < 8; ++i) printf("%08lx,", (unsigned long)_snap.regs[i]);
+    printf("%08lx,%08lx#", (unsigned long)_snap.sp, (unsigned long)_snap.exc_return);
+    printf("$FAULT_STATUS:%08lx,%08lx,%08lx,%08lx#", (unsigned long)_snap.cfsr, (unsigned long)_snap.hfsr,
+        (unsigned long)_snap.mmfar, (unsigned long)_snap.bfar);
+    if(_snap.kind == FAULT_KIND_ASSERT) printf("$FAULT_ASSERT:%s:%lu#", _snap.file, (unsigned long)_snap.line);
+    for(uint8_t i = 0; i < _snap.trace_n && i < FAULT_TRACE_N; ++i) {
+        const trace_rec_t* r = &_snap.trace[i];
+        printf("$FAULT_TRACE:%lu,%u,%u,%u,%lu#", (unsigned long)r->cyc, (unsigned)r->ev, (unsigned)r->a,
+            (unsigned)r->b, (unsigned long)r->c);
+    }
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $FAULT_CLEAR# : 清除故障快照
+ */
+static comms_status_e _cmd_clear(const comms_args_t* args) {
+    (void)args;
+    memset(&_snap, 0, sizeof(_snap));
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $FAULT_TEST:<n># : 主动触发故障以验证捕获流程 (随即复位, 无回复)
+ * @note    1:断言失败, 2:访问无效地址 (BusFault), 3:以 ARM 状态跳转 (UsageFault INVSTATE)
+ */
+static comms_status_e _cmd_test(const comms_args_t* args) {
+    switch(args->v[0].i) {
+        case 1:
+            S_ASSERT(0);
+            break;
+        case 2:
+            (void)*(volatile uint32_t*)0xCCCCCCCCu;
+            break;
+        case 3:
+            ((void(*)(void))((uintptr_t)_cmd_clear & ~(uintptr_t)1))();
+            break;
+        default:
+            return COMMS_ERR_ARG;
+    }
+    return COMMS_OK;
+}
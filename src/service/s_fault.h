@@ -0,0 +1,46 @@
+/**
+ * @file    s_fault.h
+ * @brief   故障捕获服务
+ *          HardFault 或断言失败时把现场 (压栈寄存器、故障状态寄存器、状态机状态、最近的跟踪记录)
+ *          写入复位后保留的 RAM 快照, 然后软件复位; 下次启动时在命令串口输出报告, 并可用 $FAULT# 查询
+ * @note    快照位于 .noinit 段, 须由链接配置置为不初始化:
+ *          Keil 分散加载文件中为该段单独设置 UNINIT 执行域, GNU ld 中为 (NOLOAD) 输出段;
+ *          快照带魔数与 CRC, 未正确配置或上电复位后内容无效, 只会报告为无故障
+ * @note    MemManage / BusFault / UsageFault 未单独使能, 均升级为 HardFault, 具体原因见 CFSR
+ */
+#ifndef _s_fault_h_
+#define _s_fault_h_
+
+#include "s_trace.h"
+
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 快照保存的最近跟踪记录条数
+#define FAULT_TRACE_N       8
+// 断言文件名保存长度 (含结尾 0, 超长时保留末尾部分)
+#define FAULT_FILE_LEN      24
+
+/**
+ * @brief   故障类型
+ */
+typedef enum {
+    FAULT_KIND_NONE = 0,
+    FAULT_KIND_HARD,        // HardFault (含升级而来的 MemManage / BusFault / UsageFault)
+    FAULT_KIND_ASSERT,      // S_ASSERT 或标准外设库 assert_param 失败
+} fault_kind_e;
+
+/**
+ * @brief   断言: 条件不成立时记录文件与行号并复位
+ */
+#define S_ASSERT(expr)      ((expr) ? (void)0 : s_fault_assert(__FILE__, __LINE__))
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_fault_init(uint32_t(*get_ms)(void), uint8_t(*get_state)(void));
+void s_fault_report(void);
+void s_fault_assert(const char* file, uint32_t line);
+void s_fault_hard(const uint32_t* frame, uint32_t exc_return);
+
+#endif
@@ -2,97 +2,547 @@
  * @file    s_log.c
  * @brief   日志输出服务实现
  */
+#define LOG_MODULE  LOG
+
 #include "s_log.h"
+#include "s_num.h"
+#include "s_proto_bin.h"
+#include "s_wireless_comms.h"
+#include "dwt.h"
+
+#include <string.h>
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
 #define ANSI_RED     "\x1b[31m"
 #define ANSI_YELLOW  "\x1b[33m"
 #define ANSI_BLUE    "\x1b[34m"
+#define ANSI_GRAY    "\x1b[90m"
 #define ANSI_RESET   "\x1b[0m"
 
-// ! ========================= 私 有 函 数 声 明 ========================= ! //
+// 行尾 (颜色复位 + 换行) 预留长度
+#define LOG_TAIL_LEN  (sizeof(ANSI_RESET "\r\n") - 1)
+// 压力测试最高行频 (行/秒)
+#define LOG_FLOOD_MAX 1000
+// 波形基准测试重复次数
+#define LOG_WAVE_BENCH_ROUNDS  32
+// 日志点 ID: FNV-1a (与 tools/logdec.py 一致)
+#define LOG_FNV_OFFSET  2166136261u
+#define LOG_FNV_PRIME   16777619u
+// 记录头: 长度 + 序号; 之后为 LOG 帧负载
+#define LOG_REC_HEAD    2
+#define LOG_REC_MAX     (LOG_REC_HEAD + PROTO_BIN_MAX_PAYLOAD)
+
+#if LOG_WAVE_MAX_CH * 4 > PROTO_BIN_MAX_PAYLOAD || PROTO_BIN_MAX_ENCODED > LOG_LINE_MAX
+#error "LOG_WAVE_MAX_CH 个 f32 放不进一帧 WAVE 负载"
+#endif
+
+static usart_t* _usart = 0;         // 0: 经 printf 输出
+static uint32_t(*_get_ms)(void) = 0;
+
+static const char* const _color[] = { "", ANSI_RED, ANSI_YELLOW, ANSI_BLUE, ANSI_GRAY };
+static const char* const _tag[] = { "", "[ERROR] ", "[WARN] ", "[INFO] ", "[DEBUG] " };
+
+// 模块名 (与 log_module_e 对应) 及编译期等级
+static const char* const _mod_name[LOG_MOD_COUNT] = { "MISC", "BOARD", "FSM", "LOG" };
+static const uint8_t _mod_level[LOG_MOD_COUNT] = { LOG_LEVEL_MISC, LOG_LEVEL_BOARD, LOG_LEVEL_FSM, LOG_LEVEL_LOG };
 
+uint8_t s_log_levels[LOG_MOD_COUNT];
 
+// 延迟日志记录环形缓冲区 (仅主循环读写)
+static uint8_t _ring[LOG_RING_SIZE];
+static uint16_t _ring_head = 0;
+static uint16_t _ring_tail = 0;
+static uint8_t _seq = 0;
+
+/**
+ * @brief   输出统计, 耗时为日志函数内的周期数 (文本模式含等待发送的时间, 延迟模式只含写入记录)
+ */
+typedef struct {
+    uint32_t lines;
+    uint32_t bytes;
+    uint32_t dropped;
+    uint32_t max_cyc;
+    uint64_t sum_cyc;
+} log_stat_t;
+
+static log_stat_t _stat;
+static log_stat_t _wave_stat;       // 波形统计, 行数为帧数
+static uint8_t _wave_fmt = LOG_WAVE_FMT;
+static uint8_t _wave_seq = 0;
+
+// 压力测试: 按固定行频输出 INFO 日志
+static uint32_t _flood_period_ms = 0;
+static uint32_t _flood_next_ms = 0;
+static uint32_t _flood_n = 0;
+
+static comms_status_e _cmd_stats(const comms_args_t* args);
+static comms_status_e _cmd_flood(const comms_args_t* args);
+static comms_status_e _cmd_level(const comms_args_t* args);
+static comms_status_e _cmd_levels(const comms_args_t* args);
+static comms_status_e _cmd_wave_fmt(const comms_args_t* args);
+static comms_status_e _cmd_wave_stats(const comms_args_t* args);
+static comms_status_e _cmd_wave_bench(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "LOG_STATS",  "",     _cmd_stats,         0,  COMMS_DONE_NONE },
+    { "LOG_FLOOD",  "i",    _cmd_flood,         0,  COMMS_DONE_NONE },
+    { "LOG_LEVEL",  "ii",   _cmd_level,         0,  COMMS_DONE_NONE },
+    { "LOG_LEVELS", "",     _cmd_levels,        0,  COMMS_DONE_NONE },
+    { "WAVE_FMT",   "i",    _cmd_wave_fmt,      0,  COMMS_DONE_NONE },
+    { "WAVE_STATS", "",     _cmd_wave_stats,    0,  COMMS_DONE_NONE },
+    { "WAVE_BENCH", "i",    _cmd_wave_bench,    0,  COMMS_DONE_NONE },
+};
+#define LOG_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static void _vlog(const char* color, const char* tag, const char* fmt, va_list args);
+static void _out(const uint8_t* data, uint16_t len, uint32_t start, log_stat_t* stat);
+static uint16_t _wave_text(char* line, const float* v, uint8_t count);
+static uint16_t _wave_float(uint8_t* buf, const float* v, uint8_t count, uint8_t seq);
+static void _parse_site(log_site_t* site, const char* fmt);
+static void _record(log_site_t* site, uint8_t level, va_list args);
+static uint16_t _ring_used(void);
+static void _put32(uint8_t* p, uint32_t v);
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
+/**
+ * @brief   初始化日志服务并注册串口命令
+ * @param   usart 独立日志串口 (需启用 TX 中断), 0 表示经 printf 与命令回复共用 USART1
+ * @param   get_ms 时间戳来源 (日志行前缀与压力测试计时)
+ * @note    需在 s_wireless_comms_init 之后调用
+ */
+void s_log_init(usart_t* usart, uint32_t(*get_ms)(void)) {
+    _usart = usart;
+    _get_ms = get_ms;
+    memset(&_stat, 0, sizeof(_stat));
+    memset(&_wave_stat, 0, sizeof(_wave_stat));
+    _wave_fmt = LOG_WAVE_FMT;
+    _wave_seq = 0;
+    for(uint8_t i = 0; i < LOG_MOD_COUNT; ++i) s_log_levels[i] = LOG_RUNTIME_LEVEL;
+    _flood_period_ms = 0;
+    _ring_head = 0;
+    _ring_tail = 0;
+    s_wireless_comms_register(_cmds, LOG_CMD_COUNT);
+}
+
+/**
+ * @brief   日志后台任务, 由调度器作为后台任务调用
+ * @note    延迟模式下在发送缓冲区有空间时把记录逐条打包为 LOG 帧发出;
+ *          $LOG_FLOOD:<n># 开启后按每秒 n 行输出 INFO 日志, 用于测量日志负载对命令延迟的影响
+ */
+void s_log_task(void) {
+    while(LOG_DEFERRED && _usart && _ring_tail != _ring_head) {
+        uint8_t rec[LOG_REC_MAX];
+        uint8_t frame[PROTO_BIN_MAX_ENCODED];
+        uint8_t len = _ring[_ring_tail];
+
+        // 编码后长度不超过 负载 + CRC + COBS 开销 + 两个定界符 = len + 5
+        if(usart_tx_free(_usart) < len + 5u) break;
+        for(uint8_t i = 0; i < len; ++i) rec[i] = _ring[(_ring_tail + i) % LOG_RING_SIZE];
+        uint16_t n = s_proto_bin_encode(COMMS_MSG_LOG, rec[1], &rec[LOG_REC_HEAD], (uint8_t)(len - LOG_REC_HEAD),
+            frame, sizeof(frame));
+        usart_write(_usart, frame, n);
+        _ring_tail = (uint16_t)((_ring_tail + len) % LOG_RING_SIZE);
+        _stat.bytes += n;
+    }
+    if(!_flood_period_ms || !_get_ms) return;
+    if((int32_t)(_get_ms() - _flood_next_ms) < 0) return;
+
+    _flood_next_ms += _flood_period_ms;
+    if((int32_t)(_get_ms() - _flood_next_ms) >= 0) _flood_next_ms = _get_ms() + _flood_period_ms;
+    s_log_info("load test line %lu, padded to a typical log length", (unsigned long)_flood_n++);
+}
+
 /**
  * @brief   输出波形数据
- * @param   count 数据个数
+ * @param   count 数据个数 (超出 LOG_WAVE_MAX_CH 的数据忽略)
  * @param   ... float* 类型的指针
  * @retval  None
+ * @note    独立串口上默认为二进制 WAVE 帧 (见 s_log.h), 否则为文本行 [WAVE] : v1,v2,...\r\n;
+ *          整帧写入发送缓冲区, 空间不足时丢弃并计数 (丢弃的帧也占用序号), 不阻塞
  */
 void s_log_wave(int count, ...) {
-    printf("[WAVE] : ");
+    uint32_t start = dwt_get_cycles();
+    float v[LOG_WAVE_MAX_CH];
+    uint8_t n = 0;
+
     va_list args;
     va_start(args, count);
-    for(int i = 0; i < count; ++i) {
-        float* ptr = (float*)va_arg(args, void*);
-        if(i > 0) printf(",");
-        printf("%f", *ptr);
-    }
+    for(; n < count && n < LOG_WAVE_MAX_CH; ++n) v[n] = *(const float*)va_arg(args, void*);
     va_end(args);
-    printf("\r\n");
+
+    uint8_t buf[LOG_LINE_MAX];
+    uint16_t len = (_usart && _wave_fmt == LOG_WAVE_FLOAT) ? _wave_float(buf, v, n, _wave_seq++) : _wave_text((char*)buf, v, n);
+    _out(buf, len, start, &_wave_stat);
 }
 
 /**
- * @brief   输出 INFO 日志
+ * @brief   输出日志 (由 s_log_error / warn / info / debug 调用, 等级已在调用处过滤)
+ * @param   site 调用处的日志点
+ * @param   level 等级
  * @param   fmt 格式化字符串
  * @param   ... 参数
  * @retval  None
+ * @note    仅在主循环中调用; 延迟模式下只写入记录, 不格式化
  */
-void s_log_info(const char* fmt, ...) {
-#if (LOG_LEVEL >= LOG_LEVEL_INFO)
-    printf(ANSI_BLUE "[INFO] ");
+void s_log_write(log_site_t* site, uint8_t level, const char* fmt, ...) {
+    if(level > LOG_LEVEL_DEBUG || level < LOG_LEVEL_ERROR) return;
+
     va_list args;
     va_start(args, fmt);
-    vprintf(fmt, args);
+    if(LOG_DEFERRED && _usart) {
+        if(!site->ready) _parse_site(site, fmt);
+        _record(site, level, args);
+        va_end(args);
+        return;
+    }
+    _vlog(_color[level], _tag[level], fmt, args);
     va_end(args);
-    printf(ANSI_RESET "\r\n");
-#else
-    (void)fmt;
-#endif
 }
 
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
 /**
- * @brief   输出 WARN 日志
+ * @brief   格式化一行日志并输出
+ * @param   color 颜色控制符
+ * @param   tag 等级标签
  * @param   fmt 格式化字符串
- * @param   ... 参数
- * @retval  None
+ * @param   args 参数
+ * @note    格式: <颜色><标签><ms> <内容><复位>\r\n, 内容超长时截断
  */
-void s_log_warn(const char* fmt, ...) {
-#if (LOG_LEVEL >= LOG_LEVEL_WARN)
-    printf(ANSI_YELLOW "[WARN] ");
-    va_list args;
-    va_start(args, fmt);
-    vprintf(fmt, args);
-    va_end(args);
-    printf(ANSI_RESET "\r\n");
-#else
-    (void)fmt;
-#endif
+static void _vlog(const char* color, const char* tag, const char* fmt, va_list args) {
+    uint32_t start = dwt_get_cycles();
+    char line[LOG_LINE_MAX];
+    const uint16_t room = (uint16_t)(sizeof(line) - LOG_TAIL_LEN);
+    int n = snprintf(line, room, "%s%s%lu ", color, tag, (unsigned long)(_get_ms ? _get_ms() : 0u));
+
+    if(n < 0) return;
+    if(n < room) {
+        int m = vsnprintf(line + n, (size_t)(room - n), fmt, args);
+        if(m > 0) n += m;
+    }
+    if(n > room - 1) n = room - 1;
+    memcpy(&line[n], ANSI_RESET "\r\n", LOG_TAIL_LEN);
+    _out((const uint8_t*)line, (uint16_t)(n + LOG_TAIL_LEN), start, &_stat);
+}
+
+/**
+ * @brief   输出一行 (或一帧波形) 并累计统计
+ * @param   data 内容 (不要求 '\0' 结尾)
+ * @param   len 长度
+ * @param   start 开始格式化时的周期计数
+ * @param   stat 计入的统计
+ */
+static void _out(const uint8_t* data, uint16_t len, uint32_t start, log_stat_t* stat) {
+    if(_usart) {
+        if(!usart_write(_usart, data, len)) {
+            stat->dropped++;
+            return;
+        }
+    }
+    else {
+        printf("%.*s", (int)len, (const char*)data);
+    }
+
+    uint32_t cyc = dwt_get_cycles() - start;
+    stat->lines++;
+    stat->bytes += len;
+    stat->sum_cyc += cyc;
+    if(cyc > stat->max_cyc) stat->max_cyc = cyc;
+}
+
+/**
+ * @brief   波形文本行: [WAVE] : v1,v2,...\r\n, 数值保留 6 位小数
+ * @param   line 输出缓冲区 (LOG_LINE_MAX 字节)
+ * @param   v 数据
+ * @param   count 数据个数
+ * @retval  行长度
+ * @note    超出 LOG_LINE_MAX 的数据截断
+ */
+static uint16_t _wave_text(char* line, const float* v, uint8_t count) {
+    uint16_t n = 0;
+    const char* head = "[WAVE] : ";
+
+    while(*head) line[n++] = *head++;
+    for(uint8_t i = 0; i < count; ++i) {
+        char num[NUM_FMT_BUF_SIZE];
+        uint8_t len = s_num_fmt_f32(num, v[i], 6);
+        if(n + 1u + len + 2u > LOG_LINE_MAX) break;
+        if(i > 0) line[n++] = ',';
+        memcpy(&line[n], num, len);
+        n = (uint16_t)(n + len);
+    }
+    line[n++] = '\r';
+    line[n++] = '\n';
+    return n;
+}
+
+/**
+ * @brief   波形 WAVE 帧: 负载为小端 f32 × count, 经 s_proto_bin 打包 (COBS + CRC, 含前后定界符)
+ * @param   buf 输出缓冲区 (至少 PROTO_BIN_MAX_ENCODED 字节)
+ * @param   v 数据 (Cortex-M3 为小端, 直接作为负载)
+ * @param   count 数据个数 (不超过 LOG_WAVE_MAX_CH)
+ * @param   seq 帧序号
+ * @retval  帧长度
+ */
+static uint16_t _wave_float(uint8_t* buf, const float* v, uint8_t count, uint8_t seq) {
+    return s_proto_bin_encode(COMMS_MSG_WAVE, seq, (const uint8_t*)v, (uint8_t)(count * sizeof(float)),
+        buf, PROTO_BIN_MAX_ENCODED);
 }
 
 /**
- * @brief   输出 ERROR 日志
+ * @brief   解析日志点: 计算格式字符串的 ID 并按转换说明记录参数类型
+ * @param   site 日志点
  * @param   fmt 格式化字符串
- * @param   ... 参数
- * @retval  None
+ * @note    每个调用处只在首次调用时解析一次; '*' 宽度/精度各占一个整数参数
  */
-void s_log_error(const char* fmt, ...) {
-#if (LOG_LEVEL >= LOG_LEVEL_ERROR)
-    printf(ANSI_RED "[ERROR] ");
-    va_list args;
-    va_start(args, fmt);
-    vprintf(fmt, args);
-    va_end(args);
-    printf(ANSI_RESET "\r\n");
-#else
-    (void)fmt;
-#endif
+static void _parse_site(log_site_t* site, const char* fmt) {
+    uint32_t h = LOG_FNV_OFFSET;
+    const char* p = fmt;
+
+    for(; *p; ++p) h = (h ^ (uint8_t)*p) * LOG_FNV_PRIME;
+    site->id = h;
+    site->argc = 0;
+
+    p = fmt;
+    while(*p && site->argc < LOG_MAX_ARGS) {
+        if(*p++ != '%') continue;
+        if(*p == '%') {
+            p++;
+            continue;
+        }
+        uint8_t longs = 0;
+        for(;; ++p) {
+            char c = *p;
+            if(c == '*') {
+                if(site->argc < LOG_MAX_ARGS) site->types[site->argc++] = 'i';
+            }
+            else if(c == 'l') {
+                longs++;
+            }
+            else if(!(c == '-' || c == '+' || c == ' ' || c == '#' || c == '.' || c == 'h' || c == 'z'
+                || c == 'j' || c == 't' || (c >= '0' && c <= '9'))) {
+                break;
+            }
+        }
+        char t;
+        switch(*p) {
+            case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': case 'c': case 'p':
+                t = (longs >= 2) ? 'l' : 'i';
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+                t = 'f';
+                break;
+            case 's':
+                t = 's';
+                break;
+            default:
+                t = 0;
+                break;
+        }
+        if(!*p) break;
+        p++;
+        if(t && site->argc < LOG_MAX_ARGS) site->types[site->argc++] = t;
+    }
+    site->ready = 1;
 }
 
-// ! ========================= 私 有 函 数 实 现 ========================= ! //
+/**
+ * @brief   写入一条延迟日志记录
+ * @param   site 已解析的日志点
+ * @param   level 等级
+ * @param   args 参数
+ * @note    记录: | 长度 | 序号 | level | id | ms | 参数... |, 参数超出帧负载时截断;
+ *          环形缓冲区空间不足时丢弃整条记录 (序号照常递增, 上位机据此发现丢失)
+ */
+static void _record(log_site_t* site, uint8_t level, va_list args) {
+    uint32_t start = dwt_get_cycles();
+    uint8_t rec[LOG_REC_MAX];
+    uint8_t n = LOG_REC_HEAD;
+
+    rec[n++] = level;
+    _put32(&rec[n], site->id);
+    n += 4;
+    _put32(&rec[n], _get_ms ? _get_ms() : 0u);
+    n += 4;
+    for(uint8_t i = 0; i < site->argc; ++i) {
+        if(site->types[i] == 'l') {
+            uint64_t v = va_arg(args, unsigned long long);
+            if(n + 8u > sizeof(rec)) break;
+            _put32(&rec[n], (uint32_t)v);
+            _put32(&rec[n + 4], (uint32_t)(v >> 32));
+            n += 8;
+        }
+        else if(site->types[i] == 'f') {
+            float f = (float)va_arg(args, double);
+            if(n + 4u > sizeof(rec)) break;
+            memcpy(&rec[n], &f, 4);
+            n += 4;
+        }
+        else if(site->types[i] == 's') {
+            const char* str = va_arg(args, const char*);
+            uint8_t len = 0;
+            while(str && len < LOG_STR_MAX && str[len]) len++;
+            if(n + 1u + len > sizeof(rec)) break;
+            rec[n++] = len;
+            memcpy(&rec[n], str, len);
+            n = (uint8_t)(n + len);
+        }
+        else {
+            uint32_t v = va_arg(args, unsigned int);
+            if(n + 4u > sizeof(rec)) break;
+            _put32(&rec[n], v);
+            n += 4;
+        }
+    }
+    rec[0] = n;
+    rec[1] = _seq++;
+
+    if(LOG_RING_SIZE - 1u - _ring_used() < n) {
+        _stat.dropped++;
+        return;
+    }
+    for(uint8_t i = 0; i < n; ++i) _ring[(_ring_head + i) % LOG_RING_SIZE] = rec[i];
+    _ring_head = (uint16_t)((_ring_head + n) % LOG_RING_SIZE);
 
+    uint32_t cyc = dwt_get_cycles() - start;
+    _stat.lines++;
+    _stat.sum_cyc += cyc;
+    if(cyc > _stat.max_cyc) _stat.max_cyc = cyc;
+}
 
+/**
+ * @brief   环形缓冲区已用字节数
+ */
+static uint16_t _ring_used(void) {
+    return (uint16_t)((_ring_head + LOG_RING_SIZE - _ring_tail) % LOG_RING_SIZE);
+}
+
+/**
+ * @brief   按小端序写入 32 位数
+ */
+static void _put32(uint8_t* p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief   $LOG_STATS# : 输出日志统计并清零
+ * @note    格式: $LOG:<通道>,<行数>,<字节数>,<丢弃行数>,<平均/最大周期>,<待发送字节数>#,
+ *          通道 0 为 printf (USART1), 1 为独立串口 (文本), 2 为独立串口 (延迟二进制记录);
+ *          周期为单行日志在日志函数内的耗时, 共用 USART1 时包含等待发送缓冲区的阻塞时间;
+ *          延迟模式下行数为写入的记录数, 字节数为已发出的 LOG 帧字节数; 波形另计 ($WAVE_STATS#)
+ */
+static comms_status_e _cmd_stats(const comms_args_t* args) {
+    (void)args;
+    printf("$LOG:%u,%lu,%lu,%lu,%lu,%lu,%u#", _usart ? (LOG_DEFERRED ? 2u : 1u) : 0u,
+        (unsigned long)_stat.lines, (unsigned long)_stat.bytes, (unsigned long)_stat.dropped,
+        (unsigned long)(_stat.lines ? _stat.sum_cyc / _stat.lines : 0), (unsigned long)_stat.max_cyc,
+        (unsigned)_ring_used());
+    memset(&_stat, 0, sizeof(_stat));
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $WAVE_FMT:<0|1># : 切换波形格式, 0 为文本, 1 为二进制 WAVE 帧 (仅独立串口)
+ */
+static comms_status_e _cmd_wave_fmt(const comms_args_t* args) {
+    int32_t fmt = args->v[0].i;
+    if(fmt != LOG_WAVE_TEXT && fmt != LOG_WAVE_FLOAT) return COMMS_ERR_ARG;
+    if(fmt == LOG_WAVE_FLOAT && !_usart) return COMMS_ERR_ARG;
+    _wave_fmt = (uint8_t)fmt;
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $WAVE_STATS# : 输出波形统计并清零
+ * @note    格式: $WAVE:<格式>,<帧数>,<字节数>,<丢弃帧数>,<平均/最大周期>#, 格式为实际生效的格式;
+ *          周期为单帧在 s_log_wave 内的耗时 (含写入发送缓冲区)
+ */
+static comms_status_e _cmd_wave_stats(const comms_args_t* args) {
+    (void)args;
+    printf("$WAVE:%u,%lu,%lu,%lu,%lu,%lu#", (_usart && _wave_fmt == LOG_WAVE_FLOAT) ? 1u : 0u,
+        (unsigned long)_wave_stat.lines, (unsigned long)_wave_stat.bytes, (unsigned long)_wave_stat.dropped,
+        (unsigned long)(_wave_stat.lines ? _wave_stat.sum_cyc / _wave_stat.lines : 0),
+        (unsigned long)_wave_stat.max_cyc);
+    memset(&_wave_stat, 0, sizeof(_wave_stat));
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $WAVE_BENCH:<通道数># : 两种波形格式的编码基准测试 (只编码, 不发送)
+ * @note    格式: $WAVE_BENCH:<通道数>,<文本字节数>,<文本周期>,<二进制字节数>,<二进制周期>#,
+ *          字节数与周期均为一帧的值 (周期取 LOG_WAVE_BENCH_ROUNDS 次平均), 除以通道数即为每个数据的开销
+ */
+static comms_status_e _cmd_wave_bench(const comms_args_t* args) {
+    int32_t count = args->v[0].i;
+    if(count < 1 || count > LOG_WAVE_MAX_CH) return COMMS_ERR_ARG;
+
+    float v[LOG_WAVE_MAX_CH];
+    uint8_t buf[LOG_LINE_MAX];
+    uint32_t cyc[2] = { 0, 0 };
+    uint16_t len[2] = { 0, 0 };
+    // 典型量级: 位置 mm、速度 mm/s、角度 rad, 正负交替
+    for(int32_t i = 0; i < count; ++i) v[i] = (i & 1 ? -1.0f : 1.0f) * 123.456789f / (float)(i + 1);
+    for(uint8_t r = 0; r < LOG_WAVE_BENCH_ROUNDS; ++r) {
+        uint32_t t0 = dwt_get_cycles();
+        len[0] = _wave_text((char*)buf, v, (uint8_t)count);
+        uint32_t t1 = dwt_get_cycles();
+        len[1] = _wave_float(buf, v, (uint8_t)count, 0);
+        uint32_t t2 = dwt_get_cycles();
+        cyc[0] += t1 - t0;
+        cyc[1] += t2 - t1;
+    }
+    printf("$WAVE_BENCH:%ld,%u,%lu,%u,%lu#", (long)count, (unsigned)len[0],
+        (unsigned long)(cyc[0] / LOG_WAVE_BENCH_ROUNDS), (unsigned)len[1],
+        (unsigned long)(cyc[1] / LOG_WAVE_BENCH_ROUNDS));
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $LOG_LEVEL:<模块>,<等级># : 设置模块运行期等级, 模块 -1 表示全部, 等级 0 关闭
+ * @note    高于该模块编译期等级的调用已不在固件中, 设置更高的等级不会使其输出
+ */
+static comms_status_e _cmd_level(const comms_args_t* args) {
+    int32_t mod = args->v[0].i;
+    int32_t level = args->v[1].i;
+    if(mod < -1 || mod >= LOG_MOD_COUNT || level < 0 || level > LOG_LEVEL_DEBUG) return COMMS_ERR_ARG;
+    for(uint8_t i = 0; i < LOG_MOD_COUNT; ++i) {
+        if(mod < 0 || mod == i) s_log_levels[i] = (uint8_t)level;
+    }
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $LOG_LEVELS# : 输出各模块等级
+ * @note    格式: $LOG_LEVELS:<模块名>=<运行期等级>/<编译期等级>,...#, 按 log_module_e 顺序
+ */
+static comms_status_e _cmd_levels(const comms_args_t* args) {
+    (void)args;
+    printf("$LOG_LEVELS:");
+    for(uint8_t i = 0; i < LOG_MOD_COUNT; ++i) {
+        printf("%s%s=%u/%u", i ? "," : "", _mod_name[i], (unsigned)s_log_levels[i], (unsigned)_mod_level[i]);
+    }
+    printf("#");
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $LOG_FLOOD:<行/秒># : 日志压力测试, 0 关闭
+ */
+static comms_status_e _cmd_flood(const comms_args_t* args) {
+    int32_t rate = args->v[0].i;
+    if(rate < 0 || rate > LOG_FLOOD_MAX) return COMMS_ERR_ARG;
+    _flood_period_ms = rate ? 1000u / (uint32_t)rate : 0;
+    _flood_next_ms = _get_ms ? _get_ms() : 0;
+    _flood_n = 0;
+    return COMMS_OK;
+}
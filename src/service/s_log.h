@@ -1,29 +1,155 @@
 /**
  * @file    s_log.h
  * @brief   日志输出服务
+ * @note    默认经 printf 输出 (与命令回复共用 USART1); s_log_init 指定独立串口后改为延迟二进制日志:
+ *          日志调用只把日志点 ID、时间戳与原始参数写入 RAM 环形缓冲区 (不格式化), 由后台任务
+ *          s_log_task 在发送缓冲区有空间时逐条打包为 LOG 帧发出, 缓冲区满时丢弃整条记录并计数;
+ *          LOG_DEFERRED 置 0 时独立串口上仍输出整行文本
+ * @note    LOG 帧 (s_proto_bin 打包, 类型 COMMS_MSG_LOG, 序号逐条递增, 丢弃的记录也占用序号):
+ *          | level(u8) | id(u32) | ms(u32) | 参数... |
+ *          id 为格式字符串的 FNV-1a 散列, 上位机 (tools/logdec.py) 扫描源码中的日志调用生成 ID -> 格式字符串表;
+ *          参数按格式字符串中的转换说明依次存放: 整数/字符/指针 4 字节, 64 位整数 8 字节, 浮点 f32,
+ *          字符串为 u8 长度 + 内容 (最长 LOG_STR_MAX); 超出帧负载的参数不记录
+ * @note    s_log_wave 在独立串口上默认输出二进制 WAVE 帧 (s_proto_bin 打包, 类型 COMMS_MSG_WAVE, 序号逐帧递增,
+ *          负载为小端 f32 × n), 每个数据 4 字节且不做浮点格式化, 与 LOG / 遥测 / 跟踪帧共用同一 COBS 流;
+ *          共用 USART1 时始终输出文本, 以免二进制数据混入命令回复
+ * @note    模块等级: 源文件在包含任何头文件之前定义 LOG_MODULE (如 #define LOG_MODULE FSM), 未定义时为 MISC;
+ *          编译期等级 LOG_LEVEL_<模块> (默认等于 LOG_LEVEL) 以下的调用在预处理阶段展开为空,
+ *          参数不求值, 格式字符串与日志点不进入固件; 编译进固件的调用再按运行期等级 ($LOG_LEVEL#) 过滤,
+ *          过滤在调用处完成, 被屏蔽的调用不压栈可变参数
  */
 #ifndef _s_log_h_
 #define _s_log_h_
 
+#include "usart.h"
+
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdint.h>
 
 // ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
 
 #define LOG_LEVEL_ERROR  1
 #define LOG_LEVEL_WARN   2
 #define LOG_LEVEL_INFO   3
+#define LOG_LEVEL_DEBUG  4
 
-// 日志等级
+// 全局编译期日志等级 (调试版本可用 -DLOG_LEVEL=LOG_LEVEL_DEBUG 整体打开)
 #ifndef LOG_LEVEL
 #define LOG_LEVEL  LOG_LEVEL_INFO
 #endif
 
+/**
+ * @brief   日志模块 (运行期等级的下标), 新增模块时同时添加下方的编译期等级默认值
+ */
+typedef enum {
+    LOG_MOD_MISC = 0,                   // 未定义 LOG_MODULE 的源文件
+    LOG_MOD_BOARD,                      // a_board
+    LOG_MOD_FSM,                        // a_fsm (含升降台控制路径)
+    LOG_MOD_LOG,                        // s_log
+    LOG_MOD_COUNT,
+} log_module_e;
+
+// 各模块编译期等级, 如 -DLOG_LEVEL_FSM=LOG_LEVEL_DEBUG 只打开状态机/升降台控制路径的调试日志
+#ifndef LOG_LEVEL_MISC
+#define LOG_LEVEL_MISC   LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_BOARD
+#define LOG_LEVEL_BOARD  LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_FSM
+#define LOG_LEVEL_FSM    LOG_LEVEL
+#endif
+#ifndef LOG_LEVEL_LOG
+#define LOG_LEVEL_LOG    LOG_LEVEL
+#endif
+
+// 运行期默认等级 (高于编译期等级的部分不起作用)
+#ifndef LOG_RUNTIME_LEVEL
+#define LOG_RUNTIME_LEVEL  LOG_LEVEL_INFO
+#endif
+
+// 当前源文件所属模块
+#ifndef LOG_MODULE
+#define LOG_MODULE  MISC
+#endif
+#define _LOG_CAT(a, b)      a##b
+#define _LOG_XCAT(a, b)     _LOG_CAT(a, b)
+#define LOG_MODULE_ID       _LOG_XCAT(LOG_MOD_, LOG_MODULE)
+#define LOG_MODULE_LEVEL    _LOG_XCAT(LOG_LEVEL_, LOG_MODULE)
+
+// 独立串口上的日志格式: 1 为延迟二进制记录, 0 为整行文本
+#ifndef LOG_DEFERRED
+#define LOG_DEFERRED     1
+#endif
+
+// 波形格式: 文本 "[WAVE] : v1,v2,...\r\n" / 二进制 WAVE 帧 (小端 f32 × n)
+#define LOG_WAVE_TEXT    0
+#define LOG_WAVE_FLOAT   1
+// 默认波形格式 (二进制仅在独立串口上生效, 可由 $WAVE_FMT:<0|1># 切换)
+#ifndef LOG_WAVE_FMT
+#define LOG_WAVE_FMT     LOG_WAVE_FLOAT
+#endif
+// 单帧波形最多通道数 (12 × f32 正好占满 PROTO_BIN_MAX_PAYLOAD)
+#define LOG_WAVE_MAX_CH  12
+
+// 单行最大长度 (含颜色控制符与换行, 超出部分截断)
+#define LOG_LINE_MAX     128
+// 延迟日志环形缓冲区大小 (字节) / 单条记录最多参数个数 / 字符串参数最大长度
+#define LOG_RING_SIZE    1024
+#define LOG_MAX_ARGS     8
+#define LOG_STR_MAX      16
+
+/**
+ * @brief   日志点 (每个日志调用处一个静态实例, 首次调用时由格式字符串计算 ID 与参数类型)
+ */
+typedef struct {
+    uint32_t id;                        // 格式字符串的 FNV-1a 散列
+    uint8_t ready;                      // 已解析
+    uint8_t argc;
+    char types[LOG_MAX_ARGS];           // 'i' 32 位整数, 'l' 64 位整数, 'f' 浮点, 's' 字符串
+} log_site_t;
+
+// 各模块运行期等级, 0 为关闭
+extern uint8_t s_log_levels[LOG_MOD_COUNT];
+
+/**
+ * @brief   日志调用前端: 按运行期等级过滤, 并为每个调用处分配日志点
+ */
+#define S_LOG_SITE(level, ...)  do {                                        \
+        if((level) <= s_log_levels[LOG_MODULE_ID]) {                        \
+            static log_site_t _log_site;                                    \
+            s_log_write(&_log_site, level, __VA_ARGS__);                    \
+        }                                                                   \
+    } while(0)
+
+// 编译期等级以下的调用展开为空 (参数不求值)
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_ERROR
+#define s_log_error(...)  S_LOG_SITE(LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define s_log_error(...)  ((void)0)
+#endif
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_WARN
+#define s_log_warn(...)   S_LOG_SITE(LOG_LEVEL_WARN, __VA_ARGS__)
+#else
+#define s_log_warn(...)   ((void)0)
+#endif
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_INFO
+#define s_log_info(...)   S_LOG_SITE(LOG_LEVEL_INFO, __VA_ARGS__)
+#else
+#define s_log_info(...)   ((void)0)
+#endif
+#if LOG_MODULE_LEVEL >= LOG_LEVEL_DEBUG
+#define s_log_debug(...)  S_LOG_SITE(LOG_LEVEL_DEBUG, __VA_ARGS__)
+#else
+#define s_log_debug(...)  ((void)0)
+#endif
+
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
 
+void s_log_init(usart_t* usart, uint32_t(*get_ms)(void));
+void s_log_task(void);
 void s_log_wave(int count, ...);
-void s_log_info(const char* fmt, ...);
-void s_log_warn(const char* fmt, ...);
-void s_log_error(const char* fmt, ...);
+void s_log_write(log_site_t* site, uint8_t level, const char* fmt, ...);
 
 #endif
@@ -0,0 +1,376 @@
+/**
+ * @file    s_num.c
+ * @brief   轻量数值解析与格式化实现
+ */
+#include "s_num.h"
+
+#include <stdbool.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+// 10^0 ~ 10^10 均可用单精度浮点精确表示
+static const float _pow10f[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f,
+};
+#define POW10F_MAX  10
+
+static const uint32_t _pow10u[] = {
+    1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u,
+};
+
+// 浮点解析保留的最大有效数字位数 (不超过 uint32_t)
+#define F32_MAX_DIGITS  9
+// 单精度浮点的十进制指数范围 (超出即溢出为无穷或下溢为 0)
+#define F32_EXP10_MAX   39
+#define F32_EXP10_MIN   (-46)
+#define F32_MAX         3.40282347e38f
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static const char* _sign(const char* s, bool* neg);
+static bool _is_digit(char c);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   解析十进制整数
+ * @param   s 输入字符串, 格式 [+-]digits
+ * @param   end 输出解析结束位置 (可为 0); 出错时指向 s
+ * @param   out 输出值
+ * @retval  num_err_e 解析结果
+ */
+num_err_e s_num_parse_i32(const char* s, const char** end, int32_t* out) {
+    bool neg;
+    const char* p = _sign(s, &neg);
+    uint32_t limit = neg ? 2147483648u : 2147483647u;
+    uint32_t v = 0;
+
+    if(end) *end = s;
+    if(!_is_digit(*p)) return NUM_ERR_EMPTY;
+    while(_is_digit(*p)) {
+        uint32_t d = (uint32_t)(*p++ - '0');
+        if(v > (limit - d) / 10u) return NUM_ERR_RANGE;
+        v = v * 10u + d;
+    }
+
+    *out = neg ? (int32_t)(0u - v) : (int32_t)v;
+    if(end) *end = p;
+    return NUM_OK;
+}
+
+/**
+ * @brief   解析十进制无符号整数
+ * @param   s 输入字符串, 格式 [+]digits
+ * @param   end 输出解析结束位置 (可为 0); 出错时指向 s
+ * @param   out 输出值
+ * @retval  num_err_e 解析结果
+ */
+num_err_e s_num_parse_u32(const char* s, const char** end, uint32_t* out) {
+    const char* p = (*s == '+') ? s + 1 : s;
+    uint32_t v = 0;
+
+    if(end) *end = s;
+    if(!_is_digit(*p)) return NUM_ERR_EMPTY;
+    while(_is_digit(*p)) {
+        uint32_t d = (uint32_t)(*p++ - '0');
+        if(v > (0xFFFFFFFFu - d) / 10u) return NUM_ERR_RANGE;
+        v = v * 10u + d;
+    }
+
+    *out = v;
+    if(end) *end = p;
+    return NUM_OK;
+}
+
+/**
+ * @brief   解析十进制浮点数
+ * @param   s 输入字符串, 格式 [+-]digits[.digits][(e|E)[+-]digits], 整数与小数部分至少一方非空
+ * @param   end 输出解析结束位置 (可为 0); 出错时指向 s
+ * @param   out 输出值
+ * @retval  num_err_e 解析结果
+ * @note    有效数字累加为整数后一次性乘除 10 的幂, 避免逐位累积舍入误差
+ */
+num_err_e s_num_parse_f32(const char* s, const char** end, float* out) {
+    bool neg;
+    const char* p = _sign(s, &neg);
+    uint32_t mant = 0;
+    uint8_t digits = 0;
+    int32_t exp10 = 0;
+    bool any = false;
+
+    if(end) *end = s;
+
+    // 整数部分: 超出保留位数的数字只计入指数
+    while(_is_digit(*p)) {
+        any = true;
+        if(digits < F32_MAX_DIGITS) {
+            mant = mant * 10u + (uint32_t)(*p - '0');
+            if(mant) digits++;
+        }
+        else {
+            exp10++;
+        }
+        p++;
+    }
+    // 小数部分: 超出保留位数的数字直接丢弃
+    if(*p == '.') {
+        p++;
+        while(_is_digit(*p)) {
+            any = true;
+            if(digits < F32_MAX_DIGITS) {
+                mant = mant * 10u + (uint32_t)(*p - '0');
+                if(mant) digits++;
+                exp10--;
+            }
+            p++;
+        }
+    }
+    if(!any) return NUM_ERR_EMPTY;
+
+    // 指数部分
+    if(*p == 'e' || *p == 'E') {
+        bool eneg;
+        const char* q = _sign(p + 1, &eneg);
+        int32_t e = 0;
+        if(!_is_digit(*q)) return NUM_ERR_SYNTAX;
+        while(_is_digit(*q)) {
+            if(e < 10000) e = e * 10 + (*q - '0');
+            q++;
+        }
+        exp10 += eneg ? -e : e;
+        p = q;
+    }
+
+    // 去掉尾随 0 (如 3638500.000): 保证有效数字不超过 7 位时 (float)mant 无舍入, 只在缩放时舍入一次
+    while(mant && mant % 10u == 0) {
+        mant /= 10u;
+        exp10++;
+    }
+
+    float v = (float)mant;
+    if(mant == 0 || exp10 < F32_EXP10_MIN - F32_MAX_DIGITS) {
+        v = 0.0f;
+    }
+    else if(exp10 > F32_EXP10_MAX) {
+        return NUM_ERR_RANGE;
+    }
+    else {
+        while(exp10 > 0) {
+            int32_t k = exp10 > POW10F_MAX ? POW10F_MAX : exp10;
+            if(v > F32_MAX / _pow10f[k]) return NUM_ERR_RANGE;
+            v *= _pow10f[k];
+            exp10 -= k;
+        }
+        while(exp10 < 0) {
+            int32_t k = -exp10 > POW10F_MAX ? POW10F_MAX : -exp10;
+            v /= _pow10f[k];
+            exp10 += k;
+        }
+    }
+
+    *out = neg ? -v : v;
+    if(end) *end = p;
+    return NUM_OK;
+}
+
+/**
+ * @brief   解析定点数
+ * @param   s 输入字符串, 格式 [+-]digits[.digits]
+ * @param   end 输出解析结束位置 (可为 0); 出错时指向 s
+ * @param   frac_digits 小数位数 (0 ~ 9), 输出值为原值乘以 10^frac_digits
+ * @param   out 输出值; 多余的小数位四舍五入
+ * @retval  num_err_e 解析结果
+ */
+num_err_e s_num_parse_fixed(const char* s, const char** end, uint8_t frac_digits, int32_t* out) {
+    bool neg;
+    const char* p = _sign(s, &neg);
+    uint32_t limit = neg ? 2147483648u : 2147483647u;
+    uint32_t v = 0;
+    uint8_t frac = 0;
+    bool any = false;
+    bool round_up = false;
+
+    if(end) *end = s;
+    if(frac_digits > 9) return NUM_ERR_RANGE;
+
+    while(_is_digit(*p)) {
+        uint32_t d = (uint32_t)(*p++ - '0');
+        any = true;
+        if(v > (limit - d) / 10u) return NUM_ERR_RANGE;
+        v = v * 10u + d;
+    }
+    if(*p == '.') {
+        p++;
+        while(_is_digit(*p)) {
+            uint32_t d = (uint32_t)(*p++ - '0');
+            any = true;
+            if(frac < frac_digits) {
+                if(v > (limit - d) / 10u) return NUM_ERR_RANGE;
+                v = v * 10u + d;
+                frac++;
+            }
+            else if(frac == frac_digits) {
+                round_up = d >= 5;
+                frac++;
+            }
+        }
+    }
+    if(!any) return NUM_ERR_EMPTY;
+
+    // 补齐小数位
+    for(; frac < frac_digits; ++frac) {
+        if(v > limit / 10u) return NUM_ERR_RANGE;
+        v *= 10u;
+    }
+    if(round_up) {
+        if(v >= limit) return NUM_ERR_RANGE;
+        v++;
+    }
+
+    *out = neg ? (int32_t)(0u - v) : (int32_t)v;
+    if(end) *end = p;
+    return NUM_OK;
+}
+
+/**
+ * @brief   格式化无符号整数
+ * @param   buf 输出缓冲区 (至少 11 字节)
+ * @param   v 数值
+ * @retval  uint8_t 输出长度 (不含结尾 '\0')
+ */
+uint8_t s_num_fmt_u32(char* buf, uint32_t v) {
+    char tmp[10];
+    uint8_t n = 0, len = 0;
+
+    do {
+        tmp[n++] = (char)('0' + v % 10u);
+        v /= 10u;
+    } while(v);
+    while(n) buf[len++] = tmp[--n];
+    buf[len] = '\0';
+    return len;
+}
+
+/**
+ * @brief   格式化有符号整数
+ * @param   buf 输出缓冲区 (至少 12 字节)
+ * @param   v 数值
+ * @retval  uint8_t 输出长度 (不含结尾 '\0')
+ */
+uint8_t s_num_fmt_i32(char* buf, int32_t v) {
+    if(v < 0) {
+        buf[0] = '-';
+        return (uint8_t)(1 + s_num_fmt_u32(buf + 1, 0u - (uint32_t)v));
+    }
+    return s_num_fmt_u32(buf, (uint32_t)v);
+}
+
+/**
+ * @brief   以定点形式格式化浮点数 (等价于 printf 的 %.<decimals>f)
+ * @param   buf 输出缓冲区 (建议 NUM_FMT_BUF_SIZE)
+ * @param   v 数值
+ * @param   decimals 小数位数 (0 ~ 9)
+ * @retval  uint8_t 输出长度 (不含结尾 '\0')
+ * @note    按 IEEE 754 位模式拆分整数与小数部分, 以整数运算对精确值做四舍六入五成双, 结果与 printf 一致;
+ *          NaN 输出 "nan", 无穷大或绝对值不小于 2^32 时输出 "inf" / "-inf"
+ */
+uint8_t s_num_fmt_f32(char* buf, float v, uint8_t decimals) {
+    union { float f; uint32_t u; } bits = { .f = v };
+    uint32_t exp = (bits.u >> 23) & 0xFFu;
+    uint32_t mant = bits.u & 0x7FFFFFu;
+    uint8_t len = 0;
+
+    if(exp == 0xFFu && mant) {
+        buf[0] = 'n'; buf[1] = 'a'; buf[2] = 'n'; buf[3] = '\0';
+        return 3;
+    }
+    if(bits.u & 0x80000000u) buf[len++] = '-';
+    // 2^32 对应阶码 127 + 32
+    if(exp >= 127u + 32u) {
+        buf[len++] = 'i'; buf[len++] = 'n'; buf[len++] = 'f';
+        buf[len] = '\0';
+        return len;
+    }
+    if(decimals > 9) decimals = 9;
+
+    // |v| = mant * 2^-shift
+    uint32_t shift;
+    if(exp) {
+        mant |= 0x800000u;
+        shift = 150u - exp;
+    }
+    else {
+        shift = 149u;
+    }
+
+    uint32_t ip, frac_bits;
+    if((int32_t)shift <= 0) {
+        ip = mant << (0u - shift);
+        frac_bits = 0;
+        shift = 0;
+    }
+    else if(shift < 32u) {
+        ip = mant >> shift;
+        frac_bits = mant & ((1u << shift) - 1u);
+    }
+    else {
+        ip = 0;
+        frac_bits = mant;
+    }
+
+    // 小数部分 = frac_bits / 2^shift, 乘以 10^decimals 后舍入
+    uint32_t scale = _pow10u[decimals];
+    uint64_t prod = (uint64_t)frac_bits * scale;
+    uint64_t fp = 0;
+    // prod < 2^54, shift 超过 54 时必然舍去
+    if(shift && shift <= 54u) {
+        uint64_t half = (uint64_t)1 << (shift - 1u);
+        uint64_t rem = prod & ((half << 1) - 1u);
+        fp = prod >> shift;
+        // 恰为一半时向偶数舍入 (0 位小数时末位在整数部分)
+        uint32_t odd = decimals ? (uint32_t)(fp & 1u) : (ip & 1u);
+        if(rem > half || (rem == half && odd)) fp++;
+    }
+    if(fp >= scale) {
+        fp -= scale;
+        if(ip == 0xFFFFFFFFu) {
+            buf[len++] = 'i'; buf[len++] = 'n'; buf[len++] = 'f';
+            buf[len] = '\0';
+            return len;
+        }
+        ip++;
+    }
+
+    len = (uint8_t)(len + s_num_fmt_u32(buf + len, ip));
+    if(decimals) {
+        uint32_t f = (uint32_t)fp;
+        buf[len++] = '.';
+        for(uint8_t k = decimals; k > 0; --k) {
+            buf[len + k - 1] = (char)('0' + f % 10u);
+            f /= 10u;
+        }
+        len = (uint8_t)(len + decimals);
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   跳过可选的正负号
+ * @param   s 输入字符串
+ * @param   neg 输出是否为负
+ * @retval  const char* 符号之后的位置
+ */
+static const char* _sign(const char* s, bool* neg) {
+    *neg = (*s == '-');
+    return (*s == '-' || *s == '+') ? s + 1 : s;
+}
+
+/**
+ * @brief   判断是否为十进制数字 (与区域设置无关)
+ */
+static bool _is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
@@ -0,0 +1,39 @@
+/**
+ * @file    s_num.h
+ * @brief   轻量数值解析与格式化 (替代 sscanf / printf 的 %f)
+ *          与区域设置无关, 不分配内存, 不依赖 C 库的浮点转换
+ * @note    浮点解析: 有效数字不超过 7 位且十进制指数绝对值不超过 10 时 (如 150.5, -1.57, 0.001)
+ *          结果与 strtof 完全一致; 其余情况 (float)mant 与按 1e10f 分段缩放各舍入一次,
+ *          误差不超过数个 ulp (tests/test_num.c 实测不超过 3)
+ */
+#ifndef _s_num_h_
+#define _s_num_h_
+
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 格式化输出缓冲区的建议大小 (含结尾 '\0')
+#define NUM_FMT_BUF_SIZE    32
+
+/**
+ * @brief 解析结果
+ */
+typedef enum {
+    NUM_OK = 0,
+    NUM_ERR_EMPTY,      // 没有数字
+    NUM_ERR_SYNTAX,     // 格式错误 (如指数部分缺少数字)
+    NUM_ERR_RANGE,      // 超出目标类型范围
+} num_err_e;
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+num_err_e s_num_parse_i32(const char* s, const char** end, int32_t* out);
+num_err_e s_num_parse_u32(const char* s, const char** end, uint32_t* out);
+num_err_e s_num_parse_f32(const char* s, const char** end, float* out);
+num_err_e s_num_parse_fixed(const char* s, const char** end, uint8_t frac_digits, int32_t* out);
+uint8_t s_num_fmt_u32(char* buf, uint32_t v);
+uint8_t s_num_fmt_i32(char* buf, int32_t v);
+uint8_t s_num_fmt_f32(char* buf, float v, uint8_t decimals);
+
+#endif
@@ -3,6 +3,7 @@
  * @brief   PID 控制器实现
  */
 #include "s_pid.h"
+#include "s_prof.h"
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
@@ -67,6 +68,12 @@ static void _init(PID* pid, uint8_t mode, uint8_t features) {
     pid->integral_ = 0.0f;
     pid->prev_err_ = 0.0f;
 
+    pid->target_ = 0.0f;
+    pid->actual_ = 0.0f;
+    pid->p_out_ = 0.0f;
+    pid->i_out_ = 0.0f;
+    pid->d_out_ = 0.0f;
+
     pid->_filtered_diff_ = 0.0f;
     pid->_prev_output_ = 0.0f;
     pid->_prev_measurement_ = 0.0f;
@@ -126,6 +133,7 @@ static void _set_feedforward(PID* pid, float ff_value) {
  * @return  PID 输出值
  */
 float _calculate(PID* pid, float target, float actual, float dt_s) {
+    PROF_BEGIN(PID_CALC);
     float err = target - actual;
     uint8_t feat = pid->features_;
     uint8_t mode = pid->mode_;
@@ -137,9 +145,16 @@ float _calculate(PID* pid, float target, float actual, float dt_s) {
 
     float out = 0.0f;
 
+    pid->target_ = target;
+    pid->actual_ = actual;
+    pid->p_out_ = 0.0f;
+    pid->i_out_ = 0.0f;
+    pid->d_out_ = 0.0f;
+
     /* 比例项 */
     if(mode & PID_MODE_P) {
-        out += pid->kp_ * err;
+        pid->p_out_ = pid->kp_ * err;
+        out += pid->p_out_;
     }
 
     /* 积分项 */
@@ -165,7 +180,8 @@ float _calculate(PID* pid, float target, float actual, float dt_s) {
         }
 
         if(!allow_separation) {
-            out += pid->ki_ * pid->integral_;
+            pid->i_out_ = pid->ki_ * pid->integral_;
+            out += pid->i_out_;
         }
     }
 
@@ -190,7 +206,8 @@ float _calculate(PID* pid, float target, float actual, float dt_s) {
             pid->_filtered_diff_ = diff;
         }
 
-        out += pid->kd_ * diff;
+        pid->d_out_ = pid->kd_ * diff;
+        out += pid->d_out_;
     }
 
     /* 前馈 */
@@ -228,6 +245,7 @@ float _calculate(PID* pid, float target, float actual, float dt_s) {
 
     pid->output_ = out;
     pid->_prev_output_ = out;
+    PROF_END(PID_CALC);
 
     return out;
 }
@@ -239,6 +257,9 @@ void _reset(PID* pid) {
     pid->output_ = 0.0f;
     pid->integral_ = 0.0f;
     pid->prev_err_ = 0.0f;
+    pid->p_out_ = 0.0f;
+    pid->i_out_ = 0.0f;
+    pid->d_out_ = 0.0f;
     pid->_filtered_diff_ = 0.0f;
     pid->_prev_output_ = 0.0f;
     pid->_prev_measurement_ = 0.0f;
@@ -93,6 +93,12 @@ struct PID {
     float integral_;                // 积分累积值
     float prev_err_;                // 上一次误差
 
+    float target_;                  // 最近一次计算的目标值
+    float actual_;                  // 最近一次计算的测量值
+    float p_out_;                   // 比例项贡献
+    float i_out_;                   // 积分项贡献
+    float d_out_;                   // 微分项贡献
+
     /**
      * @brief   构造函数 (初始化函数指针)
      * @param   pid     PID 实例指针
@@ -0,0 +1,151 @@
+/**
+ * @file    s_pid_tuner.c
+ * @brief   PID 在线调参服务实现
+ */
+#include "s_pid_tuner.h"
+#include "s_num.h"
+#include "s_proto_bin.h"
+#include "s_wireless_comms.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+typedef struct {
+    PID* pid;
+    const char* name;
+} pid_slot_t;
+
+static usart_t* _usart;
+static uint32_t(*_get_ms)(void);
+
+static pid_slot_t _slots[PID_TUNER_MAX];
+static uint8_t _count = 0;
+static uint8_t _stream_mask = 0;
+static uint8_t _seq = 0;
+static uint32_t _dropped = 0;
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static void _send_frame(uint8_t id);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   PID 调参服务初始化
+ * @param   usart 流式数据输出串口 (日志通道, 需启用 TX 中断)
+ * @param   get_ms 获取当前毫秒数的函数指针, 用于帧时间戳
+ */
+void s_pid_tuner_init(usart_t* usart, uint32_t(*get_ms)(void)) {
+    _usart = usart;
+    _get_ms = get_ms;
+    _count = 0;
+    _stream_mask = 0;
+    _seq = 0;
+    _dropped = 0;
+}
+
+/**
+ * @brief   注册 PID 实例
+ * @param   pid PID 实例指针
+ * @param   name 实例名称 (需为常量字符串)
+ * @retval  int 实例 ID, -1 表示注册表已满
+ */
+int s_pid_tuner_register(PID* pid, const char* name) {
+    if(_count >= PID_TUNER_MAX) return -1;
+    _slots[_count].pid = pid;
+    _slots[_count].name = name;
+    return _count++;
+}
+
+/**
+ * @brief   按 ID 获取 PID 实例
+ * @param   id 实例 ID
+ * @retval  PID* 实例指针, ID 无效时为 0
+ */
+PID* s_pid_tuner_get(uint8_t id) {
+    return (id < _count) ? _slots[id].pid : 0;
+}
+
+/**
+ * @brief   开启/关闭指定实例的流式输出
+ * @param   id 实例 ID
+ * @param   enable true:开启, false:关闭
+ * @retval  bool - true:成功, false:ID 无效
+ */
+bool s_pid_tuner_set_stream(uint8_t id, bool enable) {
+    if(id >= _count) return false;
+    if(enable)
+        _stream_mask |= (uint8_t)(1u << id);
+    else
+        _stream_mask &= (uint8_t)~(1u << id);
+    return true;
+}
+
+/**
+ * @brief   以 ASCII 帧回复指定实例的全部参数
+ * @param   id 实例 ID
+ * @note    格式: $PID:<id>,<name>,<mode>,<features>,<kp>,<ki>,<kd>,
+ *                <max_out>,<integral_separation>,<dead_band>,<diff_filter_alpha>,<output_max_rate>,<dropped>#
+ */
+void s_pid_tuner_report(uint8_t id) {
+    if(id >= _count) {
+        printf("$PID:ERR#");
+        return;
+    }
+    const PID* pid = _slots[id].pid;
+    const float values[] = {
+        pid->kp_, pid->ki_, pid->kd_,
+        pid->max_out_, pid->integral_separation_, pid->dead_band_,
+        pid->diff_filter_alpha_, pid->output_max_rate_,
+    };
+    char num[NUM_FMT_BUF_SIZE];
+
+    printf("$PID:%u,%s,%u,%u", id, _slots[id].name, pid->mode_, pid->features_);
+    for(uint8_t k = 0; k < sizeof(values) / sizeof(values[0]); ++k) {
+        s_num_fmt_f32(num, values[k], 6);
+        printf(",%s", num);
+    }
+    printf(",%lu#", (unsigned long)_dropped);
+}
+
+/**
+ * @brief   输出所有已开启实例的流式数据帧
+ * @note    在每个控制周期 PID 计算之后调用; 帧写入发送缓冲区, 空间不足时丢弃并计数
+ */
+void s_pid_tuner_stream(void) {
+    if(!_stream_mask || !_usart) return;
+    for(uint8_t id = 0; id < _count; ++id) {
+        if(_stream_mask & (1u << id)) {
+            _send_frame(id);
+        }
+    }
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   打包并发送单个实例的流式数据帧
+ * @param   id 实例 ID
+ */
+static void _send_frame(uint8_t id) {
+    const PID* pid = _slots[id].pid;
+    uint8_t payload[PID_TUNER_PAYLOAD_LEN];
+    uint8_t out[PROTO_BIN_MAX_ENCODED];
+    uint32_t tick = _get_ms ? _get_ms() : 0;
+    const float values[6] = {
+        pid->target_, pid->actual_,
+        pid->p_out_, pid->i_out_, pid->d_out_,
+        pid->output_,
+    };
+
+    payload[0] = id;
+    memcpy(&payload[1], &tick, sizeof(tick));
+    memcpy(&payload[5], values, sizeof(values));
+
+    uint16_t n = s_proto_bin_encode(COMMS_MSG_PID_SAMPLE, _seq++, payload, sizeof(payload), out, sizeof(out));
+    if(!n || !usart_write(_usart, out, n)) {
+        _dropped++;
+    }
+}
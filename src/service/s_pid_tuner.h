@@ -0,0 +1,36 @@
+/**
+ * @file    s_pid_tuner.h
+ * @brief   PID 在线调参服务
+ *          运行时读写已注册 PID 实例的增益/参数, 并按控制周期流式输出各项贡献
+ * @note    流式数据以 s_proto_bin 帧 (类型 COMMS_MSG_PID_SAMPLE) 在日志通道发送,
+ *          与遥测/日志/跟踪帧共用同一 COBS 流; 负载 (小端, 共 PID_TUNER_PAYLOAD_LEN 字节):
+ *          | id(u8) | tick_ms(u32) | target | actual | p_out | i_out | d_out | output | (f32 x 6)
+ *          序号逐帧递增, 上位机据此统计丢帧
+ */
+#ifndef _s_pid_tuner_h_
+#define _s_pid_tuner_h_
+
+#include "usart.h"
+#include "s_pid.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 最多可注册的 PID 实例数
+#define PID_TUNER_MAX           4
+
+// 流式数据帧负载长度
+#define PID_TUNER_PAYLOAD_LEN   29
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_pid_tuner_init(usart_t* usart, uint32_t(*get_ms)(void));
+int s_pid_tuner_register(PID* pid, const char* name);
+PID* s_pid_tuner_get(uint8_t id);
+bool s_pid_tuner_set_stream(uint8_t id, bool enable);
+void s_pid_tuner_report(uint8_t id);
+void s_pid_tuner_stream(void);
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file    s_prof.c
+ * @brief   DWT 周期剖析服务实现
+ */
+#include "s_prof.h"
+#include "s_wireless_comms.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+// 探针名 (与 prof_id_e 对应)
+static const char* const _name[PROF_COUNT] = {
+    "PID_CALC", "COMMS_EXEC", "CAN_SEND", "ISR_USART1", "ISR_USART2", "ISR_CAN_RX", "ISR_SYSTICK"
+};
+
+#if PROF_ENABLE
+static prof_stat_t _stat[PROF_COUNT];
+static uint32_t _overhead = 0;              // 空探针测得的周期数, 从每次采样中扣除
+#endif
+
+static comms_status_e _cmd_report(const comms_args_t* args);
+static comms_status_e _cmd_clear(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "PROF",           "",     _cmd_report,    0,  COMMS_DONE_NONE },
+    { "PROF_CLR",       "",     _cmd_clear,     0,  COMMS_DONE_NONE },
+};
+#define PROF_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化剖析服务: 测量探针自身开销, 清零统计并注册串口命令
+ * @note    需在 dwt_init 与 s_wireless_comms_init 之后调用
+ */
+void s_prof_init(void) {
+#if PROF_ENABLE
+    _overhead = 0xFFFFFFFFu;
+    for(uint8_t i = 0; i < 8; ++i) {
+        uint32_t start = DWT->CYCCNT;
+        uint32_t cyc = DWT->CYCCNT - start;
+        if(cyc < _overhead) _overhead = cyc;
+    }
+    s_prof_reset();
+#endif
+    s_wireless_comms_register(_cmds, PROF_CMD_COUNT);
+}
+
+/**
+ * @brief   记录一次采样 (由 PROF_END 调用)
+ * @param   id 探针 (prof_id_e)
+ * @param   cyc 探针首尾之间的周期数
+ * @note    可在中断中调用; 同一探针不可同时在主循环与中断中使用
+ */
+void s_prof_add(uint8_t id, uint32_t cyc) {
+#if PROF_ENABLE
+    prof_stat_t* s = &_stat[id];
+    uint32_t bin;
+
+    cyc = cyc > _overhead ? cyc - _overhead : 0;
+    bin = 32u - __CLZ(cyc);
+    if(bin >= PROF_HIST_BINS) bin = PROF_HIST_BINS - 1;
+
+    if(s->n == 0 || cyc < s->min) s->min = cyc;
+    if(cyc > s->max) s->max = cyc;
+    s->n++;
+    s->sum += cyc;
+    s->hist[bin]++;
+#else
+    (void)id;
+    (void)cyc;
+#endif
+}
+
+/**
+ * @brief   清零全部统计
+ * @note    关中断清零, 中断中的探针不会留下半条采样
+ */
+void s_prof_reset(void) {
+#if PROF_ENABLE
+    __disable_irq();
+    memset(_stat, 0, sizeof(_stat));
+    __enable_irq();
+#endif
+}
+
+/**
+ * @brief   输出统计表
+ * @note    先回复 $PROF_INFO:<CPU MHz>,<探针开销周期>,<直方图桶数>#,
+ *          再为每个探针回复 $PROF:<名称>,<次数>,<最小>,<平均>,<最大>,<PROF_HIST_BINS 个桶>#  (单位: 周期);
+ *          每个探针先关中断复制一份再输出, 各项统计彼此一致
+ */
+void s_prof_report(void) {
+#if PROF_ENABLE
+    printf("$PROF_INFO:%u,%lu,%u#", (unsigned)CPU_FREQ_MHZ, (unsigned long)_overhead, (unsigned)PROF_HIST_BINS);
+    for(uint8_t i = 0; i < PROF_COUNT; ++i) {
+        prof_stat_t s;
+        __disable_irq();
+        s = _stat[i];
+        __enable_irq();
+
+        uint32_t avg = s.n ? (uint32_t)(s.sum / s.n) : 0;
+        printf("$PROF:%s,%lu,%lu,%lu,%lu", _name[i], (unsigned long)s.n, (unsigned long)s.min,
+            (unsigned long)avg, (unsigned long)s.max);
+        for(uint8_t k = 0; k < PROF_HIST_BINS; ++k) {
+            printf(",%lu", (unsigned long)s.hist[k]);
+        }
+        printf("#");
+    }
+#else
+    (void)_name;
+    printf("$PROF:OFF#");
+#endif
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   $PROF# : 输出统计表 (格式见 s_prof_report)
+ */
+static comms_status_e _cmd_report(const comms_args_t* args) {
+    (void)args;
+    s_prof_report();
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $PROF_CLR# : 清零统计
+ */
+static comms_status_e _cmd_clear(const comms_args_t* args) {
+    (void)args;
+    s_prof_reset();
+    return COMMS_OK;
+}
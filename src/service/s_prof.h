@@ -0,0 +1,67 @@
+/**
+ * @file    s_prof.h
+ * @brief   DWT 周期剖析服务
+ *          在代码段首尾放置命名探针 (PROF_BEGIN / PROF_END), 按探针累计执行次数、最小 / 平均 / 最大周期数
+ *          与对数刻度直方图, $PROF# 输出整张表, 用于性能改动前后的对比
+ * @note    PROF_ENABLE 为 0 时探针展开为空, 统计表与命令处理全部编译移除 ($PROF# 回复 $PROF:OFF#);
+ *          开启时每个探针为两次 CYCCNT 读取与一次 s_prof_add 调用
+ * @note    每个探针只在一个执行上下文中使用 (主循环或某一个中断), 写入无需加锁;
+ *          测得的周期包含期间抢占的更高优先级中断
+ */
+#ifndef _s_prof_h_
+#define _s_prof_h_
+
+#include "dwt.h"
+
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE         1
+#endif
+
+// 直方图桶数: 桶 0 为 0 周期, 桶 k 为 [2^(k-1), 2^k) 周期, 最后一桶含更长的耗时 (>= 2^22 周期, 约 58 ms)
+#define PROF_HIST_BINS      24
+
+/**
+ * @brief   探针 (名称见 s_prof.c)
+ */
+typedef enum {
+    PROF_PID_CALC = 0,      // s_pid 计算一次输出
+    PROF_COMMS_EXEC,        // 命令执行 (处理函数或内置命令, 不含回复)
+    PROF_CAN_SEND,          // can_send (含等待发送完成与 1 ms 帧间隔)
+    PROF_ISR_USART1,        // USART1 中断 (命令串口, 含急停识别)
+    PROF_ISR_USART2,        // USART2 中断 (日志通道发送)
+    PROF_ISR_CAN_RX,        // CAN RX0 中断
+    PROF_ISR_SYSTICK,       // SysTick 中断
+    PROF_COUNT
+} prof_id_e;
+
+/**
+ * @brief   单个探针的统计
+ */
+typedef struct {
+    uint32_t n;             // 执行次数
+    uint32_t min;           // 耗时 (周期, 已扣除探针自身开销)
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROF_HIST_BINS];
+} prof_stat_t;
+
+#if PROF_ENABLE
+#define PROF_BEGIN(id)      uint32_t _prof_start_##id = DWT->CYCCNT
+#define PROF_END(id)        s_prof_add(PROF_##id, DWT->CYCCNT - _prof_start_##id)
+#else
+#define PROF_BEGIN(id)      ((void)0)
+#define PROF_END(id)        ((void)0)
+#endif
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_prof_init(void);
+void s_prof_add(uint8_t id, uint32_t cyc);
+void s_prof_reset(void);
+void s_prof_report(void);
+
+#endif
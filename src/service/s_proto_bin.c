@@ -0,0 +1,151 @@
+/**
+ * @file    s_proto_bin.c
+ * @brief   二进制帧协议编解码实现
+ */
+#include "s_proto_bin.h"
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define PROTO_BIN_CRC_INIT  0xFFFFu
+#define PROTO_BIN_CRC_POLY  0x1021u
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static proto_bin_result_e _finish(proto_bin_dec_t* dec, proto_bin_frame_t* out);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   计算 CRC-16/CCITT-FALSE
+ * @param   data 数据
+ * @param   len 数据长度
+ * @param   crc 初值 (首段传 0xFFFF, 分段计算时传上一段结果)
+ * @retval  uint16_t CRC 值
+ */
+uint16_t s_proto_bin_crc16(const uint8_t* data, uint16_t len, uint16_t crc) {
+    while(len--) {
+        crc ^= (uint16_t)(*data++) << 8;
+        for(uint8_t i = 0; i < 8; ++i) {
+            crc = (crc & 0x8000u) ? (uint16_t)((crc << 1) ^ PROTO_BIN_CRC_POLY) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+/**
+ * @brief   复位解码器, 丢弃未完成的帧
+ * @param   dec 解码器
+ */
+void s_proto_bin_dec_reset(proto_bin_dec_t* dec) {
+    dec->len = 0;
+    dec->code = 0;
+    dec->remain = 0;
+    dec->overflow = false;
+}
+
+/**
+ * @brief   向解码器输入一个字节 (COBS 流式解码)
+ * @param   dec 解码器
+ * @param   byte 接收到的字节
+ * @param   out 收到完整帧时输出帧内容
+ * @retval  proto_bin_result_e 解码结果; 返回 PENDING 以外的结果后解码器自动复位
+ */
+proto_bin_result_e s_proto_bin_dec_feed(proto_bin_dec_t* dec, uint8_t byte, proto_bin_frame_t* out) {
+    if(byte == PROTO_BIN_DELIM) {
+        proto_bin_result_e res = _finish(dec, out);
+        s_proto_bin_dec_reset(dec);
+        return res;
+    }
+    if(dec->overflow) return PROTO_BIN_PENDING;
+
+    if(dec->remain == 0) {
+        // 新块: 上一块码小于 0xFF 时块尾隐含一个 0x00
+        if(dec->code && dec->code != 0xFF) {
+            if(dec->len >= PROTO_BIN_MAX_FRAME) {
+                dec->overflow = true;
+                return PROTO_BIN_PENDING;
+            }
+            dec->buf[dec->len++] = 0x00;
+        }
+        dec->code = byte;
+        dec->remain = (uint8_t)(byte - 1);
+        return PROTO_BIN_PENDING;
+    }
+
+    if(dec->len >= PROTO_BIN_MAX_FRAME) {
+        dec->overflow = true;
+        return PROTO_BIN_PENDING;
+    }
+    dec->buf[dec->len++] = byte;
+    dec->remain--;
+    return PROTO_BIN_PENDING;
+}
+
+/**
+ * @brief   打包并 COBS 编码一帧 (含前后定界符)
+ * @param   type 消息类型
+ * @param   seq 序号
+ * @param   payload 负载 (len 为 0 时可为 0)
+ * @param   len 负载长度, 不超过 PROTO_BIN_MAX_PAYLOAD
+ * @param   out 输出缓冲区
+ * @param   out_size 输出缓冲区大小, 建议 PROTO_BIN_MAX_ENCODED
+ * @retval  uint16_t 编码后长度, 0 表示参数无效或缓冲区不足
+ */
+uint16_t s_proto_bin_encode(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len, uint8_t* out, uint16_t out_size) {
+    if(len > PROTO_BIN_MAX_PAYLOAD || out_size < (uint16_t)(len + 4 + len / 254 + 3)) return 0;
+
+    uint8_t raw[PROTO_BIN_MAX_FRAME];
+    uint8_t n = 0;
+    raw[n++] = type;
+    raw[n++] = seq;
+    for(uint8_t i = 0; i < len; ++i) raw[n++] = payload[i];
+    uint16_t crc = s_proto_bin_crc16(raw, n, PROTO_BIN_CRC_INIT);
+    raw[n++] = (uint8_t)(crc & 0xFF);
+    raw[n++] = (uint8_t)(crc >> 8);
+
+    uint16_t w = 0;
+    out[w++] = PROTO_BIN_DELIM;
+    uint16_t code_pos = w++;
+    uint8_t code = 1;
+    for(uint8_t i = 0; i < n; ++i) {
+        if(raw[i] == 0x00) {
+            out[code_pos] = code;
+            code_pos = w++;
+            code = 1;
+        }
+        else {
+            out[w++] = raw[i];
+            if(++code == 0xFF) {
+                out[code_pos] = code;
+                code_pos = w++;
+                code = 1;
+            }
+        }
+    }
+    out[code_pos] = code;
+    out[w++] = PROTO_BIN_DELIM;
+    return w;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   收到定界符: 校验并输出整帧
+ * @param   dec 解码器
+ * @param   out 输出帧
+ * @retval  proto_bin_result_e 解码结果
+ */
+static proto_bin_result_e _finish(proto_bin_dec_t* dec, proto_bin_frame_t* out) {
+    if(dec->code == 0 && dec->len == 0) return PROTO_BIN_EMPTY;
+    if(dec->overflow || dec->remain != 0 || dec->len < 4) return PROTO_BIN_ERR_FRAME;
+
+    uint8_t n = (uint8_t)(dec->len - 2);
+    uint16_t crc = (uint16_t)(dec->buf[n] | ((uint16_t)dec->buf[n + 1] << 8));
+    if(s_proto_bin_crc16(dec->buf, n, PROTO_BIN_CRC_INIT) != crc) return PROTO_BIN_ERR_CRC;
+
+    out->type = dec->buf[0];
+    out->seq = dec->buf[1];
+    out->payload = &dec->buf[2];
+    out->len = (uint8_t)(n - 2);
+    return PROTO_BIN_FRAME;
+}
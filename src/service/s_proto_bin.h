@@ -0,0 +1,65 @@
+/**
+ * @file    s_proto_bin.h
+ * @brief   二进制帧协议编解码 (与硬件无关)
+ *          帧格式 (COBS 编码前): [type:u8][seq:u8][payload:0~PROTO_BIN_MAX_PAYLOAD][crc16:u16 LE]
+ *          COBS 编码后以 0x00 作为帧定界符, 发送方在帧前后各发送一个 0x00
+ * @note    CRC-16/CCITT-FALSE (多项式 0x1021, 初值 0xFFFF), 覆盖 type + seq + payload;
+ *          所有多字节字段均为小端序, 浮点数为 IEEE-754 单精度
+ */
+#ifndef _s_proto_bin_h_
+#define _s_proto_bin_h_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 帧定界符
+#define PROTO_BIN_DELIM         0x00
+// 最大负载长度 (字节)
+#define PROTO_BIN_MAX_PAYLOAD   48
+// 解码后最大帧长: type + seq + payload + crc
+#define PROTO_BIN_MAX_FRAME     (PROTO_BIN_MAX_PAYLOAD + 4)
+// COBS 编码后 (含前后定界符) 的最大长度
+#define PROTO_BIN_MAX_ENCODED   (PROTO_BIN_MAX_FRAME + PROTO_BIN_MAX_FRAME / 254 + 3)
+
+/**
+ * @brief 解码结果
+ */
+typedef enum {
+    PROTO_BIN_PENDING = 0,  // 帧未结束
+    PROTO_BIN_FRAME,        // 收到完整且校验通过的帧
+    PROTO_BIN_EMPTY,        // 连续定界符 (空帧), 忽略
+    PROTO_BIN_ERR_FRAME,    // COBS 结构错误 / 过长 / 过短
+    PROTO_BIN_ERR_CRC,      // CRC 校验失败
+} proto_bin_result_e;
+
+/**
+ * @brief 流式解码器
+ */
+typedef struct {
+    uint8_t buf[PROTO_BIN_MAX_FRAME];
+    uint8_t len;            // 已解码字节数
+    uint8_t code;           // 当前 COBS 块的块码
+    uint8_t remain;         // 当前块剩余的数据字节数
+    bool overflow;          // 本帧已超长, 等待定界符后丢弃
+} proto_bin_dec_t;
+
+/**
+ * @brief 已解码的帧 (指向解码器缓冲区, 下一次 feed 前有效)
+ */
+typedef struct {
+    uint8_t type;
+    uint8_t seq;
+    const uint8_t* payload;
+    uint8_t len;
+} proto_bin_frame_t;
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+uint16_t s_proto_bin_crc16(const uint8_t* data, uint16_t len, uint16_t crc);
+void s_proto_bin_dec_reset(proto_bin_dec_t* dec);
+proto_bin_result_e s_proto_bin_dec_feed(proto_bin_dec_t* dec, uint8_t byte, proto_bin_frame_t* out);
+uint16_t s_proto_bin_encode(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len, uint8_t* out, uint16_t out_size);
+
+#endif
@@ -0,0 +1,158 @@
+/**
+ * @file    s_sched.c
+ * @brief   静态协作式多速率任务调度器实现
+ */
+#include "s_sched.h"
+
+#include <stdio.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+static const sched_task_cfg_t* _table = 0;
+static uint8_t _count = 0;
+static uint32_t(*_get_ms)(void);
+static uint32_t(*_get_cycles)(void);
+static sched_fn_t _idle = 0;
+
+static uint32_t _next[SCHED_MAX_TASKS];     // 下一次释放时刻 (ms)
+static sched_stat_t _stats[SCHED_MAX_TASKS];
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static void _run_task(uint8_t idx);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   调度器初始化
+ * @param   table 任务表 (需为静态存储), 表中顺序即同时就绪时的运行顺序
+ * @param   count 任务数, 超过 SCHED_MAX_TASKS 的部分忽略
+ * @param   get_ms 获取当前毫秒数的函数指针
+ * @param   get_cycles 获取 CPU 周期计数的函数指针, 用于执行耗时统计
+ */
+void s_sched_init(const sched_task_cfg_t* table, uint8_t count, uint32_t(*get_ms)(void), uint32_t(*get_cycles)(void)) {
+    _table = table;
+    _count = count > SCHED_MAX_TASKS ? SCHED_MAX_TASKS : count;
+    _get_ms = get_ms;
+    _get_cycles = get_cycles;
+
+    uint32_t now = _get_ms();
+    for(uint8_t i = 0; i < _count; ++i) {
+        _next[i] = now + _table[i].offset_ms;
+    }
+    s_sched_reset_stats();
+}
+
+/**
+ * @brief   设置空闲钩子
+ * @param   idle 每轮调度结束时调用 (如进入低功耗), 需自行确认 s_sched_pending() 为 false 才可休眠
+ */
+void s_sched_set_idle(sched_fn_t idle) {
+    _idle = idle;
+}
+
+/**
+ * @brief   运行一轮调度
+ * @note    依次运行后台任务与所有已到释放时刻的周期任务, 最后调用空闲钩子
+ */
+void s_sched_run(void) {
+    uint32_t now = _get_ms();
+
+    for(uint8_t i = 0; i < _count; ++i) {
+        const sched_task_cfg_t* cfg = &_table[i];
+        if(cfg->period_ms == 0) {
+            _run_task(i);
+            continue;
+        }
+        if((int32_t)(now - _next[i]) < 0) continue;
+
+        uint32_t release = _next[i];
+        sched_stat_t* st = &_stats[i];
+        if(now - release > st->late_max) st->late_max = now - release;
+
+        _run_task(i);
+
+        // 截止期检查: 运行结束时刻相对释放时刻
+        uint32_t end = _get_ms();
+        uint32_t deadline = cfg->deadline_ms ? cfg->deadline_ms : cfg->period_ms;
+        if(end - release > deadline) st->misses++;
+
+        // 按固定网格释放, 已错过的释放点直接跳过
+        _next[i] = release + cfg->period_ms;
+        if((int32_t)(end - _next[i]) >= 0) {
+            _next[i] += ((end - _next[i]) / cfg->period_ms + 1) * cfg->period_ms;
+        }
+        now = end;
+    }
+
+    if(_idle) _idle();
+}
+
+/**
+ * @brief   判断是否有已到释放时刻的周期任务
+ * @retval  bool - true:有任务待运行, false:无
+ * @note    可在关中断时调用
+ */
+bool s_sched_pending(void) {
+    uint32_t now = _get_ms();
+    for(uint8_t i = 0; i < _count; ++i) {
+        if(_table[i].period_ms && (int32_t)(now - _next[i]) >= 0) return true;
+    }
+    return false;
+}
+
+/**
+ * @brief   获取任务运行统计
+ * @param   idx 任务在任务表中的下标
+ * @retval  const sched_stat_t* 统计数据, 下标无效时为 0
+ */
+const sched_stat_t* s_sched_get_stat(uint8_t idx) {
+    return idx < _count ? &_stats[idx] : 0;
+}
+
+/**
+ * @brief   清零所有任务的运行统计
+ */
+void s_sched_reset_stats(void) {
+    for(uint8_t i = 0; i < SCHED_MAX_TASKS; ++i) {
+        _stats[i].runs = 0;
+        _stats[i].misses = 0;
+        _stats[i].exec_min = 0;
+        _stats[i].exec_max = 0;
+        _stats[i].exec_sum = 0;
+        _stats[i].late_max = 0;
+    }
+}
+
+/**
+ * @brief   输出所有任务的运行统计
+ * @note    每个任务一条: $TASK:<名称>,<周期 ms>,<运行次数>,<截止期丢失>,<最大释放延迟 ms>,<执行最小/平均/最大周期>#
+ */
+void s_sched_report(void) {
+    for(uint8_t i = 0; i < _count; ++i) {
+        const sched_stat_t* st = &_stats[i];
+        uint32_t avg = st->runs ? (uint32_t)(st->exec_sum / st->runs) : 0;
+        printf("$TASK:%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu#",
+            _table[i].name, (unsigned long)_table[i].period_ms,
+            (unsigned long)st->runs, (unsigned long)st->misses, (unsigned long)st->late_max,
+            (unsigned long)st->exec_min, (unsigned long)avg, (unsigned long)st->exec_max);
+    }
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   运行单个任务并统计执行耗时
+ * @param   idx 任务下标
+ */
+static void _run_task(uint8_t idx) {
+    sched_stat_t* st = &_stats[idx];
+    uint32_t start = _get_cycles();
+    _table[idx].fn();
+    uint32_t cyc = _get_cycles() - start;
+
+    if(st->runs == 0 || cyc < st->exec_min) st->exec_min = cyc;
+    if(cyc > st->exec_max) st->exec_max = cyc;
+    st->exec_sum += cyc;
+    st->runs++;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file    s_sched.h
+ * @brief   静态协作式多速率任务调度器
+ *          任务表在编译期声明, 按周期 (速率组) 释放, 在主循环中逐个运行至完成
+ * @note    周期为 0 的任务为后台任务, 每轮主循环都运行; 周期任务按固定时间网格释放,
+ *          运行结束晚于截止时间 (默认等于周期) 计为一次截止期丢失, 并跳过已错过的释放点
+ */
+#ifndef _s_sched_h_
+#define _s_sched_h_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 最大任务数
+#define SCHED_MAX_TASKS     8
+
+/**
+ * @brief 任务函数
+ */
+typedef void(*sched_fn_t)(void);
+
+/**
+ * @brief 任务配置表
+ */
+typedef struct {
+    const char* name;       // 任务名称
+    sched_fn_t fn;          // 任务函数, 需运行至完成且不可阻塞
+    uint32_t period_ms;     // 释放周期 (ms), 0 为后台任务
+    uint32_t offset_ms;     // 首次释放相对启动的偏移 (ms), 用于错开同周期任务
+    uint32_t deadline_ms;   // 相对释放时刻的截止时间 (ms), 0 表示等于周期
+} sched_task_cfg_t;
+
+/**
+ * @brief 任务运行统计
+ */
+typedef struct {
+    uint32_t runs;          // 运行次数
+    uint32_t misses;        // 截止期丢失次数
+    uint32_t exec_min;      // 单次执行耗时 (周期)
+    uint32_t exec_max;
+    uint64_t exec_sum;
+    uint32_t late_max;      // 最大释放延迟 (ms)
+} sched_stat_t;
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_sched_init(const sched_task_cfg_t* table, uint8_t count, uint32_t(*get_ms)(void), uint32_t(*get_cycles)(void));
+void s_sched_set_idle(sched_fn_t idle);
+void s_sched_run(void);
+bool s_sched_pending(void);
+const sched_stat_t* s_sched_get_stat(uint8_t idx);
+void s_sched_reset_stats(void);
+void s_sched_report(void);
+
+#endif
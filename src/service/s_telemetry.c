@@ -0,0 +1,136 @@
+/**
+ * @file    s_telemetry.c
+ * @brief   遥测服务实现
+ */
+#include "s_telemetry.h"
+#include "s_proto_bin.h"
+#include "s_wireless_comms.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+static usart_t* _usart = 0;
+static uint32_t(*_get_ms)(void) = 0;
+static telemetry_sample_fn_t _sample = 0;
+
+static uint16_t _rate_hz = 0;
+static uint32_t _period_ms = 0;
+static uint32_t _next_ms = 0;
+static uint8_t _seq = 0;
+static uint32_t _sent = 0;
+static uint32_t _dropped = 0;
+
+static comms_status_e _cmd_rate(const comms_args_t* args);
+static comms_status_e _cmd_info(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "TLM_RATE",   "i",    _cmd_rate,  0,  COMMS_DONE_NONE },
+    { "TLM",        "",     _cmd_info,  0,  COMMS_DONE_NONE },
+};
+#define TELEMETRY_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static void _publish(uint32_t now);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化遥测服务并注册串口命令
+ * @param   usart 输出串口 (需启用 TX 中断)
+ * @param   get_ms 时间戳来源
+ * @param   sample 采样函数
+ * @note    需在 s_wireless_comms_init 之后调用; 默认关闭, 由 $TLM_RATE:<hz># 开启
+ */
+void s_telemetry_init(usart_t* usart, uint32_t(*get_ms)(void), telemetry_sample_fn_t sample) {
+    _usart = usart;
+    _get_ms = get_ms;
+    _sample = sample;
+    _rate_hz = 0;
+    _period_ms = 0;
+    _sent = 0;
+    _dropped = 0;
+    s_wireless_comms_register(_cmds, TELEMETRY_CMD_COUNT);
+}
+
+/**
+ * @brief   设置输出频率
+ * @param   hz 频率 (Hz), 0 关闭
+ * @retval  bool - true:成功, false:超过 TELEMETRY_MAX_HZ
+ * @note    周期取整到毫秒, 按固定时间网格发送 (不累积漂移)
+ */
+bool s_telemetry_set_rate(uint16_t hz) {
+    if(hz > TELEMETRY_MAX_HZ) return false;
+    _rate_hz = hz;
+    _period_ms = hz ? 1000u / hz : 0;
+    if(_get_ms) _next_ms = _get_ms();
+    return true;
+}
+
+/**
+ * @brief   遥测任务, 由调度器作为后台任务调用
+ * @note    发送缓冲区空间不足时丢弃本帧并计数, 不阻塞
+ */
+void s_telemetry_task(void) {
+    if(!_period_ms || !_usart || !_sample) return;
+
+    uint32_t now = _get_ms();
+    if((int32_t)(now - _next_ms) < 0) return;
+
+    _next_ms += _period_ms;
+    // 落后超过一个周期 (如长时间阻塞) 时重新对齐, 不补发
+    if((int32_t)(now - _next_ms) >= 0) _next_ms = now + _period_ms;
+    _publish(now);
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   采样并发送一帧
+ * @param   now 时间戳 (ms)
+ */
+static void _publish(uint32_t now) {
+    telemetry_sample_t s;
+    uint8_t payload[TELEMETRY_PAYLOAD_LEN];
+    uint8_t out[PROTO_BIN_MAX_ENCODED];
+
+    _sample(&s);
+    memcpy(&payload[0], &now, 4);
+    memcpy(&payload[4], &s.pos_mm, 4);
+    memcpy(&payload[8], &s.speed_mm_s, 4);
+    memcpy(&payload[12], &s.target_mm, 4);
+    memcpy(&payload[16], &s.grip_rad, 4);
+    payload[20] = s.relay_dir;
+    payload[21] = s.state_id;
+
+    uint16_t n = s_proto_bin_encode(COMMS_MSG_TELEMETRY, _seq++, payload, sizeof(payload), out, sizeof(out));
+    if(n && usart_write(_usart, out, n)) {
+        _sent++;
+    }
+    else {
+        _dropped++;
+    }
+}
+
+/**
+ * @brief   $TLM_RATE:<hz># : 设置遥测频率, 0 关闭
+ */
+static comms_status_e _cmd_rate(const comms_args_t* args) {
+    if(args->v[0].i < 0 || args->v[0].i > TELEMETRY_MAX_HZ) return COMMS_ERR_ARG;
+    s_telemetry_set_rate((uint16_t)args->v[0].i);
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TLM# : 回复 $TLM:<频率 Hz>,<已发送帧数>,<丢弃帧数>#
+ */
+static comms_status_e _cmd_info(const comms_args_t* args) {
+    (void)args;
+    printf("$TLM:%u,%lu,%lu#", _rate_hz, (unsigned long)_sent, (unsigned long)_dropped);
+    return COMMS_OK;
+}
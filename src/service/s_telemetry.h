@@ -0,0 +1,48 @@
+/**
+ * @file    s_telemetry.h
+ * @brief   遥测服务
+ *          以上位机设定的频率输出升降台/夹爪/状态机的状态帧 (二进制, 不经 printf)
+ * @note    帧经 s_proto_bin 打包 (COBS + CRC-16, 0x00 定界), 类型 COMMS_MSG_TELEMETRY, 序号逐帧递增 (用于检测丢帧);
+ *          负载 (小端, 共 TELEMETRY_PAYLOAD_LEN 字节):
+ *          | tick_ms(u32) | pos_mm | speed_mm_s | target_mm | grip_rad | (f32 x 4) | relay_dir(u8) | state_id(u8) |
+ *          state_id 对应的状态名可通过 $FSM_STATES# 查询
+ */
+#ifndef _s_telemetry_h_
+#define _s_telemetry_h_
+
+#include "usart.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+#define TELEMETRY_PAYLOAD_LEN   22
+// 最高输出频率 (Hz), 编码器按控制周期更新, 更高的频率只会重复发送相同数据
+#define TELEMETRY_MAX_HZ        100
+
+/**
+ * @brief   一次遥测采样
+ */
+typedef struct {
+    float pos_mm;           // 升降台位置
+    float speed_mm_s;       // 升降台速度
+    float target_mm;        // 升降台目标位置
+    float grip_rad;         // 夹爪最近一次指令角度
+    uint8_t relay_dir;      // 继电器方向 (RelayDir_e)
+    uint8_t state_id;       // 状态机当前状态 ID
+} telemetry_sample_t;
+
+/**
+ * @brief   采样函数, 由上层模块提供
+ * @param   out 输出采样
+ */
+typedef void(*telemetry_sample_fn_t)(telemetry_sample_t* out);
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_telemetry_init(usart_t* usart, uint32_t(*get_ms)(void), telemetry_sample_fn_t sample);
+bool s_telemetry_set_rate(uint16_t hz);
+void s_telemetry_task(void);
+
+#endif
@@ -0,0 +1,337 @@
+/**
+ * @file    s_timer.c
+ * @brief   软件定时器服务实现
+ */
+#include "s_timer.h"
+#include "s_wireless_comms.h"
+
+#include <stdio.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define TIMER_NIL           0xFFFF
+#define TIMER_SLOT_BITS     6
+#define TIMER_SLOT_MASK     (TIMER_WHEEL_SLOTS - 1)
+// 时间轮可直接表示的最大延时 (ms), 超出时先挂在最高层最远的槽
+#define TIMER_SPAN          (1uL << (TIMER_SLOT_BITS * TIMER_LEVELS))
+
+/**
+ * @brief   定时器状态
+ */
+typedef enum {
+    TIMER_FREE = 0,         // 未分配 (在空闲链表中)
+    TIMER_IDLE,             // 已创建, 未运行
+    TIMER_ACTIVE,           // 运行中 (挂在时间轮中)
+} timer_state_e;
+
+/**
+ * @brief   定时器 (时间轮槽内以双向链表相连, 空闲时以 next 串成空闲链表)
+ */
+typedef struct {
+    uint32_t expire;        // 到期时刻 (ms)
+    uint32_t delay;         // 最近一次启动的延时 (ms), 0 为未启动过
+    uint32_t period;        // 周期 (ms), 0 为单次
+    timer_cb_t cb;
+    void* arg;
+    uint16_t next;
+    uint16_t prev;
+    uint8_t slot;           // 所在槽位: 层 * TIMER_WHEEL_SLOTS + 层内槽号
+    uint8_t state;
+    uint8_t gen;            // 分配代数, 编入句柄以识别已删除后被复用的定时器
+} timer_node_t;
+
+static uint32_t(*_get_ms)(void) = 0;
+static uint32_t(*_get_cycles)(void) = 0;
+static timer_node_t _timers[TIMER_MAX];
+static uint16_t _wheel[TIMER_LEVELS * TIMER_WHEEL_SLOTS];
+static uint16_t _free = TIMER_NIL;
+static uint32_t _now = 0;                   // 时间轮已处理到的毫秒
+static timer_stat_t _stat = { 0 };
+
+static comms_status_e _cmd_info(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "TIMER",          "",     _cmd_info,  0,  COMMS_DONE_NONE },
+};
+#define TIMER_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static uint16_t _from_handle(timer_handle_t handle);
+static void _link(uint16_t idx);
+static void _unlink(uint16_t idx);
+static void _cascade(uint8_t slot);
+static void _step(void);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化定时器服务
+ * @param   get_ms 毫秒时间来源 (SysTick 时基)
+ * @param   get_cycles CPU 周期计数, 用于统计推进耗时
+ * @note    需在任何模块创建定时器之前调用 (状态机的停留超时在 a_fsm_init 中启动), 不依赖时基已运行;
+ *          已创建的定时器全部释放
+ */
+void s_timer_init(uint32_t(*get_ms)(void), uint32_t(*get_cycles)(void)) {
+    _get_ms = get_ms;
+    _get_cycles = get_cycles;
+    _now = get_ms();
+    for(uint16_t i = 0; i < TIMER_LEVELS * TIMER_WHEEL_SLOTS; ++i) _wheel[i] = TIMER_NIL;
+    for(uint16_t i = 0; i < TIMER_MAX; ++i) {
+        _timers[i].state = TIMER_FREE;
+        _timers[i].next = (uint16_t)(i + 1 < TIMER_MAX ? i + 1 : TIMER_NIL);
+    }
+    _free = 0;
+    _stat = (timer_stat_t){ 0 };
+}
+
+/**
+ * @brief   注册定时器相关串口命令
+ * @note    需在 s_wireless_comms_init 之后调用
+ */
+void s_timer_register_cmds(void) {
+    s_wireless_comms_register(_cmds, TIMER_CMD_COUNT);
+}
+
+/**
+ * @brief   定时器任务, 由调度器作为后台任务调用
+ * @note    逐毫秒推进时间轮到当前时刻并调用到期回调; 无运行中的定时器时直接跳到当前时刻
+ */
+void s_timer_task(void) {
+    if(!_get_ms) return;
+    uint32_t now = _get_ms();
+
+    while(_now != now) {
+        if(_stat.active == 0) {
+            _now = now;
+            break;
+        }
+        _step();
+    }
+}
+
+/**
+ * @brief   创建定时器 (创建后处于停止状态)
+ * @param   cb 到期回调
+ * @param   arg 回调参数
+ * @retval  timer_handle_t 句柄, -1 表示定时器已用尽或未初始化
+ */
+timer_handle_t s_timer_create(timer_cb_t cb, void* arg) {
+    if(!cb || _free == TIMER_NIL) return -1;
+    uint16_t idx = _free;
+    timer_node_t* t = &_timers[idx];
+
+    _free = t->next;
+    t->cb = cb;
+    t->arg = arg;
+    t->delay = 0;
+    t->period = 0;
+    t->state = TIMER_IDLE;
+    t->gen++;
+    if(++_stat.used > _stat.peak) _stat.peak = _stat.used;
+    return (timer_handle_t)(((uint32_t)t->gen << 16) | idx);
+}
+
+/**
+ * @brief   删除定时器, 句柄随即失效
+ * @param   handle 句柄
+ * @retval  bool - true:成功, false:句柄无效
+ */
+bool s_timer_delete(timer_handle_t handle) {
+    uint16_t idx = _from_handle(handle);
+    if(idx == TIMER_NIL) return false;
+    s_timer_stop(handle);
+    _timers[idx].state = TIMER_FREE;
+    _timers[idx].next = _free;
+    _free = idx;
+    _stat.used--;
+    return true;
+}
+
+/**
+ * @brief   启动定时器 (运行中时以新参数重新开始计时)
+ * @param   handle 句柄
+ * @param   delay_ms 距首次到期的延时 (ms), 至少为 1
+ * @param   period_ms 之后的到期周期 (ms), 0 为单次
+ * @retval  bool - true:成功, false:句柄无效
+ * @note    延时自当前时刻起算; 周期定时器以上次到期时刻为基准, 不累积回调延迟
+ */
+bool s_timer_start(timer_handle_t handle, uint32_t delay_ms, uint32_t period_ms) {
+    uint16_t idx = _from_handle(handle);
+    if(idx == TIMER_NIL) return false;
+    timer_node_t* t = &_timers[idx];
+
+    if(t->state == TIMER_ACTIVE)
+        _unlink(idx);
+    else
+        _stat.active++;
+    t->delay = delay_ms ? delay_ms : 1;
+    t->period = period_ms;
+    t->expire = _get_ms() + t->delay;
+    t->state = TIMER_ACTIVE;
+    _link(idx);
+    return true;
+}
+
+/**
+ * @brief   停止定时器 (已停止时忽略)
+ * @param   handle 句柄
+ * @retval  bool - true:成功, false:句柄无效
+ */
+bool s_timer_stop(timer_handle_t handle) {
+    uint16_t idx = _from_handle(handle);
+    if(idx == TIMER_NIL) return false;
+    if(_timers[idx].state == TIMER_ACTIVE) {
+        _unlink(idx);
+        _timers[idx].state = TIMER_IDLE;
+        _stat.active--;
+    }
+    return true;
+}
+
+/**
+ * @brief   以最近一次启动的延时与周期重新开始计时
+ * @param   handle 句柄
+ * @retval  bool - true:成功, false:句柄无效或从未启动
+ */
+bool s_timer_restart(timer_handle_t handle) {
+    uint16_t idx = _from_handle(handle);
+    if(idx == TIMER_NIL || _timers[idx].delay == 0) return false;
+    return s_timer_start(handle, _timers[idx].delay, _timers[idx].period);
+}
+
+/**
+ * @brief   判断定时器是否运行中
+ * @param   handle 句柄
+ * @retval  bool - true:运行中, false:已停止或句柄无效
+ */
+bool s_timer_is_active(timer_handle_t handle) {
+    uint16_t idx = _from_handle(handle);
+    return idx != TIMER_NIL && _timers[idx].state == TIMER_ACTIVE;
+}
+
+/**
+ * @brief   获取运行统计
+ * @retval  const timer_stat_t* 统计数据
+ */
+const timer_stat_t* s_timer_get_stat(void) {
+    return &_stat;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   句柄转换为定时器下标
+ * @retval  下标, 句柄无效或定时器已删除时为 TIMER_NIL
+ */
+static uint16_t _from_handle(timer_handle_t handle) {
+    if(handle < 0) return TIMER_NIL;
+    uint16_t idx = (uint16_t)(handle & 0xFFFF);
+    uint8_t gen = (uint8_t)((uint32_t)handle >> 16);
+    if(idx >= TIMER_MAX || _timers[idx].state == TIMER_FREE || _timers[idx].gen != gen) return TIMER_NIL;
+    return idx;
+}
+
+/**
+ * @brief   按剩余时间将定时器挂入对应层的槽位
+ * @note    剩余时间在 [64^k, 64^(k+1)) 内挂入第 k 层, 槽号取到期时刻的第 k 组 6 位;
+ *          该槽在第 k 层下一次转到时正好覆盖到期时刻所在的 64^k ms 区间
+ */
+static void _link(uint16_t idx) {
+    timer_node_t* t = &_timers[idx];
+    uint32_t at = t->expire;
+    uint32_t delta = at - _now;
+    uint8_t level = 0;
+
+    if(delta >= TIMER_SPAN) {
+        delta = TIMER_SPAN - 1;
+        at = _now + delta;
+    }
+    while(level < TIMER_LEVELS - 1 && delta >= (1uL << (TIMER_SLOT_BITS * (level + 1)))) level++;
+
+    t->slot = (uint8_t)(level * TIMER_WHEEL_SLOTS + ((at >> (TIMER_SLOT_BITS * level)) & TIMER_SLOT_MASK));
+    t->prev = TIMER_NIL;
+    t->next = _wheel[t->slot];
+    if(t->next != TIMER_NIL) _timers[t->next].prev = idx;
+    _wheel[t->slot] = idx;
+}
+
+/**
+ * @brief   将定时器从所在槽位摘除
+ */
+static void _unlink(uint16_t idx) {
+    timer_node_t* t = &_timers[idx];
+    if(t->prev != TIMER_NIL)
+        _timers[t->prev].next = t->next;
+    else
+        _wheel[t->slot] = t->next;
+    if(t->next != TIMER_NIL) _timers[t->next].prev = t->prev;
+    t->next = t->prev = TIMER_NIL;
+}
+
+/**
+ * @brief   将高层槽位中的定时器按剩余时间重新挂入更低的层
+ * @note    重新挂入的槽位必不是当前槽 (超出范围的定时器挂到最高层最远的槽), 循环必然结束
+ */
+static void _cascade(uint8_t slot) {
+    while(_wheel[slot] != TIMER_NIL) {
+        uint16_t idx = _wheel[slot];
+        _unlink(idx);
+        _link(idx);
+    }
+}
+
+/**
+ * @brief   时间轮推进一毫秒: 低层转完一圈时级联上一层, 然后处理第 0 层当前槽
+ * @note    第 0 层槽内的定时器剩余时间均小于一圈, 当前槽中的全部到期; 每次从槽头取出,
+ *          回调中启动或停止其他定时器不影响遍历
+ */
+static void _step(void) {
+    uint32_t start = _get_cycles();
+    uint32_t cost = 0;
+    uint32_t t = ++_now;
+
+    for(uint8_t level = 1; level < TIMER_LEVELS && (t & TIMER_SLOT_MASK) == 0; ++level) {
+        t >>= TIMER_SLOT_BITS;
+        _cascade((uint8_t)(level * TIMER_WHEEL_SLOTS + (t & TIMER_SLOT_MASK)));
+    }
+
+    uint8_t slot = (uint8_t)(_now & TIMER_SLOT_MASK);
+    while(_wheel[slot] != TIMER_NIL) {
+        uint16_t idx = _wheel[slot];
+        timer_node_t* tm = &_timers[idx];
+        uint32_t late = _get_ms() - tm->expire;
+
+        _unlink(idx);
+        if(tm->period) {
+            tm->expire += tm->period;
+            _link(idx);
+        }
+        else {
+            tm->state = TIMER_IDLE;
+            _stat.active--;
+        }
+        _stat.fired++;
+        if(late > _stat.late_max) _stat.late_max = late;
+
+        cost += _get_cycles() - start;
+        tm->cb(tm->arg);
+        start = _get_cycles();
+    }
+
+    cost += _get_cycles() - start;
+    if(cost > _stat.step_max) _stat.step_max = cost;
+}
+
+/**
+ * @brief   $TIMER# : 回复 $TIMER:<已创建>,<运行中>,<峰值>,<回调次数>,<最大延迟 ms>,<单步最大周期>#
+ */
+static comms_status_e _cmd_info(const comms_args_t* args) {
+    (void)args;
+    printf("$TIMER:%u,%u,%u,%lu,%lu,%lu#", (unsigned)_stat.used, (unsigned)_stat.active, (unsigned)_stat.peak,
+        (unsigned long)_stat.fired, (unsigned long)_stat.late_max, (unsigned long)_stat.step_max);
+    return COMMS_OK;
+}
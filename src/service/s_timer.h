@@ -0,0 +1,65 @@
+/**
+ * @file    s_timer.h
+ * @brief   软件定时器服务
+ *          以句柄创建、启动、停止、重启定时器, 单次或周期到期后在主循环中调用回调,
+ *          由分层时间轮按毫秒推进, 启动、停止与每毫秒推进的开销均与定时器数量无关
+ * @note    时间轮共 TIMER_LEVELS 层, 每层 TIMER_WHEEL_SLOTS 槽: 第 0 层 1 ms 一槽, 第 k 层一槽覆盖 64^k ms;
+ *          定时器按剩余时间挂入对应层, 低层转完一圈时把上一层当前槽的定时器下放到更低层 (级联).
+ *          默认 4 层可直接容纳 2^24 ms (约 4.6 h) 内的延时, 更长的延时在最高层内多次级联
+ * @note    时间来源为 SysTick 驱动的毫秒时基, 由 s_timer_task (调度器后台任务) 补齐到当前毫秒,
+ *          回调在主循环中执行, 可在回调中启动、停止或删除任意定时器 (含自身);
+ *          除 s_timer_task 外的接口均只可在主循环中调用
+ */
+#ifndef _s_timer_h_
+#define _s_timer_h_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 最大定时器数 (不超过 0xFFFF), 每个约占 28 字节 RAM; 固件用量约为 FSM_TIMER_MAX 再加少量
+#ifndef TIMER_MAX
+#define TIMER_MAX           32
+#endif
+// 时间轮层数 / 每层槽数 (固定为 64)
+#define TIMER_LEVELS        4
+#define TIMER_WHEEL_SLOTS   64
+
+/**
+ * @brief   定时器句柄 (下标 + 分配代数), 负数为无效句柄
+ */
+typedef int32_t timer_handle_t;
+
+/**
+ * @brief   到期回调
+ * @param   arg 创建时传入的参数
+ */
+typedef void(*timer_cb_t)(void* arg);
+
+/**
+ * @brief   运行统计
+ */
+typedef struct {
+    uint16_t used;          // 已创建
+    uint16_t active;        // 运行中
+    uint16_t peak;          // 已创建的最大值
+    uint32_t fired;         // 回调调用次数
+    uint32_t late_max;      // 回调相对到期时刻的最大延迟 (ms)
+    uint32_t step_max;      // 推进一毫秒的最大耗时 (周期, 不含回调)
+} timer_stat_t;
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_timer_init(uint32_t(*get_ms)(void), uint32_t(*get_cycles)(void));
+void s_timer_register_cmds(void);
+void s_timer_task(void);
+timer_handle_t s_timer_create(timer_cb_t cb, void* arg);
+bool s_timer_delete(timer_handle_t handle);
+bool s_timer_start(timer_handle_t handle, uint32_t delay_ms, uint32_t period_ms);
+bool s_timer_stop(timer_handle_t handle);
+bool s_timer_restart(timer_handle_t handle);
+bool s_timer_is_active(timer_handle_t handle);
+const timer_stat_t* s_timer_get_stat(void);
+
+#endif
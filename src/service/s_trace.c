@@ -0,0 +1,229 @@
+/**
+ * @file    s_trace.c
+ * @brief   事件跟踪服务实现
+ */
+#include "s_trace.h"
+#include "s_atomic.h"
+#include "s_proto_bin.h"
+#include "s_wireless_comms.h"
+#include "dwt.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define TRACE_MASK              (TRACE_DEPTH - 1)
+// 每帧记录数 (记录 12 字节, 与线上格式相同)
+#define TRACE_RECS_PER_FRAME    (PROTO_BIN_MAX_PAYLOAD / sizeof(trace_rec_t))
+#define TRACE_INFO_LEN          12
+
+static trace_rec_t _ring[TRACE_DEPTH];
+static volatile uint32_t _head = 0;         // 下一个写入位置 (累计值)
+static volatile uint32_t _lost = 0;         // 暂停或冻结期间未记录的条数
+static volatile uint32_t _stop = 0;         // 冻结位置, _stop_armed 置位后有效
+static volatile uint8_t _stop_armed = 0;
+static volatile uint8_t _paused = 0;        // 导出期间暂停记录
+
+static usart_t* _usart = 0;
+static uint32_t(*_get_ms)(void) = 0;
+static uint32_t _clock_next_ms = 0;
+
+// 导出进度
+static uint32_t _dump_pos = 0;
+static uint32_t _dump_end = 0;
+static uint8_t _dump_seq = 0;
+static bool _dump_info = false;             // TRACE_INFO 帧已发送
+
+static comms_status_e _cmd_dump(const comms_args_t* args);
+static comms_status_e _cmd_clear(const comms_args_t* args);
+static comms_status_e _cmd_info(const comms_args_t* args);
+
+/**
+ * @brief   串口命令表
+ */
+static const comms_cmd_t _cmds[] = {
+    { "TRACE_DUMP",     "",     _cmd_dump,  0,  COMMS_DONE_NONE },
+    { "TRACE_CLEAR",    "",     _cmd_clear, 0,  COMMS_DONE_NONE },
+    { "TRACE",          "",     _cmd_info,  0,  COMMS_DONE_NONE },
+};
+#define TRACE_CMD_COUNT  (sizeof(_cmds) / sizeof(_cmds[0]))
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static uint32_t _end(void);
+static bool _send_next(void);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   初始化跟踪服务并注册串口命令
+ * @param   usart 导出串口 (需启用 TX 中断)
+ * @param   get_ms CLOCK 记录的时间来源
+ * @note    需在 s_wireless_comms_init 之后、开始记录之前调用
+ */
+void s_trace_init(usart_t* usart, uint32_t(*get_ms)(void)) {
+    _usart = usart;
+    _get_ms = get_ms;
+    _head = 0;
+    _lost = 0;
+    _stop_armed = 0;
+    _paused = 0;
+    s_wireless_comms_register(_cmds, TRACE_CMD_COUNT);
+    _clock_next_ms = get_ms() + TRACE_CLOCK_MS;
+    s_trace_record(TRACE_EV_CLOCK, 0, 0, get_ms());
+}
+
+/**
+ * @brief   写入一条跟踪记录
+ * @param   ev 事件类型 (trace_ev_e)
+ * @param   a / b / c 参数 (含义见 trace_ev_e)
+ * @note    可在任意优先级的中断与主循环中调用, 不关中断; 暂停或冻结时只计数
+ */
+void s_trace_record(uint8_t ev, uint8_t a, uint16_t b, uint32_t c) {
+    if(_paused) {
+        s_atomic_add(&_lost, 1);
+        return;
+    }
+    uint32_t pos = s_atomic_add(&_head, 1);
+    if(_stop_armed && (int32_t)(pos - _stop) >= 0) {
+        s_atomic_add(&_lost, 1);
+        return;
+    }
+
+    trace_rec_t* r = &_ring[pos & TRACE_MASK];
+    r->cyc = dwt_get_cycles();
+    r->ev = ev;
+    r->a = a;
+    r->b = b;
+    r->c = c;
+}
+
+/**
+ * @brief   记录故障, 首次故障后再记录 TRACE_POST_FAULT 条即冻结
+ * @param   code 故障码 (trace_fault_e)
+ * @param   b / c 参数 (含义见 trace_fault_e)
+ * @note    可在中断中调用
+ */
+void s_trace_fault(uint8_t code, uint16_t b, uint32_t c) {
+    s_trace_record(TRACE_EV_FAULT, code, b, c);
+    if(_stop_armed) return;
+    _stop = _head + TRACE_POST_FAULT;
+    _stop_armed = 1;
+}
+
+/**
+ * @brief   跟踪任务, 由调度器作为后台任务调用
+ * @note    定时写入 CLOCK 记录; 导出期间在发送缓冲区有空间时逐帧发送, 发完后恢复记录
+ */
+void s_trace_task(void) {
+    uint32_t now = _get_ms ? _get_ms() : 0;
+    if(_get_ms && (int32_t)(now - _clock_next_ms) >= 0) {
+        _clock_next_ms = now + TRACE_CLOCK_MS;
+        s_trace_record(TRACE_EV_CLOCK, 0, 0, now);
+    }
+    while(_paused && usart_tx_free(_usart) >= PROTO_BIN_MAX_ENCODED) {
+        if(!_send_next()) _paused = 0;
+    }
+}
+
+/**
+ * @brief   复制最近的 n 条记录 (按写入顺序)
+ * @param   out 输出缓冲区
+ * @param   n 最多复制的条数
+ * @retval  uint8_t 实际复制的条数
+ * @note    供故障处理在异常中调用, 不修改缓冲区状态
+ */
+uint8_t s_trace_last(trace_rec_t* out, uint8_t n) {
+    uint32_t end = _end();
+    uint32_t avail = end < TRACE_DEPTH ? end : TRACE_DEPTH;
+    if(n > avail) n = (uint8_t)avail;
+
+    for(uint8_t i = 0; i < n; ++i) out[i] = _ring[(end - n + i) & TRACE_MASK];
+    return n;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   最后一条有效记录之后的写入位置 (冻结时为冻结位置)
+ */
+static uint32_t _end(void) {
+    uint32_t end = _head;
+    if(_stop_armed && (int32_t)(end - _stop) > 0) end = _stop;
+    return end;
+}
+
+/**
+ * @brief   发送导出的下一帧
+ * @retval  bool - true:已发送, false:已全部发送
+ */
+static bool _send_next(void) {
+    uint8_t payload[PROTO_BIN_MAX_PAYLOAD];
+    uint8_t frame[PROTO_BIN_MAX_ENCODED];
+    uint8_t len;
+    uint8_t type = COMMS_MSG_TRACE;
+
+    if(!_dump_info) {
+        uint16_t count = (uint16_t)(_dump_end - _dump_pos);
+        uint32_t lost = _lost;
+        memcpy(&payload[0], &_dump_end, 4);
+        memcpy(&payload[4], &count, 2);
+        memcpy(&payload[6], &lost, 4);
+        payload[10] = CPU_FREQ_MHZ;
+        payload[11] = _stop_armed;
+        len = TRACE_INFO_LEN;
+        type = COMMS_MSG_TRACE_INFO;
+        _dump_info = true;
+    }
+    else if(_dump_pos != _dump_end) {
+        uint8_t n = 0;
+        for(; n < TRACE_RECS_PER_FRAME && _dump_pos != _dump_end; ++n, ++_dump_pos) {
+            memcpy(&payload[n * sizeof(trace_rec_t)], &_ring[_dump_pos & TRACE_MASK], sizeof(trace_rec_t));
+        }
+        len = (uint8_t)(n * sizeof(trace_rec_t));
+    }
+    else {
+        return false;
+    }
+
+    uint16_t n = s_proto_bin_encode(type, _dump_seq++, payload, len, frame, sizeof(frame));
+    usart_write(_usart, frame, n);
+    return true;
+}
+
+/**
+ * @brief   $TRACE_DUMP# : 导出缓冲区中的全部记录 (后台发送, 期间暂停记录)
+ */
+static comms_status_e _cmd_dump(const comms_args_t* args) {
+    (void)args;
+    if(!_usart || _paused) return COMMS_ERR_BUSY;
+
+    _paused = 1;
+    _dump_end = _end();
+    _dump_pos = _dump_end - (_dump_end < TRACE_DEPTH ? _dump_end : TRACE_DEPTH);
+    _dump_seq = 0;
+    _dump_info = false;
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TRACE_CLEAR# : 清空记录并解除冻结
+ */
+static comms_status_e _cmd_clear(const comms_args_t* args) {
+    (void)args;
+    if(_paused) return COMMS_ERR_BUSY;
+    _stop_armed = 0;
+    _head = 0;
+    _lost = 0;
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TRACE# : 回复 $TRACE:<已写入条数>,<未记录条数>,<冻结>#
+ */
+static comms_status_e _cmd_info(const comms_args_t* args) {
+    (void)args;
+    printf("$TRACE:%lu,%lu,%u#", (unsigned long)_end(), (unsigned long)_lost, (unsigned)_stop_armed);
+    return COMMS_OK;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file    s_trace.h
+ * @brief   事件跟踪服务
+ *          中断与主循环把定长二进制记录 (DWT 时间戳 + 事件类型 + 3 个参数) 写入 RAM 环形缓冲区,
+ *          覆盖状态机转移、命令执行与回复、继电器动作、CAN 收发与故障, 新记录覆盖最旧记录
+ * @note    写入无锁: 以原子加法预留写入位置, 每个写入者独占自己的槽位, 不关中断;
+ *          主循环读取时不会有写到一半的记录 (中断总是执行完毕才返回主循环)
+ * @note    首次故障后再记录 TRACE_POST_FAULT 条即冻结, 保留故障前后的记录, 直到 $TRACE_CLEAR#
+ * @note    $TRACE_DUMP# 期间暂停记录, 由 s_trace_task 在发送缓冲区有空间时逐帧发出 (s_proto_bin 打包):
+ *          TRACE_INFO : | end(u32) | count(u16) | lost(u32) | cpu_mhz(u8) | frozen(u8) |
+ *                       end 为最后一条记录之后的写入位置, count 为随后的记录条数, lost 为暂停或冻结期间未记录的条数
+ *          TRACE      : 最多 4 条记录, 每条 | cyc(u32) | ev(u8) | a(u8) | b(u16) | c(u32) |,
+ *                       按写入顺序排列, 帧序号逐帧递增
+ * @note    DWT 周期计数约 60 s 回绕一次; s_trace_task 每 TRACE_CLOCK_MS 写入一条 CLOCK 记录 (参数为 ms 时间),
+ *          上位机据此展开时间戳并对应到控制器毫秒时间
+ */
+#ifndef _s_trace_h_
+#define _s_trace_h_
+
+#include "usart.h"
+
+#include <stdint.h>
+
+// ! ========================= 接 口 变 量 / Typedef 声 明 ========================= ! //
+
+// 环形缓冲区记录数 (必须为 2 的幂)
+#define TRACE_DEPTH         128
+// 首次故障后继续记录的条数
+#define TRACE_POST_FAULT    32
+// CLOCK 记录间隔 (ms), 须小于 DWT 回绕周期的一半
+#define TRACE_CLOCK_MS      10000
+
+/**
+ * @brief   事件类型与参数 (a / b / c)
+ */
+typedef enum {
+    TRACE_EV_NONE = 0,
+    TRACE_EV_CLOCK,         // - / - / ms 时间
+    TRACE_EV_FSM,           // 事件 / 源状态 ID << 8 | 目标状态 ID / 事件参数
+    TRACE_EV_CMD,           // 二进制命令类型 (带处理函数的 ASCII 命令为 0) / 序号 (见 TRACE_SEQ) / ASCII 命令名 FNV-1a
+    TRACE_EV_REPLY,         // 状态 / 序号 (见 TRACE_SEQ) / 命令类型
+    TRACE_EV_RELAY,         // 新方向 / 1:急停锁定 / -
+    TRACE_EV_CAN_TX,        // 数据长度 / 标准 ID / 前 4 字节数据 (小端)
+    TRACE_EV_CAN_RX,        // 数据长度 / 标准 ID / 前 4 字节数据 (小端)
+    TRACE_EV_FAULT,         // 故障码 (trace_fault_e) / 见故障码 / 见故障码
+    TRACE_EV_COUNT
+} trace_ev_e;
+
+/**
+ * @brief   故障码
+ */
+typedef enum {
+    TRACE_FAULT_ESTOP = 1,  // 急停: c 为识别到最后一个字节至继电器断开的周期数
+    TRACE_FAULT_FSM,        // 状态机进入错误状态: b 为触发事件, c 为事件参数
+    TRACE_FAULT_CAN_TX,     // CAN 发送失败: b 为标准 ID, c 为 0:无空闲邮箱, 1:发送超时
+} trace_fault_e;
+
+/**
+ * @brief   命令序号编码: 低 8 位为序号, 不带序号时置 TRACE_SEQ_NONE, 定时命令到期执行时置 TRACE_SEQ_TIMED
+ */
+#define TRACE_SEQ_NONE      0x0100u
+#define TRACE_SEQ_TIMED     0x0200u
+#define TRACE_SEQ(seq)      ((seq) < 0 ? TRACE_SEQ_NONE : (uint16_t)((seq) & 0xFF))
+
+/**
+ * @brief   跟踪记录 (小端, 无填充, 按原样发送)
+ */
+typedef struct {
+    uint32_t cyc;
+    uint8_t ev;
+    uint8_t a;
+    uint16_t b;
+    uint32_t c;
+} trace_rec_t;
+
+// ! ========================= 接 口 函 数 声 明 ========================= ! //
+
+void s_trace_init(usart_t* usart, uint32_t(*get_ms)(void));
+void s_trace_record(uint8_t ev, uint8_t a, uint16_t b, uint32_t c);
+void s_trace_fault(uint8_t code, uint16_t b, uint32_t c);
+void s_trace_task(void);
+uint8_t s_trace_last(trace_rec_t* out, uint8_t n);
+
+#endif
@@ -2,10 +2,19 @@
  * @file    s_wireless_comms.c
  * @brief   无线通信服务实现
  *          升降台升降 + 夹爪开合
+ *          同一串口上自动识别 ASCII ($...#) 与二进制 (0x00 定界的 COBS 帧) 两种协议
  */
 #include "s_wireless_comms.h"
+#include "s_pid_tuner.h"
+#include "s_proto_bin.h"
+#include "s_prof.h"
+#include "s_num.h"
+#include "s_trace.h"
+#include "dwt.h"
+#include "systick.h"
 
 #include <stdio.h>
+#include <string.h>
 
 // ! ========================= 变 量 声 明 ========================= ! //
 
@@ -14,16 +23,192 @@ float lift_target_pos_mm = 0.0f;
 static usart_t* _usart;
 static Relay* _lift_relay;
 static Gripper* _gripper;
+static comms_target_hook_t _target_hook = 0;
+static comms_busy_hook_t _busy_hook = 0;
 
-static uint8_t _rx_buf[USART_RX_BUF_SIZE];
-static bool _cmd_start = false;
-static bool _cmd_ready = false;
-static uint8_t _cmd_idx = 1;
+#if COMMS_WINDOW * (COMMS_LINE_MAX - 1) > USART_RX_BUF_SIZE - 1
+#error "USART_RX_BUF_SIZE 不足以容纳 COMMS_WINDOW 条最长命令"
+#endif
+
+#if COMMS_LINE_MAX > USART_RX_MIRROR
+#error "COMMS_LINE_MAX 超过 USART_RX_MIRROR, 跨越回绕点的命令无法原地解析"
+#endif
+
+/**
+ * @brief   接收解析状态
+ */
+typedef enum {
+    COMMS_RX_IDLE = 0,      // 等待 '$' 或 0x00
+    COMMS_RX_ASCII,         // ASCII 命令: 自 '$' 起的数据留在接收缓冲区中原地扫描, 收到 '#' 后一并移出
+    COMMS_RX_LONG,          // ASCII 命令超长: 边扫描边移出, 只保留结尾用于提取序号
+    COMMS_RX_BIN,           // 二进制帧: 收到 0x00 后进入, 逐字节送入 COBS 解码器, 收到下一个非空帧的定界符或帧超长时退出
+} comms_rx_state_e;
+
+/**
+ * @brief   接收解析器 (可在任意字节处暂停, 下次调用时继续)
+ */
+typedef struct {
+    comms_rx_state_e state;
+    uint16_t scan;          // ASCII / BIN: 已扫描但未移出的字节数 (自 '$' 起); 其余状态为 0
+    uint16_t bin_bytes;     // BIN: 当前帧已接收字节数
+    bool bin_hold;          // BIN: 帧内出现过 '$', 自该处起的数据留在缓冲区中, 帧出错时作为 ASCII 命令重新扫描
+    uint8_t tail[4];        // LONG: 最近 4 字节 (足以容纳 "@255")
+    uint32_t resync;        // 命令未结束即遇到 '$' 或 0x00 而丢弃, 或出错的二进制帧回到其中 '$' 重新扫描的次数
+    uint32_t bytes;         // 已扫描字节总数
+    uint64_t cyc;           // 扫描耗时 (周期, 不含命令解析与执行)
+} comms_rx_t;
+
+static comms_rx_t _rx;
+static proto_bin_dec_t _bin_dec;
+
+/**
+ * @brief   解析耗时统计 (不含命令执行)
+ */
+typedef struct {
+    uint32_t n;
+    uint32_t bytes;
+    uint32_t max_cyc;
+    uint64_t sum_cyc;
+} parse_stat_t;
+
+static parse_stat_t _ascii_stat;
+static parse_stat_t _bin_stat;
+static uint32_t _bin_crc_err = 0;
+static uint32_t _bin_frame_err = 0;
+static uint32_t _line_long = 0;
+static uint32_t _rx_ovf_seen = 0;
+static bool _last_bin = false;      // 最近一条命令使用二进制协议 (异步通知按此选择格式)
+
+/**
+ * @brief   等待完成通知的命令 (每个类别一条)
+ */
+typedef struct {
+    bool active;
+    bool bin;               // 以二进制帧通知
+    bool timed;             // 到期即完成 (夹爪), 否则等待 s_wireless_comms_complete
+    uint8_t seq;
+    uint8_t cmd;            // 命令类型 (二进制 DONE 负载)
+    uint32_t due_ms;
+} comms_pending_t;
+
+static comms_pending_t _pending[COMMS_DONE_KINDS];
+
+/**
+ * @brief   待执行的命令 (立即执行与定时执行共用)
+ */
+typedef struct {
+    const comms_cmd_t* entry;   // ASCII 命令表项, 二进制命令为 0
+    bool bin;                   // 二进制协议
+    int16_t seq;                // 序号, ASCII 命令不带序号时为 -1
+    union {
+        comms_args_t args;      // 处理函数参数 (entry->fn 不为 0)
+        comms_msg_t msg;        // 内置命令
+    } u;
+} comms_job_t;
+
+/**
+ * @brief   定时命令队列 (按执行时刻升序)
+ */
+typedef struct {
+    uint32_t at_ms;
+    comms_job_t job;
+} comms_timed_t;
+
+static comms_timed_t _timed[COMMS_TIMED_SLOTS];
+static uint8_t _timed_n = 0;
+
+/**
+ * @brief   定时执行统计, 误差为实际执行时刻减请求时刻 (ms)
+ */
+typedef struct {
+    uint32_t n;
+    uint32_t full;          // 队列满被拒绝
+    uint32_t rejected;      // 执行时刻超出 COMMS_TIMED_HORIZON 被拒绝
+    int32_t err_min;
+    int32_t err_max;
+    int64_t err_sum;
+} timed_stat_t;
+
+static timed_stat_t _timed_stat;
+
+// FNV-1a 32 位
+#define FNV_OFFSET      2166136261u
+#define FNV_PRIME       16777619u
+#define COMMS_SLOT_MASK (COMMS_CMD_SLOTS - 1)
+
+/**
+ * @brief   命令散列表槽位 (开放寻址, 线性探测)
+ */
+typedef struct {
+    const comms_cmd_t* cmd;
+    uint32_t hash;
+    uint32_t n;             // 解析次数
+    uint32_t max_cyc;       // 查找 + 参数解析耗时 (周期)
+    uint64_t sum_cyc;
+} cmd_slot_t;
+
+static cmd_slot_t _slots[COMMS_CMD_SLOTS];
+
+static comms_status_e _cmd_comms_stats(const comms_args_t* args);
+static comms_status_e _cmd_stats(const comms_args_t* args);
+static comms_status_e _cmd_bench(const comms_args_t* args);
+static comms_status_e _cmd_timed_stats(const comms_args_t* args);
+static comms_status_e _cmd_timed_clear(const comms_args_t* args);
+
+/**
+ * @brief   内置命令表
+ */
+static const comms_cmd_t _builtin_cmds[] = {
+    { "LIFT_UP",        "",         0,                  COMMS_MSG_LIFT_UP,      COMMS_DONE_NONE },
+    { "LIFT_DOWN",      "",         0,                  COMMS_MSG_LIFT_DOWN,    COMMS_DONE_NONE },
+    { "LIFT_STOP",      "",         0,                  COMMS_MSG_LIFT_STOP,    COMMS_DONE_NONE },
+    { "LIFT_SET",       "f",        0,                  COMMS_MSG_LIFT_SET,     COMMS_DONE_LIFT },
+    { "CLOCK",          "",         0,                  COMMS_MSG_CLOCK,        COMMS_DONE_NONE },
+    { "ESTOP",          "",         0,                  COMMS_MSG_ESTOP,        COMMS_DONE_NONE },
+    { "GRIP_OPEN",      "",         0,                  COMMS_MSG_GRIP_OPEN,    COMMS_DONE_GRIP },
+    { "GRIP_CLOSE",     "",         0,                  COMMS_MSG_GRIP_CLOSE,   COMMS_DONE_GRIP },
+    { "GRIP_SET",       "f",        0,                  COMMS_MSG_GRIP_SET,     COMMS_DONE_GRIP },
+    { "PID_GET",        "i",        0,                  COMMS_MSG_PID_GET,      COMMS_DONE_NONE },
+    { "PID_GAIN",       "ifff",     0,                  COMMS_MSG_PID_GAIN,     COMMS_DONE_NONE },
+    { "PID_PARAM",      "ifffff",   0,                  COMMS_MSG_PID_PARAM,    COMMS_DONE_NONE },
+    { "PID_STREAM",     "ii",       0,                  COMMS_MSG_PID_STREAM,   COMMS_DONE_NONE },
+    { "COMMS_STATS",    "",         _cmd_comms_stats,   0,                      COMMS_DONE_NONE },
+    { "CMD_STATS",      "",         _cmd_stats,         0,                      COMMS_DONE_NONE },
+    { "CMD_BENCH",      "",         _cmd_bench,         0,                      COMMS_DONE_NONE },
+    { "TIMED_STATS",    "",         _cmd_timed_stats,   0,                      COMMS_DONE_NONE },
+    { "TIMED_CLEAR",    "",         _cmd_timed_clear,   0,                      COMMS_DONE_NONE },
+};
+#define BUILTIN_CMD_COUNT   (sizeof(_builtin_cmds) / sizeof(_builtin_cmds[0]))
 
 // ! ========================= 私 有 函 数 声 明 ========================= ! //
 
-static void _parse_cmd(uint8_t* cmd);
-static bool _compare_cmd(uint8_t* cmd, const char* target);
+static uint16_t _rx_idle(const uint8_t* buf, uint16_t n);
+static uint16_t _rx_ascii(const uint8_t* buf, uint16_t avail);
+static uint16_t _rx_long(const uint8_t* buf, uint16_t n);
+static uint16_t _rx_bin(const uint8_t* buf, uint16_t n, proto_bin_frame_t* frame, proto_bin_result_e* res);
+static bool _is_text(const uint8_t* buf, uint16_t n);
+static void _handle_ascii(const uint8_t* cmd, uint16_t len);
+static void _handle_bin(const proto_bin_frame_t* frame, uint32_t start, uint32_t bytes);
+static bool _take_suffix(const uint8_t* cmd, uint16_t* len, char mark, uint32_t max, uint32_t* out);
+static int16_t _take_seq(const uint8_t* cmd, uint16_t* len);
+static comms_status_e _parse_ascii(const uint8_t* cmd, uint16_t len, comms_args_t* args, cmd_slot_t** slot_out);
+static comms_status_e _unwrap_at(const proto_bin_frame_t* frame, proto_bin_frame_t* inner, uint32_t* at_ms);
+static comms_status_e _schedule(const comms_job_t* job, uint32_t at_ms);
+static void _run(const comms_job_t* job, bool timed);
+static comms_done_e _done_kind(uint8_t type);
+static void _reply(bool bin, int16_t seq, uint8_t cmd, comms_status_e status);
+static void _send_done(bool bin, uint8_t seq, uint8_t cmd, comms_status_e status);
+static void _track(comms_done_e kind, bool bin, int16_t seq, uint8_t cmd);
+static void _poll(void);
+static void _args_to_msg(const comms_cmd_t* cmd, const comms_args_t* args, comms_msg_t* msg);
+static comms_status_e _unpack_bin(const proto_bin_frame_t* frame, comms_msg_t* msg);
+static comms_status_e _execute(const comms_msg_t* msg);
+static void _send_frame(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len);
+static void _send_pid_info(uint8_t seq, uint8_t id);
+static void _send_clock(bool bin, uint8_t seq);
+static void _stat_add(parse_stat_t* st, uint32_t cyc, uint32_t bytes);
+static uint32_t _name_hash(const char* name);
+
 
 // ! ========================= 接 口 函 数 实 现 ========================= ! //
 
@@ -31,97 +216,1045 @@ void s_wireless_comms_init(usart_t* usart, Relay* lift_relay, Gripper* gripper)
     _usart = usart;
     _lift_relay = lift_relay;
     _gripper = gripper;
+    s_proto_bin_dec_reset(&_bin_dec);
+    memset(&_rx, 0, sizeof(_rx));
+    _rx_ovf_seen = usart_rx_overflow(usart);
+
+    for(uint8_t i = 0; i < COMMS_DONE_KINDS; ++i) _pending[i].active = false;
+    _timed_n = 0;
+    for(uint8_t i = 0; i < COMMS_CMD_SLOTS; ++i) _slots[i].cmd = 0;
+    s_wireless_comms_register(_builtin_cmds, BUILTIN_CMD_COUNT);
+}
+
+/**
+ * @brief   注册 ASCII 命令表
+ * @param   table 命令表 (需为静态存储)
+ * @param   count 表项数
+ * @retval  bool - true:全部注册成功, false:散列表已满或命令名重复 (对应表项被忽略)
+ * @note    需在 s_wireless_comms_init 之后调用; 查找开销只与命令名长度有关, 与已注册命令数无关
+ */
+bool s_wireless_comms_register(const comms_cmd_t* table, uint8_t count) {
+    bool ok = true;
+
+    for(uint8_t k = 0; k < count; ++k) {
+        uint32_t h = _name_hash(table[k].name);
+        uint8_t idx = (uint8_t)(h & COMMS_SLOT_MASK);
+        uint8_t probes = 0;
+        while(_slots[idx].cmd && probes < COMMS_CMD_SLOTS) {
+            if(_slots[idx].hash == h && strcmp(_slots[idx].cmd->name, table[k].name) == 0) break;
+            idx = (uint8_t)((idx + 1) & COMMS_SLOT_MASK);
+            probes++;
+        }
+        if(_slots[idx].cmd) {
+            ok = false;
+            continue;
+        }
+        _slots[idx].cmd = &table[k];
+        _slots[idx].hash = h;
+        _slots[idx].n = 0;
+        _slots[idx].max_cyc = 0;
+        _slots[idx].sum_cyc = 0;
+    }
+    return ok;
+}
+
+/**
+ * @brief   设置升降台目标位置变更通知
+ * @param   hook 通知函数, $LIFT_SET 修改目标位置后调用 (用于上层模块以数据变更驱动而非轮询)
+ */
+void s_wireless_comms_set_target_hook(comms_target_hook_t hook) {
+    _target_hook = hook;
+}
+
+/**
+ * @brief   设置运动命令忙碌判断
+ * @param   hook 判断函数, 返回 true 时 $LIFT_SET / $LIFT_UP / $LIFT_DOWN / $GRIP_* (含定时执行与二进制命令)
+ *          不执行并回复 COMMS_ERR_BUSY; $LIFT_STOP 与 $ESTOP 不受影响
+ */
+void s_wireless_comms_set_busy_hook(comms_busy_hook_t hook) {
+    _busy_hook = hook;
+}
+
+/**
+ * @brief   通知某类动作已结束
+ * @param   kind 完成通知类别
+ * @param   status COMMS_OK 表示正常完成, 否则为 COMMS_ERR_ABORTED / COMMS_ERR_FAULT
+ * @note    该类别有带序号的命令在等待时回复 DONE, 否则忽略; 由执行动作的上层模块调用
+ */
+void s_wireless_comms_complete(comms_done_e kind, comms_status_e status) {
+    if(kind == COMMS_DONE_NONE || kind >= COMMS_DONE_KINDS) return;
+    comms_pending_t* p = &_pending[kind];
+    if(!p->active) return;
+    p->active = false;
+    _send_done(p->bin, p->seq, p->cmd, status);
+}
+
+/**
+ * @brief   执行到期的定时命令
+ * @param   period_ms 调用周期 (ms); 执行时刻距当前不超过半个周期的命令在本次执行,
+ *          按时调用时实际执行时刻与请求时刻之差不超过半个周期
+ * @note    由控制任务在控制计算之前调用, 定时修改的目标在同一控制周期内生效
+ */
+void s_wireless_comms_tick(uint32_t period_ms) {
+    uint32_t now = systick_get_ms();
+
+    while(_timed_n && (int32_t)(_timed[0].at_ms - now) <= (int32_t)(period_ms / 2u)) {
+        comms_timed_t t = _timed[0];
+        _timed_n--;
+        for(uint8_t i = 0; i < _timed_n; ++i) _timed[i] = _timed[i + 1];
+
+        int32_t err = (int32_t)(now - t.at_ms);
+        timed_stat_t* st = &_timed_stat;
+        if(st->n == 0 || err < st->err_min) st->err_min = err;
+        if(st->n == 0 || err > st->err_max) st->err_max = err;
+        st->err_sum += err;
+        st->n++;
+        _run(&t.job, true);
+    }
+}
+
+/**
+ * @brief   取消全部未执行的定时命令, 带序号的命令回复 DONE (COMMS_ERR_ABORTED)
+ * @note    由 $TIMED_CLEAR# 与状态机错误状态 (急停、堵转等) 调用; 不可在中断中调用
+ */
+void s_wireless_comms_abort_timed(void) {
+    for(uint8_t i = 0; i < _timed_n; ++i) {
+        const comms_job_t* job = &_timed[i].job;
+        if(job->seq < 0) continue;
+        uint8_t type = (job->entry && job->entry->fn) ? 0 : job->u.msg.type;
+        _send_done(job->bin, (uint8_t)job->seq, type, COMMS_ERR_ABORTED);
+    }
+    _timed_n = 0;
 }
 
 /**
  * @brief   无线通信服务处理函数
  * @param   None
- * @retval  bool - true:成功接收数据并处理, false:无数据或数据不完整或无命令
+ * @retval  uint8_t 本次处理的完整帧数 (含出错帧), 0 表示无数据或数据不完整
+ * @note    直接在串口接收缓冲区中扫描, 每次最多处理 COMMS_PROCESS_BUDGET 帧, 其余留待下次调用;
+ *          0x00 不会出现在 ASCII 命令中, 收到后切换到二进制协议; 超长或出错的二进制帧中的 '$' 仍可开始 ASCII 命令
  */
-bool s_wireless_comms_process(void) {
-    uint8_t byte;
-    if(usart_read_byte(_usart, &byte) == false) return false;
+uint8_t s_wireless_comms_process(void) {
+    uint8_t handled = 0;
 
-    if(byte == '$') {
-        _rx_buf[0] = byte;
-        _cmd_start = true;
+    _poll();
+    while(handled < COMMS_PROCESS_BUDGET) {
+        uint16_t avail;
+        const uint8_t* buf = usart_rx_peek(_usart, &avail);
+        if(avail <= _rx.scan) break;
+        // 每步最多扫描镜像长度, 保证访问的数据在内存中连续
+        uint16_t n = (uint16_t)(avail > USART_RX_MIRROR ? USART_RX_MIRROR : avail);
+        uint32_t start = dwt_get_cycles();
+        uint16_t used;
+
+        switch(_rx.state) {
+            case COMMS_RX_ASCII: {
+                uint16_t scanned = _rx.scan;
+                used = _rx_ascii(buf, n);
+                _rx.cyc += dwt_get_cycles() - start;
+                _rx.bytes += (uint32_t)(_rx.scan - scanned) + used;
+                if(used && buf[used - 1] == '#') {
+                    _handle_ascii(buf, used);
+                    handled++;
+                }
+                break;
+            }
+            case COMMS_RX_LONG: {
+                used = _rx_long(buf, n);
+                _rx.cyc += dwt_get_cycles() - start;
+                _rx.bytes += used;
+                if(used && buf[used - 1] == '#') {
+                    // 超长命令: 只回复 NAK (结尾带序号时)
+                    uint8_t t[6] = { '$', _rx.tail[0], _rx.tail[1], _rx.tail[2], _rx.tail[3], '#' };
+                    uint16_t len = sizeof(t);
+                    _last_bin = false;
+                    _reply(false, _take_seq(t, &len), 0, COMMS_ERR_LENGTH);
+                    handled++;
+                }
+                break;
+            }
+            case COMMS_RX_BIN: {
+                proto_bin_frame_t frame;
+                proto_bin_result_e res = PROTO_BIN_PENDING;
+                used = _rx_bin(buf, n, &frame, &res);
+                uint32_t end = dwt_get_cycles();
+                _rx.cyc += end - start;
+                _rx.bytes += used;
+                if(res == PROTO_BIN_ERR_CRC) _bin_crc_err++;
+                if(res == PROTO_BIN_ERR_FRAME) _bin_frame_err++;
+                if(res == PROTO_BIN_FRAME) _handle_bin(&frame, end, _rx.bin_bytes + 1u);
+                if(res != PROTO_BIN_PENDING) handled++;
+                break;
+            }
+            default:
+                used = _rx_idle(buf, n);
+                _rx.cyc += dwt_get_cycles() - start;
+                _rx.bytes += used;
+                break;
+        }
+        usart_rx_consume(_usart, used);
     }
 
-    if(_cmd_start) {
-        while(byte != '#') {
-            // 无数据，命令未结束
-            if(usart_read_byte(_usart, &byte) == false) return false;
+    return handled;
+}
+
+/**
+ * @brief   接收缓冲区中是否有尚未扫描的数据
+ * @retval  bool - true:有 (需再次调用 s_wireless_comms_process), false:无, 或仅有等待后续字节的不完整命令
+ * @note    供空闲休眠判断: 不完整的 ASCII 命令留在接收缓冲区中, 不应阻止休眠
+ */
+bool s_wireless_comms_rx_pending(void) {
+    return usart_rx_count(_usart) > _rx.scan;
+}
 
-            _rx_buf[_cmd_idx++] = byte;
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
 
-            // 命令过长，丢弃
-            if(_cmd_idx >= USART_RX_BUF_SIZE) {
-                _cmd_start = false;
-                _cmd_idx = 1;
-                return false;
-            }
+/**
+ * @brief   IDLE: 跳过命令之间的无关字节, 直到 '$' 或 0x00
+ * @param   buf 接收缓冲区中待扫描的数据
+ * @param   n 可扫描字节数
+ * @retval  uint16_t 需移出的字节数 ('$' 保留在缓冲区中作为命令起点)
+ */
+static uint16_t _rx_idle(const uint8_t* buf, uint16_t n) {
+    for(uint16_t i = 0; i < n; ++i) {
+        if(buf[i] == '$') {
+            _rx.state = COMMS_RX_ASCII;
+            _rx.scan = 1;
+            return i;
+        }
+        if(buf[i] == PROTO_BIN_DELIM) {
+            _rx.state = COMMS_RX_BIN;
+            _rx.bin_bytes = 0;
+            _rx.bin_hold = false;
+            s_proto_bin_dec_reset(&_bin_dec);
+            return (uint16_t)(i + 1);
         }
-        _rx_buf[_cmd_idx] = '\0';
-        _cmd_start = false;
-        _cmd_ready = true;
-        _cmd_idx = 1;
     }
+    return n;
+}
 
-    // 处理命令
-    if(_cmd_ready) {
-        _parse_cmd(_rx_buf);
-        _cmd_ready = false;
-        return true;
+/**
+ * @brief   ASCII: 自上次扫描位置继续查找 '#'
+ * @param   buf 接收缓冲区中待扫描的数据, buf[0] 为 '$'
+ * @param   avail 可扫描字节数
+ * @retval  uint16_t 需移出的字节数: 完整命令为命令长度 (含 '#'), 命令未结束时为 0
+ * @note    命令未结束即遇到 '$' 时丢弃已扫描部分, 从新的 '$' 重新开始; 遇到 0x00 时切换到二进制协议;
+ *          达到 COMMS_LINE_MAX 仍未结束时转入 LONG
+ */
+static uint16_t _rx_ascii(const uint8_t* buf, uint16_t avail) {
+    while(_rx.scan < avail) {
+        uint8_t c = buf[_rx.scan];
+        uint16_t i = _rx.scan++;
+
+        if(c == '#') {
+            _rx.state = COMMS_RX_IDLE;
+            _rx.scan = 0;
+            return (uint16_t)(i + 1);
+        }
+        if(c == '$' || c == PROTO_BIN_DELIM) {
+            _rx.resync++;
+            _rx.state = COMMS_RX_IDLE;
+            _rx.scan = 0;
+            return i;
+        }
+        if(_rx.scan >= COMMS_LINE_MAX - 1) {
+            // 命令过长: 移出已扫描部分, 继续接收到 '#' 以便提取序号
+            _line_long++;
+            for(uint8_t k = 0; k < sizeof(_rx.tail); ++k) _rx.tail[k] = buf[_rx.scan - sizeof(_rx.tail) + k];
+            _rx.state = COMMS_RX_LONG;
+            _rx.scan = 0;
+            return i + 1u;
+        }
     }
+    return 0;
+}
 
-    return false;
+/**
+ * @brief   LONG: 丢弃超长命令的剩余部分, 记录最近 4 字节
+ * @param   buf 接收缓冲区中待扫描的数据
+ * @param   n 可扫描字节数
+ * @retval  uint16_t 需移出的字节数; 最后一个字节为 '#' 时命令结束
+ */
+static uint16_t _rx_long(const uint8_t* buf, uint16_t n) {
+    for(uint16_t i = 0; i < n; ++i) {
+        uint8_t c = buf[i];
+        if(c == '$' || c == PROTO_BIN_DELIM) {
+            _rx.state = COMMS_RX_IDLE;
+            return i;
+        }
+        if(c == '#') {
+            _rx.state = COMMS_RX_IDLE;
+            return (uint16_t)(i + 1);
+        }
+        _rx.tail[0] = _rx.tail[1];
+        _rx.tail[1] = _rx.tail[2];
+        _rx.tail[2] = _rx.tail[3];
+        _rx.tail[3] = c;
+    }
+    return n;
 }
 
-// ! ========================= 私 有 函 数 实 现 ========================= ! //
+/**
+ * @brief   BIN: 逐字节送入 COBS 解码器
+ * @param   buf 接收缓冲区中待扫描的数据
+ * @param   n 可扫描字节数
+ * @param   frame 收到完整帧时输出帧内容
+ * @param   res 输出解码结果, 帧结束 (含出错) 时不为 PROTO_BIN_PENDING
+ * @retval  uint16_t 需移出的字节数
+ * @note    噪声或模块上电产生的单个 0x00 会使后续 ASCII 命令被当作二进制帧: 帧超过 PROTO_BIN_MAX_ENCODED
+ *          即放弃 (记为帧错误), 不再等待下一个 0x00; 帧内出现 '$' 后的数据暂不移出 (不超过一帧长度),
+ *          自 '$' 起均为可打印字符并遇到 '#' 时视为 ASCII 命令, 帧出错时同样从该 '$' 起回到 IDLE 重新扫描,
+ *          与 ASCII / LONG 遇到 '$' 时的重新同步一致
+ */
+static uint16_t _rx_bin(const uint8_t* buf, uint16_t n, proto_bin_frame_t* frame, proto_bin_result_e* res) {
+    for(uint16_t i = _rx.scan; i < n; ++i) {
+        if(!_rx.bin_hold && buf[i] == '$') {
+            _rx.bin_hold = true;
+            if(i) return i;                     // 移出 '$' 之前的数据, '$' 起留在缓冲区中
+        }
+        if(_rx.bin_hold && buf[i] == '#' && _is_text(buf + 1, (uint16_t)(i - 1))) {
+            // 自 '$' 起为完整的 ASCII 命令: 放弃二进制帧, 回到 '$' 重新扫描
+            _rx.resync++;
+            _rx.state = COMMS_RX_IDLE;
+            _rx.scan = 0;
+            _rx.bin_hold = false;
+            return 0;
+        }
+        _rx.bin_bytes++;
+        if(_rx.bin_hold) _rx.scan = (uint16_t)(i + 1);
+
+        proto_bin_result_e r = s_proto_bin_dec_feed(&_bin_dec, buf[i], frame);
+        if(r == PROTO_BIN_EMPTY) {
+            _rx.bin_bytes = 0;
+            continue;
+        }
+        if(r == PROTO_BIN_PENDING) {
+            if(!_bin_dec.overflow && _rx.bin_bytes <= PROTO_BIN_MAX_ENCODED) continue;
+            r = PROTO_BIN_ERR_FRAME;            // 超长: 不是本协议的帧
+        }
+
+        uint16_t used = (uint16_t)(i + 1);
+        if(r != PROTO_BIN_FRAME && _rx.bin_hold) {
+            _rx.resync++;
+            used = 0;
+        }
+        _rx.state = COMMS_RX_IDLE;
+        _rx.scan = 0;
+        _rx.bin_hold = false;
+        *res = r;
+        return used;
+    }
+    return _rx.bin_hold ? 0 : n;
+}
 
 /**
- * @brief   解析命令字符串并执行对应操作
- * @param   cmd 待解析的命令字符串
+ * @brief   判断数据是否均为可打印 ASCII 字符 (0x20 ~ 0x7E)
  */
-static void _parse_cmd(uint8_t* cmd) {
-    float fvalue;
+static bool _is_text(const uint8_t* buf, uint16_t n) {
+    for(uint16_t i = 0; i < n; ++i) {
+        if(buf[i] < 0x20 || buf[i] > 0x7E) return false;
+    }
+    return true;
+}
 
-    // 升降台升降命令
-    if(_compare_cmd(cmd, "$LIFT_UP#")) {
-        _lift_relay->set_dir(_lift_relay, RelayDirA);
+/**
+ * @brief   处理一条完整的 ASCII 命令
+ * @param   cmd 命令 (位于接收缓冲区中, 以 '$' 开头, '#' 结尾, 不以 '\0' 结尾)
+ * @param   len 命令长度 (含 '$' 与 '#')
+ * @note    不带序号时, 未注册或参数不符的命令忽略; 带序号时回复 ACK / NAK
+ */
+static void _handle_ascii(const uint8_t* cmd, uint16_t len) {
+    comms_job_t job;
+    comms_args_t args;
+    cmd_slot_t* slot;
+    uint32_t at_ms;
+    uint32_t bytes = len;
+    uint32_t start = dwt_get_cycles();
+    int16_t seq = _take_seq(cmd, &len);
+    bool timed = _take_suffix(cmd, &len, '!', 0xFFFFFFFFu, &at_ms);
+    comms_status_e status = _parse_ascii(cmd, len, &args, &slot);
+    uint32_t cyc = dwt_get_cycles() - start;
+    _stat_add(&_ascii_stat, cyc, bytes);
+    _last_bin = false;
+    if(status != COMMS_OK) {
+        _reply(false, seq, 0, status);
+        return;
     }
-    else if(_compare_cmd(cmd, "$LIFT_DOWN#")) {
-        _lift_relay->set_dir(_lift_relay, RelayDirB);
+
+    slot->n++;
+    slot->sum_cyc += cyc;
+    if(cyc > slot->max_cyc) slot->max_cyc = cyc;
+
+    job.entry = slot->cmd;
+    job.bin = false;
+    job.seq = seq;
+    if(job.entry->fn)
+        job.u.args = args;
+    else
+        _args_to_msg(job.entry, &args, &job.u.msg);
+
+    if(timed) {
+        _reply(false, seq, 0, _schedule(&job, at_ms));
+        return;
     }
-    else if(_compare_cmd(cmd, "$LIFT_STOP#")) {
-        _lift_relay->stop(_lift_relay);
+    _run(&job, false);
+}
+
+/**
+ * @brief   处理一条校验通过的二进制帧
+ * @param   frame 帧
+ * @param   start 收到定界符时的周期计数 (解析耗时统计起点)
+ * @param   bytes 帧在线路上的字节数 (含前后定界符)
+ * @note    每条命令回复 ACK; 运动命令结束后回复 DONE; PID 查询/设置成功后追加 PID_INFO 帧
+ */
+static void _handle_bin(const proto_bin_frame_t* frame, uint32_t start, uint32_t bytes) {
+    comms_job_t job;
+    proto_bin_frame_t inner;
+    uint32_t at_ms = 0;
+    bool timed = (frame->type == COMMS_MSG_AT);
+    comms_status_e status = COMMS_OK;
+
+    // AT 帧: 解出内层命令, ACK / DONE 中的命令类型为内层命令
+    if(timed) {
+        status = _unwrap_at(frame, &inner, &at_ms);
+        if(status == COMMS_OK) frame = &inner;
     }
-    else if(sscanf((char*)cmd, "$LIFT_SET:%f#", &fvalue) == 1) {
-        lift_target_pos_mm = fvalue;
+    if(status == COMMS_OK) status = _unpack_bin(frame, &job.u.msg);
+    _stat_add(&_bin_stat, dwt_get_cycles() - start, bytes);
+    _last_bin = true;
+    if(status != COMMS_OK) {
+        _reply(true, frame->seq, frame->type, status);
+        return;
     }
 
-    // 夹爪开合命令
-    else if(_compare_cmd(cmd, "$GRIP_OPEN#")) {
-        _gripper->open(_gripper);
+    job.entry = 0;
+    job.bin = true;
+    job.seq = frame->seq;
+    if(timed) {
+        _reply(true, frame->seq, frame->type, _schedule(&job, at_ms));
+        return;
     }
-    else if(_compare_cmd(cmd, "$GRIP_CLOSE#")) {
-        _gripper->close(_gripper);
+    _run(&job, false);
+}
+
+/**
+ * @brief   取出命令结尾的后缀 "<mark><digits>"
+ * @param   cmd 命令, cmd[*len - 1] 为结束符 ('#' 或已取出的后缀的标记字符)
+ * @param   len 命令长度, 带后缀时缩短为以 mark 为结束符 (命令内容不修改)
+ * @param   mark 后缀标记字符
+ * @param   max 数值上限
+ * @param   out 输出后缀数值
+ * @retval  bool - true:带后缀, false:无后缀或数值超出上限 (长度不变)
+ */
+static bool _take_suffix(const uint8_t* cmd, uint16_t* len, char mark, uint32_t max, uint32_t* out) {
+    uint16_t end = (uint16_t)(*len - 1);
+    uint16_t p = end;
+
+    while(p > 1 && cmd[p - 1] >= '0' && cmd[p - 1] <= '9') p--;
+    if(p == end || p < 2 || cmd[p - 1] != (uint8_t)mark) return false;
+    if(s_num_parse_u32((const char*)cmd + p, 0, out) != NUM_OK || *out > max) return false;
+
+    *len = p;
+    return true;
+}
+
+/**
+ * @brief   取出命令结尾的序号 "@<seq>"
+ * @param   cmd 命令
+ * @param   len 命令长度, 带序号时缩短 (见 _take_suffix)
+ * @retval  int16_t 序号 (0 ~ 255), 无序号或超出范围时为 -1
+ */
+static int16_t _take_seq(const uint8_t* cmd, uint16_t* len) {
+    uint32_t seq;
+    return _take_suffix(cmd, len, '@', 255u, &seq) ? (int16_t)seq : -1;
+}
+
+/**
+ * @brief   解析 ASCII 命令: 散列查找命令名并按参数格式解析参数
+ * @param   cmd 命令, 以 '$' 开头
+ * @param   len 命令长度, cmd[len - 1] 为结束符 ('#' 或后缀标记字符)
+ * @param   args 输出参数
+ * @param   slot_out 输出命令所在槽位 (未注册时为 0)
+ * @retval  comms_status_e COMMS_OK, 未注册时为 COMMS_ERR_UNKNOWN, 参数不符时为 COMMS_ERR_ARG
+ * @note    命令名在扫描的同时计算散列, 总开销与命令长度成正比
+ */
+static comms_status_e _parse_ascii(const uint8_t* cmd, uint16_t len, comms_args_t* args, cmd_slot_t** slot_out) {
+    const char* name = (const char*)cmd + 1;
+    const char* end = (const char*)cmd + len - 1;
+    const char* p = name;
+    uint32_t h = FNV_OFFSET;
+
+    while(p < end && *p != ':') {
+        h = (h ^ (uint8_t)*p) * FNV_PRIME;
+        p++;
     }
-    else if(sscanf((char*)cmd, "$GRIP_SET:%f#", &fvalue) == 1) {
-        _gripper->set_angle(_gripper, fvalue);
+    size_t name_len = (size_t)(p - name);
+
+    cmd_slot_t* slot = 0;
+    uint8_t idx = (uint8_t)(h & COMMS_SLOT_MASK);
+    for(uint8_t probes = 0; _slots[idx].cmd && probes < COMMS_CMD_SLOTS; ++probes) {
+        const char* entry_name = _slots[idx].cmd->name;
+        if(_slots[idx].hash == h && strncmp(entry_name, name, name_len) == 0 && entry_name[name_len] == '\0') {
+            slot = &_slots[idx];
+            break;
+        }
+        idx = (uint8_t)((idx + 1) & COMMS_SLOT_MASK);
+    }
+    *slot_out = slot;
+    if(!slot) return COMMS_ERR_UNKNOWN;
+
+    // 参数
+    const char* schema = slot->cmd->args;
+    args->argc = 0;
+    if(*schema) {
+        if(p == end || *p++ != ':') return COMMS_ERR_ARG;
+        for(; *schema; ++schema) {
+            const char* next;
+            num_err_e err;
+            if(args->argc >= COMMS_MAX_ARGS) return COMMS_ERR_ARG;
+            if(*schema == 'f')
+                err = s_num_parse_f32(p, &next, &args->v[args->argc].f);
+            else
+                err = s_num_parse_i32(p, &next, &args->v[args->argc].i);
+            if(err != NUM_OK || next > end) return COMMS_ERR_ARG;
+            args->argc++;
+            p = next;
+            if(schema[1] && *p++ != ',') return COMMS_ERR_ARG;
+        }
+    }
+    return (p == end) ? COMMS_OK : COMMS_ERR_ARG;
+}
+
+/**
+ * @brief   将内置命令的参数转换为消息
+ * @note    整数参数依次填入 id / flag, 浮点参数依次填入 f[]
+ */
+static void _args_to_msg(const comms_cmd_t* cmd, const comms_args_t* args, comms_msg_t* msg) {
+    uint8_t ni = 0, nf = 0;
+
+    msg->type = cmd->msg;
+    msg->seq = 0;
+    msg->id = 0;
+    msg->flag = 0;
+    for(uint8_t k = 0; k < args->argc && cmd->args[k]; ++k) {
+        if(cmd->args[k] == 'f') {
+            if(nf < 5) msg->f[nf++] = args->v[k].f;
+        }
+        else if(ni++ == 0) {
+            msg->id = (uint8_t)args->v[k].i;
+        }
+        else {
+            msg->flag = (uint8_t)(args->v[k].i != 0);
+        }
+    }
+}
+
+/**
+ * @brief   从小端字节序读取单精度浮点数
+ */
+static float _rd_f32(const uint8_t* p) {
+    uint32_t u = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/**
+ * @brief   以小端字节序写入单精度浮点数
+ */
+static void _wr_f32(uint8_t* p, float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    p[0] = (uint8_t)u;
+    p[1] = (uint8_t)(u >> 8);
+    p[2] = (uint8_t)(u >> 16);
+    p[3] = (uint8_t)(u >> 24);
+}
+
+/**
+ * @brief   按消息类型的固定布局解包二进制负载
+ * @param   frame 帧
+ * @param   msg 输出命令
+ * @retval  comms_status_e 状态
+ */
+static comms_status_e _unpack_bin(const proto_bin_frame_t* frame, comms_msg_t* msg) {
+    const uint8_t* p = frame->payload;
+    uint8_t nf = 0;         // 浮点参数个数
+    uint8_t expect = 0;     // 期望负载长度
+
+    msg->type = frame->type;
+    msg->seq = frame->seq;
+    msg->id = 0;
+    msg->flag = 0;
+
+    switch(frame->type) {
+        case COMMS_MSG_LIFT_UP:
+        case COMMS_MSG_LIFT_DOWN:
+        case COMMS_MSG_LIFT_STOP:
+        case COMMS_MSG_ESTOP:
+        case COMMS_MSG_GRIP_OPEN:
+        case COMMS_MSG_GRIP_CLOSE:
+            break;
+        case COMMS_MSG_CLOCK:
+            break;
+        case COMMS_MSG_LIFT_SET:
+        case COMMS_MSG_GRIP_SET:
+            nf = 1;
+            break;
+        case COMMS_MSG_PID_GET:
+            expect = 1;
+            break;
+        case COMMS_MSG_PID_GAIN:
+            expect = 1;
+            nf = 3;
+            break;
+        case COMMS_MSG_PID_PARAM:
+            expect = 1;
+            nf = 5;
+            break;
+        case COMMS_MSG_PID_STREAM:
+            expect = 2;
+            break;
+        default:
+            return COMMS_ERR_UNKNOWN;
+    }
+    if(frame->len != expect + nf * 4u) return COMMS_ERR_LENGTH;
+
+    if(expect >= 1) msg->id = *p++;
+    if(expect >= 2) msg->flag = (uint8_t)(*p++ != 0);
+    for(uint8_t i = 0; i < nf; ++i, p += 4) msg->f[i] = _rd_f32(p);
+    return COMMS_OK;
+}
+
+/**
+ * @brief   解出 AT 帧内层的命令
+ * @param   frame AT 帧
+ * @param   inner 输出内层命令帧 (负载指向 frame 的负载, 序号与 frame 相同)
+ * @param   at_ms 输出执行时刻
+ * @retval  comms_status_e 状态
+ */
+static comms_status_e _unwrap_at(const proto_bin_frame_t* frame, proto_bin_frame_t* inner, uint32_t* at_ms) {
+    const uint8_t* p = frame->payload;
+
+    if(frame->len < 5) return COMMS_ERR_LENGTH;
+    *at_ms = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    inner->type = p[4];
+    inner->seq = frame->seq;
+    inner->payload = p + 5;
+    inner->len = (uint8_t)(frame->len - 5);
+    return COMMS_OK;
+}
+
+/**
+ * @brief   执行命令
+ * @param   msg 命令
+ * @retval  comms_status_e 状态
+ */
+static comms_status_e _execute(const comms_msg_t* msg) {
+    PID* pid;
+
+    switch(msg->type) {
+        case COMMS_MSG_LIFT_UP:
+        case COMMS_MSG_LIFT_DOWN:
+        case COMMS_MSG_LIFT_SET:
+        case COMMS_MSG_GRIP_OPEN:
+        case COMMS_MSG_GRIP_CLOSE:
+        case COMMS_MSG_GRIP_SET:
+            // 抓取流程等上层流程控制升降台与夹爪期间拒绝运动命令
+            if(_busy_hook && _busy_hook()) return COMMS_ERR_BUSY;
+            break;
+        default:
+            break;
+    }
+
+    switch(msg->type) {
+        case COMMS_MSG_LIFT_UP:
+            s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_ERR_ABORTED);
+            _lift_relay->set_dir(_lift_relay, RelayDirA);
+            break;
+        case COMMS_MSG_LIFT_DOWN:
+            s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_ERR_ABORTED);
+            _lift_relay->set_dir(_lift_relay, RelayDirB);
+            break;
+        case COMMS_MSG_LIFT_STOP:
+        case COMMS_MSG_ESTOP:
+            s_wireless_comms_complete(COMMS_DONE_LIFT, COMMS_ERR_ABORTED);
+            _lift_relay->stop(_lift_relay);
+            break;
+        case COMMS_MSG_CLOCK:
+            break;
+        case COMMS_MSG_LIFT_SET:
+            lift_target_pos_mm = msg->f[0];
+            if(_target_hook) _target_hook(msg->f[0]);
+            break;
+        case COMMS_MSG_GRIP_OPEN:
+            _gripper->open(_gripper);
+            break;
+        case COMMS_MSG_GRIP_CLOSE:
+            _gripper->close(_gripper);
+            break;
+        case COMMS_MSG_GRIP_SET:
+            _gripper->set_angle(_gripper, msg->f[0]);
+            break;
+        case COMMS_MSG_PID_GET:
+            if(!s_pid_tuner_get(msg->id)) return COMMS_ERR_ARG;
+            break;
+        case COMMS_MSG_PID_GAIN:
+            pid = s_pid_tuner_get(msg->id);
+            if(!pid) return COMMS_ERR_ARG;
+            pid->set_gains(pid, msg->f[0], msg->f[1], msg->f[2]);
+            break;
+        case COMMS_MSG_PID_PARAM:
+            pid = s_pid_tuner_get(msg->id);
+            if(!pid) return COMMS_ERR_ARG;
+            pid->set_params(pid, msg->f[0], msg->f[1], msg->f[2], msg->f[3], msg->f[4]);
+            break;
+        case COMMS_MSG_PID_STREAM:
+            if(!s_pid_tuner_set_stream(msg->id, msg->flag != 0)) return COMMS_ERR_ARG;
+            break;
+        default:
+            return COMMS_ERR_UNKNOWN;
+    }
+    return COMMS_OK;
+}
+
+/**
+ * @brief   将命令加入定时队列
+ * @param   job 命令
+ * @param   at_ms 执行时刻 (控制器 ms)
+ * @retval  comms_status_e 队列已满为 COMMS_ERR_BUSY, 执行时刻与当前相差超过 COMMS_TIMED_HORIZON 为 COMMS_ERR_ARG
+ * @note    已过期的命令在下一个控制周期执行; 执行时刻相同的命令按到达顺序执行
+ */
+static comms_status_e _schedule(const comms_job_t* job, uint32_t at_ms) {
+    int32_t lead = (int32_t)(at_ms - systick_get_ms());
+
+    if(lead > (int32_t)COMMS_TIMED_HORIZON || lead < -(int32_t)COMMS_TIMED_HORIZON) {
+        _timed_stat.rejected++;
+        return COMMS_ERR_ARG;
+    }
+    if(_timed_n >= COMMS_TIMED_SLOTS) {
+        _timed_stat.full++;
+        return COMMS_ERR_BUSY;
+    }
+
+    uint8_t i = _timed_n++;
+    while(i > 0 && (int32_t)(_timed[i - 1].at_ms - at_ms) > 0) {
+        _timed[i] = _timed[i - 1];
+        i--;
+    }
+    _timed[i].at_ms = at_ms;
+    _timed[i].job = *job;
+    return COMMS_OK;
+}
+
+/**
+ * @brief   执行命令并回复
+ * @param   job 命令
+ * @param   timed 定时命令: 入队时已回复 ACK, 执行失败或无需等待动作结束时在此回复 DONE
+ * @note    立即执行的命令回复 ACK / NAK; 运动命令登记完成通知; 查询命令追加数据回复
+ */
+static void _run(const comms_job_t* job, bool timed) {
+    const comms_cmd_t* entry = job->entry;
+    uint8_t type = 0;
+    comms_done_e kind;
+    comms_status_e status;
+
+    s_trace_record(TRACE_EV_CMD, (entry && entry->fn) ? 0 : job->u.msg.type,
+        (uint16_t)(TRACE_SEQ(job->seq) | (timed ? TRACE_SEQ_TIMED : 0)), entry ? _name_hash(entry->name) : 0);
+    PROF_BEGIN(COMMS_EXEC);
+    if(entry && entry->fn) {
+        status = entry->fn(&job->u.args);
+    }
+    else {
+        type = job->u.msg.type;
+        status = _execute(&job->u.msg);
+    }
+    PROF_END(COMMS_EXEC);
+    kind = entry ? (comms_done_e)entry->done : _done_kind(type);
+
+    if(!timed)
+        _reply(job->bin, job->seq, type, status);
+    else if(job->seq >= 0 && (status != COMMS_OK || kind == COMMS_DONE_NONE))
+        _send_done(job->bin, (uint8_t)job->seq, type, status);
+    if(status != COMMS_OK) return;
+    _track(kind, job->bin, job->seq, type);
+
+    switch(type) {
+        case COMMS_MSG_PID_GET:
+        case COMMS_MSG_PID_GAIN:
+        case COMMS_MSG_PID_PARAM:
+            if(job->bin)
+                _send_pid_info((uint8_t)job->seq, job->u.msg.id);
+            else
+                s_pid_tuner_report(job->u.msg.id);
+            break;
+        case COMMS_MSG_CLOCK:
+            _send_clock(job->bin, (uint8_t)job->seq);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief   内置命令的完成通知类别 (与 _builtin_cmds 的 done 列一致)
+ */
+static comms_done_e _done_kind(uint8_t type) {
+    switch(type) {
+        case COMMS_MSG_LIFT_SET:
+            return COMMS_DONE_LIFT;
+        case COMMS_MSG_GRIP_OPEN:
+        case COMMS_MSG_GRIP_CLOSE:
+        case COMMS_MSG_GRIP_SET:
+            return COMMS_DONE_GRIP;
+        default:
+            return COMMS_DONE_NONE;
+    }
+}
+
+/**
+ * @brief   回复命令执行结果
+ * @param   bin 以二进制帧回复
+ * @param   seq 序号, ASCII 命令不带序号 (-1) 时不回复
+ * @param   cmd 命令类型 (二进制 ACK 负载)
+ * @param   status 执行状态
+ */
+static void _reply(bool bin, int16_t seq, uint8_t cmd, comms_status_e status) {
+    s_trace_record(TRACE_EV_REPLY, (uint8_t)status, TRACE_SEQ(seq), cmd);
+    if(bin) {
+        uint8_t ack[2] = { cmd, (uint8_t)status };
+        _send_frame(COMMS_MSG_ACK, (uint8_t)seq, ack, sizeof(ack));
+    }
+    else if(seq < 0) {
+        return;
+    }
+    else if(status == COMMS_OK) {
+        printf("$ACK:%u#", (unsigned)seq);
+    }
+    else {
+        printf("$NAK:%u,%u#", (unsigned)seq, (unsigned)status);
+    }
+}
+
+/**
+ * @brief   发送完成通知
+ * @param   bin 以二进制帧通知
+ * @param   seq 序号
+ * @param   cmd 命令类型 (二进制 DONE 负载)
+ * @param   status 完成状态
+ */
+static void _send_done(bool bin, uint8_t seq, uint8_t cmd, comms_status_e status) {
+    if(bin) {
+        uint8_t payload[2] = { cmd, (uint8_t)status };
+        _send_frame(COMMS_MSG_DONE, seq, payload, sizeof(payload));
+    }
+    else {
+        printf("$DONE:%u,%u#", seq, (unsigned)status);
     }
 }
 
 /**
- * @brief   比较命令字符串
- * @param   cmd 待比较的命令字符串
- * @param   target 目标命令字符串
- * @retval  bool - true:命令匹配, false:命令不匹配
+ * @brief   登记等待完成通知的命令
+ * @param   kind 完成通知类别, COMMS_DONE_NONE 时忽略
+ * @param   bin 以二进制帧通知
+ * @param   seq 序号, ASCII 命令不带序号 (-1) 时只结束上一条
+ * @param   cmd 命令类型
+ * @note    同类别上一条未完成的命令以 COMMS_ERR_ABORTED 结束; 夹爪按预计转动时间到期完成
  */
-static bool _compare_cmd(uint8_t* cmd, const char* target) {
-    while(*target) {
-        if(*cmd++ != *target++) return false;
+static void _track(comms_done_e kind, bool bin, int16_t seq, uint8_t cmd) {
+    if(kind == COMMS_DONE_NONE || kind >= COMMS_DONE_KINDS) return;
+    s_wireless_comms_complete(kind, COMMS_ERR_ABORTED);
+    if(!bin && seq < 0) return;
+
+    comms_pending_t* p = &_pending[kind];
+    p->active = true;
+    p->bin = bin;
+    p->seq = (uint8_t)seq;
+    p->cmd = cmd;
+    p->timed = (kind == COMMS_DONE_GRIP);
+    if(p->timed) p->due_ms = systick_get_ms() + _gripper->get_move_time_ms(_gripper);
+}
+
+/**
+ * @brief   检查到期的完成通知与接收缓冲区溢出
+ * @note    溢出时按最近一条命令的协议发送通知 ($RXOVF:<累计丢弃字节数># 或 RX_OVF 帧),
+ *          上位机据此立即重发未收到 ACK 的命令, 而不必等待超时
+ */
+static void _poll(void) {
+    for(uint8_t k = 0; k < COMMS_DONE_KINDS; ++k) {
+        comms_pending_t* p = &_pending[k];
+        if(p->active && p->timed && (int32_t)(systick_get_ms() - p->due_ms) >= 0) {
+            s_wireless_comms_complete((comms_done_e)k, COMMS_OK);
+        }
     }
 
-    return (*cmd == '\0');
+    uint32_t ovf = usart_rx_overflow(_usart);
+    if(ovf == _rx_ovf_seen) return;
+    _rx_ovf_seen = ovf;
+    if(_last_bin) {
+        uint8_t payload[4] = { (uint8_t)ovf, (uint8_t)(ovf >> 8), (uint8_t)(ovf >> 16), (uint8_t)(ovf >> 24) };
+        _send_frame(COMMS_MSG_RX_OVF, 0, payload, sizeof(payload));
+    }
+    else {
+        printf("$RXOVF:%lu#", (unsigned long)ovf);
+    }
+}
+
+/**
+ * @brief   打包并发送一帧二进制回复
+ */
+static void _send_frame(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len) {
+    uint8_t out[PROTO_BIN_MAX_ENCODED];
+    uint16_t n = s_proto_bin_encode(type, seq, payload, len, out, sizeof(out));
+    if(n) usart_write(_usart, out, n);
+}
+
+/**
+ * @brief   以二进制帧回复 PID 参数
+ */
+static void _send_pid_info(uint8_t seq, uint8_t id) {
+    const PID* pid = s_pid_tuner_get(id);
+    if(!pid) return;
+
+    const float values[8] = {
+        pid->kp_, pid->ki_, pid->kd_, pid->max_out_, pid->integral_separation_,
+        pid->dead_band_, pid->diff_filter_alpha_, pid->output_max_rate_,
+    };
+    uint8_t payload[3 + sizeof(values)];
+    payload[0] = id;
+    payload[1] = pid->mode_;
+    payload[2] = pid->features_;
+    for(uint8_t i = 0; i < 8; ++i) _wr_f32(&payload[3 + i * 4], values[i]);
+    _send_frame(COMMS_MSG_PID_INFO, seq, payload, sizeof(payload));
+}
+
+/**
+ * @brief   回复控制器时间, 上位机以收发时刻的中点估计时钟偏差
+ * @param   bin 以二进制帧 (CLOCK_INFO) 回复, 否则回复 $CLOCK:<ms>#
+ * @param   seq 序号
+ */
+static void _send_clock(bool bin, uint8_t seq) {
+    uint32_t now = systick_get_ms();
+
+    if(bin) {
+        uint8_t payload[4] = { (uint8_t)now, (uint8_t)(now >> 8), (uint8_t)(now >> 16), (uint8_t)(now >> 24) };
+        _send_frame(COMMS_MSG_CLOCK_INFO, seq, payload, sizeof(payload));
+    }
+    else {
+        printf("$CLOCK:%lu#", (unsigned long)now);
+    }
+}
+
+/**
+ * @brief   累计一次解析耗时
+ */
+static void _stat_add(parse_stat_t* st, uint32_t cyc, uint32_t bytes) {
+    st->n++;
+    st->bytes += bytes;
+    st->sum_cyc += cyc;
+    if(cyc > st->max_cyc) st->max_cyc = cyc;
+}
+
+/**
+ * @brief   命令名的 FNV-1a 散列 (命令表散列与跟踪记录共用)
+ */
+static uint32_t _name_hash(const char* name) {
+    uint32_t h = FNV_OFFSET;
+    for(const char* p = name; *p; ++p) h = (h ^ (uint8_t)*p) * FNV_PRIME;
+    return h;
+}
+
+/**
+ * @brief   $COMMS_STATS# : 输出协议统计
+ * @note    格式: $COMMS:<ASCII 命令数>,<ASCII 字节数>,<ASCII 平均/最大解析周期>,
+ *                <二进制帧数>,<二进制字节数>,<二进制平均/最大解析周期>,<CRC 错误>,<帧错误>,
+ *                <超长命令数>,<接收缓冲区溢出字节数>,<重新同步次数>,<扫描字节数>,<扫描速率 (字节/秒)>#
+ *          ASCII 解析周期为命令查表与数值解析的耗时; 二进制为收到定界符后 CRC 校验与解包的耗时
+ *          (COBS 解码逐字节进行, 分摊在接收过程中); 均不含命令执行;
+ *          扫描速率为接收缓冲区逐字节扫描 (查找定界符与 COBS 解码) 的吞吐, 按 CPU 满负荷折算
+ */
+static comms_status_e _cmd_comms_stats(const comms_args_t* args) {
+    (void)args;
+    const parse_stat_t* a = &_ascii_stat;
+    const parse_stat_t* b = &_bin_stat;
+    printf("$COMMS:%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu#",
+        (unsigned long)a->n, (unsigned long)a->bytes,
+        (unsigned long)(a->n ? a->sum_cyc / a->n : 0), (unsigned long)a->max_cyc,
+        (unsigned long)b->n, (unsigned long)b->bytes,
+        (unsigned long)(b->n ? b->sum_cyc / b->n : 0), (unsigned long)b->max_cyc,
+        (unsigned long)_bin_crc_err, (unsigned long)_bin_frame_err,
+        (unsigned long)_line_long, (unsigned long)usart_rx_overflow(_usart),
+        (unsigned long)_rx.resync, (unsigned long)_rx.bytes,
+        (unsigned long)(_rx.cyc ? (uint64_t)_rx.bytes * CPU_FREQ_MHZ * 1000000u / _rx.cyc : 0));
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $CMD_STATS# : 输出每条命令的解析统计
+ * @note    每条已解析过的命令一条: $CMD_STAT:<名称>,<次数>,<平均周期>,<最大周期>#  (查找 + 参数解析)
+ */
+static comms_status_e _cmd_stats(const comms_args_t* args) {
+    (void)args;
+    for(uint8_t i = 0; i < COMMS_CMD_SLOTS; ++i) {
+        const cmd_slot_t* slot = &_slots[i];
+        if(!slot->cmd || !slot->n) continue;
+        printf("$CMD_STAT:%s,%lu,%lu,%lu#", slot->cmd->name, (unsigned long)slot->n,
+            (unsigned long)(slot->sum_cyc / slot->n), (unsigned long)slot->max_cyc);
+    }
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $CMD_BENCH# : 对每条已注册命令构造样例并测量解析耗时
+ * @note    样例的每个参数均为 "1"; 每条命令回复 $CMD_BENCH:<名称>,<散列槽位>,<平均周期>#, 不执行命令
+ */
+static comms_status_e _cmd_bench(const comms_args_t* args) {
+    (void)args;
+    const uint16_t rounds = 100;
+    uint8_t sample[COMMS_LINE_MAX];
+    comms_args_t tmp;
+    cmd_slot_t* slot;
+
+    for(uint8_t i = 0; i < COMMS_CMD_SLOTS; ++i) {
+        const comms_cmd_t* entry = _slots[i].cmd;
+        if(!entry) continue;
+
+        int n = snprintf((char*)sample, sizeof(sample), "$%s", entry->name);
+        for(const char* a = entry->args; *a && n < (int)sizeof(sample) - 3; ++a) {
+            sample[n++] = (a == entry->args) ? ':' : ',';
+            sample[n++] = '1';
+        }
+        sample[n++] = '#';
+
+        uint32_t start = dwt_get_cycles();
+        for(uint16_t k = 0; k < rounds; ++k) _parse_ascii(sample, (uint16_t)n, &tmp, &slot);
+        uint32_t cyc = (dwt_get_cycles() - start) / rounds;
+        printf("$CMD_BENCH:%s,%u,%lu#", entry->name, i, (unsigned long)cyc);
+    }
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TIMED_STATS# : 输出定时命令统计
+ * @note    格式: $TIMED:<排队数>,<已执行数>,<平均/最小/最大误差 ms>,<队列满次数>,<超出时限次数>#,
+ *          误差为实际执行时刻减请求时刻, 负值表示提前
+ */
+static comms_status_e _cmd_timed_stats(const comms_args_t* args) {
+    (void)args;
+    const timed_stat_t* st = &_timed_stat;
+    char avg[NUM_FMT_BUF_SIZE];
+
+    s_num_fmt_f32(avg, st->n ? (float)st->err_sum / (float)st->n : 0.0f, 2);
+    printf("$TIMED:%u,%lu,%s,%ld,%ld,%lu,%lu#", _timed_n, (unsigned long)st->n, avg,
+        (long)st->err_min, (long)st->err_max, (unsigned long)st->full, (unsigned long)st->rejected);
+    return COMMS_OK;
+}
+
+/**
+ * @brief   $TIMED_CLEAR# : 取消全部未执行的定时命令 (见 s_wireless_comms_abort_timed)
+ */
+static comms_status_e _cmd_timed_clear(const comms_args_t* args) {
+    (void)args;
+    s_wireless_comms_abort_timed();
+    return COMMS_OK;
 }
@@ -17,9 +17,166 @@
 
 extern float lift_target_pos_mm;
 
+/**
+ * @brief   二进制协议消息类型 (帧格式见 s_proto_bin.h)
+ * @note    命令负载 (小端序):
+ *          LIFT_SET    : f32 目标位置 (mm)
+ *          GRIP_SET    : f32 角度 (rad)
+ *          PID_GET     : u8 id
+ *          PID_GAIN    : u8 id, f32 kp, f32 ki, f32 kd
+ *          PID_PARAM   : u8 id, f32 max_out, f32 integral_separation, f32 dead_band, f32 diff_filter_alpha, f32 output_max_rate
+ *          PID_STREAM  : u8 id, u8 enable
+ *          AT          : u32 执行时刻 (控制器 ms), u8 命令类型, 该命令的负载; 定时执行 (见 COMMS_TIMED_SLOTS)
+ *          其余命令 (含 CLOCK, ESTOP) 无负载
+ * @note    ESTOP 与 $ESTOP# 另由 s_estop 在接收中断中识别并立即断开继电器, 此处的执行与 LIFT_STOP 相同, 只负责应答
+ * @note    回复:
+ *          ACK         : u8 命令类型, u8 状态 (comms_status_e), 序号与命令相同; 状态非 0 即为 NAK
+ *          DONE        : u8 命令类型, u8 状态, 序号与命令相同; 运动命令 (LIFT_SET, GRIP_*) 在动作结束后发送,
+ *                        定时命令 (AT) 的其余命令在执行后发送
+ *          RX_OVF      : u32 累计丢弃字节数, 序号为 0; 串口接收缓冲区溢出后发送
+ *          PID_INFO    : u8 id, u8 mode, u8 features, f32 kp, ki, kd, max_out, integral_separation,
+ *                        dead_band, diff_filter_alpha, output_max_rate (PID_GET/GAIN/PARAM 成功后发送)
+ *          CLOCK_INFO  : u32 控制器时间 (ms), 序号与 CLOCK 命令相同
+ *          TELEMETRY   : 遥测帧, 由 s_telemetry 周期发送 (负载见 s_telemetry.h)
+ *          LOG         : 延迟日志记录, 由 s_log 在后台发送 (负载见 s_log.h)
+ *          TRACE_INFO / TRACE : 跟踪记录导出, 由 s_trace 在 $TRACE_DUMP# 后发送 (负载见 s_trace.h)
+ *          PID_SAMPLE  : PID 流式数据, 由 s_pid_tuner 每个控制周期发送 (负载见 s_pid_tuner.h)
+ *          WAVE        : 波形数据 f32 × n, 由 s_log_wave 在独立日志串口上发送 (见 s_log.h)
+ */
+typedef enum {
+    COMMS_MSG_NONE          = 0x00,
+    COMMS_MSG_LIFT_UP       = 0x01,
+    COMMS_MSG_LIFT_DOWN     = 0x02,
+    COMMS_MSG_LIFT_STOP     = 0x03,
+    COMMS_MSG_LIFT_SET      = 0x04,
+    COMMS_MSG_CLOCK         = 0x05,
+    COMMS_MSG_ESTOP         = 0x06,
+    COMMS_MSG_GRIP_OPEN     = 0x10,
+    COMMS_MSG_GRIP_CLOSE    = 0x11,
+    COMMS_MSG_GRIP_SET      = 0x12,
+    COMMS_MSG_PID_GET       = 0x20,
+    COMMS_MSG_PID_GAIN      = 0x21,
+    COMMS_MSG_PID_PARAM     = 0x22,
+    COMMS_MSG_PID_STREAM    = 0x23,
+    COMMS_MSG_AT            = 0x30,
+    COMMS_MSG_ACK           = 0x80,
+    COMMS_MSG_DONE          = 0x81,
+    COMMS_MSG_RX_OVF        = 0x82,
+    COMMS_MSG_PID_INFO      = 0xA0,
+    COMMS_MSG_TELEMETRY     = 0xA1,
+    COMMS_MSG_CLOCK_INFO    = 0xA2,
+    COMMS_MSG_LOG           = 0xA3,
+    COMMS_MSG_TRACE_INFO    = 0xA4,
+    COMMS_MSG_TRACE         = 0xA5,
+    COMMS_MSG_PID_SAMPLE    = 0xA6,
+    COMMS_MSG_WAVE          = 0xA7,
+} comms_msg_e;
+
+/**
+ * @brief   命令执行状态
+ */
+typedef enum {
+    COMMS_OK = 0,
+    COMMS_ERR_UNKNOWN,      // 未知命令
+    COMMS_ERR_LENGTH,       // 负载长度不符
+    COMMS_ERR_ARG,          // 参数无效
+    COMMS_ERR_BUSY,         // 当前状态不能执行
+    COMMS_ERR_ABORTED,      // 动作被后续命令取代或被中止 (仅 DONE)
+    COMMS_ERR_FAULT,        // 动作因故障未完成 (仅 DONE)
+} comms_status_e;
+
+/**
+ * @brief   完成通知类别: 同一类别同时只跟踪一条命令, 新命令会以 COMMS_ERR_ABORTED 结束上一条
+ */
+typedef enum {
+    COMMS_DONE_NONE = 0,    // 回复 ACK 即已完成
+    COMMS_DONE_LIFT,        // 升降台到达目标位置
+    COMMS_DONE_GRIP,        // 夹爪转动结束
+    COMMS_DONE_PICK,        // 抓取流程结束
+    COMMS_DONE_KINDS,
+} comms_done_e;
+
+/**
+ * @brief   已解析的命令 (ASCII 与二进制协议共用)
+ */
+typedef struct {
+    uint8_t type;           // comms_msg_e
+    uint8_t seq;            // 序号
+    uint8_t id;             // PID 实例 ID
+    uint8_t flag;           // 开关参数
+    float f[5];             // 浮点参数
+} comms_msg_t;
+
+// ASCII 命令最大参数个数 / 命令散列表槽数 (必须为 2 的幂, 且大于注册命令总数)
+#define COMMS_MAX_ARGS      6
+#define COMMS_CMD_SLOTS     64
+// ASCII 命令最大长度 (含 '$' 与 '#')
+#define COMMS_LINE_MAX      128
+// 发送窗口: 上位机最多可连续发送的未收到 ACK/NAK 的命令数 (接收缓冲区按此容量保证不溢出)
+#define COMMS_WINDOW        4
+// 单次 s_wireless_comms_process 最多处理的帧数, 其余留在接收缓冲区中, 避免突发数据占满一个主循环
+#define COMMS_PROCESS_BUDGET 4
+// 定时命令队列容量 / 执行时刻与当前时间的最大间隔 (ms, 超出视为时钟未同步而拒绝)
+#define COMMS_TIMED_SLOTS   8
+#define COMMS_TIMED_HORIZON 600000u
+
+/**
+ * @brief   ASCII 命令参数 (按参数格式依次存放)
+ */
+typedef struct {
+    uint8_t argc;
+    union {
+        float f;
+        int32_t i;
+    } v[COMMS_MAX_ARGS];
+} comms_args_t;
+
+/**
+ * @brief   ASCII 命令处理函数
+ * @param   args 已按参数格式解析的参数
+ * @retval  comms_status_e 执行状态, 命令带序号时据此回复 ACK 或 NAK
+ */
+typedef comms_status_e(*comms_cmd_fn_t)(const comms_args_t* args);
+
+/**
+ * @brief   ASCII 命令表项
+ * @note    命令格式 $<name>#  或  $<name>:<arg>,<arg>,...#, 可在 '#' 前附加执行时刻 !<ms> 与序号 @<0~255>
+ *          (顺序为 !<ms>@<seq>); 带执行时刻的命令进入定时队列, 由 s_wireless_comms_tick 按时执行;
+ *          带序号的命令回复 $ACK:<seq>#  或  $NAK:<seq>,<状态>#, done 不为 COMMS_DONE_NONE 时
+ *          动作结束后再回复 $DONE:<seq>,<状态>#; 定时命令入队时回复 ACK, 其余命令执行后即回复 DONE;
+ *          args 为参数格式, 每个字符对应一个参数: 'f' 浮点, 'i' 整数; "" 表示无参数;
+ *          内置命令 fn 为 0, 按 msg 指定的消息类型与二进制协议共用执行路径
+ */
+typedef struct {
+    const char* name;       // 命令名 (不含 '$', ':' 与 '#')
+    const char* args;       // 参数格式
+    comms_cmd_fn_t fn;      // 处理函数
+    uint8_t msg;            // 内置命令的消息类型 (comms_msg_e)
+    uint8_t done;           // 完成通知类别 (comms_done_e)
+} comms_cmd_t;
+
+/**
+ * @brief   升降台目标位置变更通知
+ * @param   target 新的目标位置 (mm)
+ */
+typedef void(*comms_target_hook_t)(float target);
+
+/**
+ * @brief   运动命令忙碌判断
+ * @retval  bool - true:升降台与夹爪由上层流程控制, 运动命令回复 COMMS_ERR_BUSY
+ */
+typedef bool(*comms_busy_hook_t)(void);
+
 // ! ========================= 接 口 函 数 声 明 ========================= ! //
 
 void s_wireless_comms_init(usart_t* usart, Relay* lift_relay, Gripper* gripper);
-bool s_wireless_comms_process(void);
+uint8_t s_wireless_comms_process(void);
+bool s_wireless_comms_rx_pending(void);
+bool s_wireless_comms_register(const comms_cmd_t* table, uint8_t count);
+void s_wireless_comms_set_target_hook(comms_target_hook_t hook);
+void s_wireless_comms_set_busy_hook(comms_busy_hook_t hook);
+void s_wireless_comms_complete(comms_done_e kind, comms_status_e status);
+void s_wireless_comms_tick(uint32_t period_ms);
+void s_wireless_comms_abort_timed(void);
 
 #endif
@@ -0,0 +1,247 @@
+/**
+ * @file    stm32f10x.h
+ * @brief   主机测试用设备头文件替身
+ *          只提供被测模块用到的外设类型、标准外设库声明与 CMSIS 内建函数;
+ *          SysTick / SCB / CoreDebug / DWT 指向主机变量 (stub.c), 测试可直接读写,
+ *          其余外设地址仅用于编译, 不可访问
+ */
+#ifndef _stm32f10x_stub_h_
+#define _stm32f10x_stub_h_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ! ========================= 标 准 外 设 库 (仅 声 明) ========================= ! //
+
+typedef enum {RESET=0, SET=!RESET} FlagStatus, ITStatus;
+typedef enum {DISABLE=0, ENABLE=!DISABLE} FunctionalState;
+typedef struct { volatile uint32_t CRL,CRH,IDR,ODR,BSRR,BRR,LCKR; } GPIO_TypeDef;
+typedef struct { volatile uint16_t SR,r0,DR,r1,BRR,r2,CR1,r3,CR2,r4,CR3,r5,GTPR,r6; } USART_TypeDef;
+typedef struct { volatile uint32_t MCR; } CAN_TypeDef;
+typedef struct { volatile uint16_t CR1; } TIM_TypeDef;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+typedef struct { volatile uint32_t IDCODE, CR; } DBGMCU_TypeDef;
+typedef struct { volatile uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+typedef struct { volatile uint32_t CPUID, ICSR, VTOR, AIRCR, SCR, CCR; volatile uint8_t SHP[12]; volatile uint32_t SHCSR, CFSR, HFSR, DFSR, MMFAR, BFAR, AFSR; } SCB_Type;
+typedef struct { volatile uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR; } EXTI_TypeDef;
+typedef struct { volatile uint32_t DR[10]; } BKP_TypeDef;
+#define GPIOA ((GPIO_TypeDef*)0x40000000UL)
+#define GPIOB ((GPIO_TypeDef*)0x40000400UL)
+#define GPIOC ((GPIO_TypeDef*)0x40000800UL)
+#define USART1 ((USART_TypeDef*)0x40000C00UL)
+#define USART2 ((USART_TypeDef*)0x40001000UL)
+#define USART3 ((USART_TypeDef*)0x40001400UL)
+#define CAN1 ((CAN_TypeDef*)0x40001800UL)
+#define TIM1 ((TIM_TypeDef*)0x40001C00UL)
+#define TIM2 ((TIM_TypeDef*)0x40002000UL)
+#define TIM3 ((TIM_TypeDef*)0x40002400UL)
+#define TIM4 ((TIM_TypeDef*)0x40002800UL)
+#define DBGMCU ((DBGMCU_TypeDef*)0x40003000UL)
+#define EXTI ((EXTI_TypeDef*)0x40003C00UL)
+#define SysTick_CTRL_COUNTFLAG_Msk (1UL<<16)
+#define SCB_ICSR_VECTACTIVE_Msk 0x1FFUL
+#define SCB_AIRCR_VECTKEY_Pos 16
+#define SCB_AIRCR_SYSRESETREQ_Msk (1UL<<2)
+#define DBGMCU_SLEEP 1
+#define DBGMCU_CR_DBG_SLEEP 1
+void DBGMCU_Config(uint32_t, FunctionalState);
+typedef enum { SysTick_IRQn=-1, USART1_IRQn=37, USART2_IRQn, USART3_IRQn, USB_LP_CAN1_RX0_IRQn=20, TIM1_UP_IRQn=25, TIM2_IRQn=28, TIM3_IRQn, TIM4_IRQn, EXTI0_IRQn=6, EXTI1_IRQn, EXTI2_IRQn, EXTI3_IRQn, EXTI4_IRQn, EXTI9_5_IRQn=23, EXTI15_10_IRQn=40, HardFault_IRQn=-13 } IRQn_Type;
+uint32_t SysTick_Config(uint32_t);
+void NVIC_SetPriority(IRQn_Type, uint32_t);
+void NVIC_SystemReset(void);
+#define NVIC_PriorityGroup_2 0x500
+void NVIC_PriorityGroupConfig(uint32_t);
+typedef struct { uint8_t NVIC_IRQChannel, NVIC_IRQChannelPreemptionPriority, NVIC_IRQChannelSubPriority; FunctionalState NVIC_IRQChannelCmd; } NVIC_InitTypeDef;
+void NVIC_Init(NVIC_InitTypeDef*);
+#define RCC_APB2Periph_GPIOA 4
+#define RCC_APB2Periph_GPIOB 8
+#define RCC_APB2Periph_AFIO 1
+#define RCC_APB2Periph_USART1 0x4000
+#define RCC_APB1Periph_USART2 0x20000
+#define RCC_APB1Periph_USART3 0x40000
+#define RCC_APB1Periph_CAN1 0x2000000
+#define RCC_APB2Periph_TIM1 0x800
+#define RCC_APB1Periph_TIM2 1
+#define RCC_APB1Periph_TIM3 2
+#define RCC_APB1Periph_TIM4 4
+void RCC_APB2PeriphClockCmd(uint32_t, FunctionalState);
+void RCC_APB1PeriphClockCmd(uint32_t, FunctionalState);
+typedef enum { GPIO_Mode_AIN=0, GPIO_Mode_IN_FLOATING=4, GPIO_Mode_IPD=0x28, GPIO_Mode_IPU=0x48, GPIO_Mode_Out_OD=0x14, GPIO_Mode_Out_PP=0x10, GPIO_Mode_AF_OD=0x1C, GPIO_Mode_AF_PP=0x18 } GPIOMode_TypeDef;
+typedef enum { GPIO_Speed_10MHz=1, GPIO_Speed_2MHz, GPIO_Speed_50MHz } GPIOSpeed_TypeDef;
+typedef struct { uint16_t GPIO_Pin; GPIOSpeed_TypeDef GPIO_Speed; GPIOMode_TypeDef GPIO_Mode; } GPIO_InitTypeDef;
+#define GPIO_Pin_0 0x1
+#define GPIO_Pin_1 0x2
+#define GPIO_Pin_2 0x4
+#define GPIO_Pin_3 0x8
+#define GPIO_Pin_9 0x200
+#define GPIO_Pin_10 0x400
+#define GPIO_Pin_11 0x800
+#define GPIO_Pin_12 0x1000
+#define GPIO_Pin_13 0x2000
+#define GPIO_PortSourceGPIOA 0
+#define GPIO_PortSourceGPIOB 1
+void GPIO_Init(GPIO_TypeDef*, GPIO_InitTypeDef*);
+void GPIO_SetBits(GPIO_TypeDef*, uint16_t);
+void GPIO_ResetBits(GPIO_TypeDef*, uint16_t);
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef*, uint16_t);
+void GPIO_EXTILineConfig(uint8_t, uint8_t);
+typedef enum { EXTI_Mode_Interrupt=0, EXTI_Mode_Event=4 } EXTIMode_TypeDef;
+typedef enum { EXTI_Trigger_Rising=8, EXTI_Trigger_Falling=0xC, EXTI_Trigger_Rising_Falling=0x10 } EXTITrigger_TypeDef;
+typedef struct { uint32_t EXTI_Line; EXTIMode_TypeDef EXTI_Mode; EXTITrigger_TypeDef EXTI_Trigger; FunctionalState EXTI_LineCmd; } EXTI_InitTypeDef;
+void EXTI_Init(EXTI_InitTypeDef*);
+ITStatus EXTI_GetITStatus(uint32_t);
+void EXTI_ClearITPendingBit(uint32_t);
+#define USART_WordLength_8b 0
+#define USART_StopBits_1 0
+#define USART_Parity_No 0
+#define USART_HardwareFlowControl_None 0
+#define USART_Mode_Rx 4
+#define USART_Mode_Tx 8
+typedef struct { uint32_t USART_BaudRate; uint16_t USART_WordLength, USART_StopBits, USART_Parity, USART_Mode, USART_HardwareFlowControl; } USART_InitTypeDef;
+void USART_DeInit(USART_TypeDef*);
+void USART_Init(USART_TypeDef*, USART_InitTypeDef*);
+void USART_ITConfig(USART_TypeDef*, uint16_t, FunctionalState);
+void USART_Cmd(USART_TypeDef*, FunctionalState);
+FlagStatus USART_GetFlagStatus(USART_TypeDef*, uint16_t);
+ITStatus USART_GetITStatus(USART_TypeDef*, uint16_t);
+void USART_ClearITPendingBit(USART_TypeDef*, uint16_t);
+void USART_SendData(USART_TypeDef*, uint16_t);
+uint16_t USART_ReceiveData(USART_TypeDef*);
+#define USART_IT_RXNE 0x525
+#define USART_IT_TXE 0x727
+#define USART_IT_ORE 0x360
+#define USART_FLAG_TC 0x40
+#define USART_FLAG_TXE 0x80
+#define USART_FLAG_ORE 0x08
+#define CAN_Mode_Normal 0
+#define CAN_Mode_LoopBack 1
+#define CAN_Mode_Silent 2
+#define CAN_Mode_Silent_LoopBack 3
+#define CAN_SJW_1tq 0
+#define CAN_BS1_7tq 6
+#define CAN_BS2_1tq 0
+#define CAN_FilterMode_IdMask 0
+#define CAN_FilterScale_32bit 1
+#define CAN_FilterFIFO0 0
+#define CAN_FIFO0 0
+#define CAN_ID_STD 0
+#define CAN_RTR_DATA 0
+#define CAN_TxStatus_NoMailBox 4
+#define CAN_TxStatus_Ok 1
+#define CAN_IT_FMP0 2
+typedef struct { uint16_t CAN_Prescaler; uint8_t CAN_Mode, CAN_SJW, CAN_BS1, CAN_BS2; FunctionalState CAN_TTCM, CAN_ABOM, CAN_AWUM, CAN_NART, CAN_RFLM, CAN_TXFP; } CAN_InitTypeDef;
+typedef struct { uint16_t CAN_FilterIdHigh, CAN_FilterIdLow, CAN_FilterMaskIdHigh, CAN_FilterMaskIdLow, CAN_FilterFIFOAssignment; uint8_t CAN_FilterNumber, CAN_FilterMode, CAN_FilterScale; FunctionalState CAN_FilterActivation; } CAN_FilterInitTypeDef;
+typedef struct { uint32_t StdId, ExtId; uint8_t IDE, RTR, DLC, Data[8]; } CanTxMsg;
+typedef struct { uint32_t StdId, ExtId; uint8_t IDE, RTR, DLC, Data[8], FMI; } CanRxMsg;
+uint8_t CAN_Init(CAN_TypeDef*, CAN_InitTypeDef*);
+void CAN_FilterInit(CAN_FilterInitTypeDef*);
+void CAN_ITConfig(CAN_TypeDef*, uint32_t, FunctionalState);
+uint8_t CAN_Transmit(CAN_TypeDef*, CanTxMsg*);
+uint8_t CAN_TransmitStatus(CAN_TypeDef*, uint8_t);
+void CAN_Receive(CAN_TypeDef*, uint8_t, CanRxMsg*);
+ITStatus CAN_GetITStatus(CAN_TypeDef*, uint32_t);
+void CAN_ClearITPendingBit(CAN_TypeDef*, uint32_t);
+#define TIM_CKD_DIV1 0
+#define TIM_CounterMode_Up 0
+#define TIM_FLAG_Update 1
+#define TIM_IT_Update 1
+#define TIM_Channel_1 0
+#define TIM_Channel_2 4
+#define TIM_Channel_3 8
+#define TIM_Channel_4 12
+#define TIM_OCPreload_Enable 8
+#define TIM_ICPolarity_Rising 0
+#define TIM_EncoderMode_TI12 3
+typedef struct { uint16_t TIM_Prescaler, TIM_CounterMode, TIM_Period, TIM_ClockDivision; uint8_t TIM_RepetitionCounter; } TIM_TimeBaseInitTypeDef;
+typedef struct { uint16_t TIM_Channel, TIM_ICPolarity, TIM_ICSelection, TIM_ICPrescaler, TIM_ICFilter; } TIM_ICInitTypeDef;
+typedef struct { uint16_t TIM_OCMode, TIM_OutputState, TIM_OutputNState, TIM_Pulse, TIM_OCPolarity; } TIM_OCInitTypeDef;
+void TIM_InternalClockConfig(TIM_TypeDef*);
+void TIM_TimeBaseInit(TIM_TypeDef*, TIM_TimeBaseInitTypeDef*);
+void TIM_ClearFlag(TIM_TypeDef*, uint16_t);
+void TIM_ITConfig(TIM_TypeDef*, uint16_t, FunctionalState);
+void TIM_ICStructInit(TIM_ICInitTypeDef*);
+void TIM_ICInit(TIM_TypeDef*, TIM_ICInitTypeDef*);
+void TIM_EncoderInterfaceConfig(TIM_TypeDef*, uint16_t, uint16_t, uint16_t);
+void TIM_SetCounter(TIM_TypeDef*, uint16_t);
+uint16_t TIM_GetCounter(TIM_TypeDef*);
+void TIM_OCStructInit(TIM_OCInitTypeDef*);
+void TIM_OC1Init(TIM_TypeDef*, TIM_OCInitTypeDef*);
+void TIM_OC2Init(TIM_TypeDef*, TIM_OCInitTypeDef*);
+void TIM_OC3Init(TIM_TypeDef*, TIM_OCInitTypeDef*);
+void TIM_OC4Init(TIM_TypeDef*, TIM_OCInitTypeDef*);
+void TIM_OC1PreloadConfig(TIM_TypeDef*, uint16_t);
+void TIM_OC2PreloadConfig(TIM_TypeDef*, uint16_t);
+void TIM_OC3PreloadConfig(TIM_TypeDef*, uint16_t);
+void TIM_OC4PreloadConfig(TIM_TypeDef*, uint16_t);
+void TIM_ARRPreloadConfig(TIM_TypeDef*, FunctionalState);
+void TIM_Cmd(TIM_TypeDef*, FunctionalState);
+FlagStatus TIM_GetFlagStatus(TIM_TypeDef*, uint16_t);
+void TIM_ClearITPendingBit(TIM_TypeDef*, uint16_t);
+
+#define RCC_FLAG_PINRST ((uint8_t)0x7A)
+#define RCC_FLAG_PORRST ((uint8_t)0x7B)
+#define RCC_FLAG_SFTRST ((uint8_t)0x7C)
+#define RCC_FLAG_IWDGRST ((uint8_t)0x7D)
+#define RCC_FLAG_WWDGRST ((uint8_t)0x7E)
+#define RCC_FLAG_LPWRRST ((uint8_t)0x7F)
+FlagStatus RCC_GetFlagStatus(uint8_t);
+void RCC_ClearFlag(void);
+
+// ! ========================= 内 核 外 设 (主 机 变 量) ========================= ! //
+
+typedef struct {
+    volatile uint32_t CTRL, CYCCNT, CPICNT, EXCCNT, SLEEPCNT, LSUCNT, FOLDCNT, PCSR;
+} DWT_Type;
+
+extern SysTick_Type stub_systick;
+extern SCB_Type stub_scb;
+extern CoreDebug_Type stub_coredebug;
+extern DWT_Type stub_dwt;
+
+#define SysTick     (&stub_systick)
+#define SCB         (&stub_scb)
+#define CoreDebug   (&stub_coredebug)
+#define DWT_BASE    ((uintptr_t)&stub_dwt)
+#define DWT         (&stub_dwt)
+
+// ! ========================= CMSIS 内 建 函 数 (stub.c) ========================= ! //
+
+/**
+ * @brief   抢占注入点: 测试在这些位置模拟中断
+ */
+typedef enum {
+    STUB_AT_LDREX = 0,      // LDREX 读取之后
+    STUB_AT_STREX,          // STREX 写入之前
+    STUB_AT_DMB,            // 内存屏障 (写入数据与发布之间)
+} stub_site_e;
+
+/**
+ * @brief   抢占钩子
+ * @param   site 注入点
+ * @retval  bool - true:钩子中执行了 "中断", 独占监视器被清除 (随后的 STREX 失败)
+ */
+extern bool (*stub_preempt)(stub_site_e site);
+
+static inline uint32_t __CLZ(uint32_t v) { return v ? (uint32_t)__builtin_clz(v) : 32u; }
+uint32_t __LDREXW(volatile uint32_t* addr);
+uint32_t __STREXW(uint32_t val, volatile uint32_t* addr);
+uint16_t __LDREXH(volatile uint16_t* addr);
+uint32_t __STREXH(uint16_t val, volatile uint16_t* addr);
+uint8_t __LDREXB(volatile uint8_t* addr);
+uint32_t __STREXB(uint8_t val, volatile uint8_t* addr);
+void __CLREX(void);
+void __DMB(void);
+void __DSB(void);
+void __ISB(void);
+void __WFI(void);
+void __WFE(void);
+void __NOP(void);
+void __disable_irq(void);
+void __enable_irq(void);
+uint32_t __get_PRIMASK(void);
+void __set_PRIMASK(uint32_t primask);
+uint32_t __get_IPSR(void);
+uint32_t __get_MSP(void);
+uint32_t __get_PSP(void);
+
+#endif
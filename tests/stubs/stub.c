@@ -0,0 +1,118 @@
+/**
+ * @file    stub.c
+ * @brief   主机测试用内核外设变量与 CMSIS 内建函数
+ * @note    LDREX/STREX 以独占标志模拟: 抢占钩子返回 true (执行了 "中断") 时清除标志,
+ *          随后的 STREX 失败, 与 Cortex-M3 异常进入/返回时清除本地独占监视器的行为一致
+ */
+#include "stm32f10x.h"
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+SysTick_Type stub_systick;
+SCB_Type stub_scb;
+CoreDebug_Type stub_coredebug;
+DWT_Type stub_dwt;
+
+bool (*stub_preempt)(stub_site_e site) = 0;
+
+static bool _exclusive = false;
+static uint32_t _primask = 0;
+
+// ! ========================= 私 有 函 数 声 明 ========================= ! //
+
+static void _preempt(stub_site_e site);
+
+// ! ========================= 接 口 函 数 实 现 ========================= ! //
+
+uint32_t __LDREXW(volatile uint32_t* addr) {
+    uint32_t v = *addr;
+    _exclusive = true;
+    _preempt(STUB_AT_LDREX);
+    return v;
+}
+
+uint32_t __STREXW(uint32_t val, volatile uint32_t* addr) {
+    _preempt(STUB_AT_STREX);
+    if(!_exclusive) return 1;
+    _exclusive = false;
+    *addr = val;
+    return 0;
+}
+
+uint16_t __LDREXH(volatile uint16_t* addr) {
+    _exclusive = true;
+    return *addr;
+}
+
+uint32_t __STREXH(uint16_t val, volatile uint16_t* addr) {
+    if(!_exclusive) return 1;
+    _exclusive = false;
+    *addr = val;
+    return 0;
+}
+
+uint8_t __LDREXB(volatile uint8_t* addr) {
+    _exclusive = true;
+    return *addr;
+}
+
+uint32_t __STREXB(uint8_t val, volatile uint8_t* addr) {
+    if(!_exclusive) return 1;
+    _exclusive = false;
+    *addr = val;
+    return 0;
+}
+
+void __CLREX(void) {
+    _exclusive = false;
+}
+
+void __DMB(void) {
+    _preempt(STUB_AT_DMB);
+}
+
+void __DSB(void) {}
+void __ISB(void) {}
+void __WFI(void) {}
+void __WFE(void) {}
+void __NOP(void) {}
+
+void __disable_irq(void) {
+    _primask = 1;
+}
+
+void __enable_irq(void) {
+    _primask = 0;
+}
+
+uint32_t __get_PRIMASK(void) {
+    return _primask;
+}
+
+void __set_PRIMASK(uint32_t primask) {
+    _primask = primask;
+}
+
+uint32_t __get_IPSR(void) {
+    return 0;
+}
+
+uint32_t __get_MSP(void) {
+    return 0;
+}
+
+uint32_t __get_PSP(void) {
+    return 0;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   在注入点调用抢占钩子 (关中断期间不抢占)
+ */
+static void _preempt(stub_site_e site) {
+    if(!stub_preempt || _primask) return;
+    bool saved = _exclusive;
+    if(stub_preempt(site)) saved = false;
+    _exclusive = saved;
+}
@@ -0,0 +1,2 @@
+// Keil 在 Windows 下不区分文件名大小写, 主机上转发到 sysTick.h
+#include "../../src/hal/sysTick.h"
@@ -0,0 +1,174 @@
+/**
+ * @file    test_clock.c
+ * @brief   64 位时基 (clock.c / sysTick.c) 的 DWT 回绕模拟测试
+ *          以 64 位 "真实周期数" 模拟 DWT->CYCCNT (只暴露低 32 位), 从回绕前夕开始运行 12 分钟 (约 13 次回绕);
+ *          SysTick 中断可在读取方任意两次读 DWT 之间插入, 主循环偶尔关中断最长 3 ms 使中断推迟/合并;
+ *          检查周期/微秒/毫秒与真实时间一致、单调不减, systick_get_ms 与 64 位毫秒数相符;
+ *          最后模拟 WFI 休眠期间 CYCCNT 停止 (未设置 DBGMCU_SLEEP), 检查毫秒按 SysTick 中断次数推进
+ */
+#include "clock.h"
+#include "systick.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define RUN_MINUTES     12
+#define MASK_MAX_CYC    (3u * CLOCK_CYC_PER_MS)     // 主循环关中断的最长时间
+#define WORK_MAX_CYC    (CLOCK_CYC_PER_MS / 4u)     // 两轮读取之间主循环其他工作的最长时间
+#define SLEEP_MS        500                         // CYCCNT 停止期间的 SysTick 中断次数
+#define ISR_ENTRY_CYC   20u                         // 休眠唤醒时 SysTick 重装后到读取 VAL 的计数
+
+#define CHECK(c) do { if(!(c)) { printf("FAIL %s:%d: %s (t=%llu)\n", __FILE__, __LINE__, #c, \
+    (unsigned long long)_t); exit(1); } } while(0)
+
+static uint64_t _t = 0;             // 真实周期数 (DWT_CYCCNT 为其低 32 位)
+static uint64_t _next_tick = 0;     // 下一次 SysTick 事件的真实时刻
+static bool _pending = false;       // SysTick 已到期, 中断尚未执行
+static bool _in_isr = false;
+static bool _inject = false;        // 允许在读 DWT 时插入中断 (关中断时为 false)
+static bool _frozen = false;        // 初始化期间时间不走
+
+// ! ========================= 外 部 依 赖 替 身 ========================= ! //
+
+void SysTick_Handler(void);                  // sysTick.c, 由中断向量表引用, 无头文件声明
+
+uint32_t SysTick_Config(uint32_t ticks) { return 0; }
+void NVIC_SetPriority(IRQn_Type irq, uint32_t prio) {}
+
+static void _isr(void) {
+    _in_isr = true;
+    SysTick_Handler();
+    _in_isr = false;
+    _pending = false;
+}
+
+/**
+ * @brief   DWT 周期计数: 每次读取时间前进 1~40 周期, 到期的 SysTick 中断可能恰好在此插入
+ */
+uint32_t dwt_get_cycles(void) {
+    if(_frozen) return (uint32_t)_t;
+    _t += 1u + (uint32_t)(rand() % 40);
+    if(_t >= _next_tick) {
+        _pending = true;
+        _next_tick += CLOCK_CYC_PER_MS;
+    }
+    if(!_in_isr && _inject && _pending && rand() % 3 == 0) _isr();
+    return (uint32_t)_t;
+}
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   主循环的其他工作: 时间快速前进, 到期的 SysTick 中断立即执行 (关中断时只挂起)
+ */
+static void _work(uint32_t cyc) {
+    uint64_t end = _t + cyc;
+    while(_next_tick <= end) {
+        _t = _next_tick;
+        _next_tick += CLOCK_CYC_PER_MS;
+        _pending = true;
+        if(_inject) _isr();
+    }
+    if(_t < end) _t = end;
+}
+
+/**
+ * @brief   主循环关中断一段时间: 期间 SysTick 可能到期多次, 开中断后只执行一次 (合并)
+ */
+static void _mask_irq(uint32_t cyc) {
+    uint64_t end = _t + cyc;
+    _inject = false;
+    while(_t < end) dwt_get_cycles();
+    _inject = true;
+}
+
+/**
+ * @brief   休眠期间 CYCCNT 停止: 每次 SysTick 中断计入 1 ms; 唤醒后按周期数继续, 毫秒不丢失不重复
+ */
+static void _test_sleep_stall(void) {
+    _inject = false;
+    _frozen = true;
+    if(_pending) _isr();
+    uint64_t ms0 = clock_get_ms();
+
+    stub_systick.VAL = stub_systick.LOAD - ISR_ENTRY_CYC;
+    for(uint32_t k = 1; k <= SLEEP_MS; ++k) {
+        _isr();
+        CHECK(clock_get_ms() == ms0 + k && systick_get_ms() == (uint32_t)(ms0 + k));
+    }
+
+    // 唤醒: 当前毫秒起点为 ISR_ENTRY_CYC 个周期之前, 此后按周期数推进
+    const uint64_t base = _t - ISR_ENTRY_CYC;
+    const uint64_t ms1 = ms0 + SLEEP_MS;
+    _next_tick = base + CLOCK_CYC_PER_MS;
+    _frozen = false;
+    _inject = true;
+    uint64_t last = ms1;
+    while(_t - base < (uint64_t)CLOCK_CYC_PER_MS * 1000u) {
+        _work((uint32_t)rand() % WORK_MAX_CYC);
+        uint64_t before = _t;
+        uint64_t ms = clock_get_ms();
+        CHECK(ms >= ms1 + (before - base) / CLOCK_CYC_PER_MS && ms <= ms1 + (_t - base) / CLOCK_CYC_PER_MS);
+        CHECK(ms >= last);
+        last = ms;
+    }
+}
+
+int main(void) {
+    srand(1);
+    // dwt_init 很久之前已执行, CYCCNT 即将回绕; 初始化时处于当前 SysTick 周期的第 500 个周期
+    _t = 0xFFF00000ull - 1000u;
+    stub_systick.LOAD = CLOCK_CYC_PER_MS - 1u;
+    stub_systick.VAL = CLOCK_CYC_PER_MS - 1u - 500u;
+    _next_tick = _t + CLOCK_CYC_PER_MS - 500u;
+    const uint64_t t0 = _t - 500u;                  // 第 0 毫秒的真实起点
+
+    _frozen = true;
+    systick_init();
+    _frozen = false;
+    _inject = true;
+
+    uint64_t last_cyc = 0, last_us = 0, last_ms = 0;
+    uint32_t prev = (uint32_t)_t;
+    uint32_t reads = 0, wraps = 0;
+    while(_t - t0 < (uint64_t)CLOCK_CYC_PER_MS * 1000u * 60u * RUN_MINUTES) {
+        if(rand() % 5000 == 0) _mask_irq((uint32_t)rand() % MASK_MAX_CYC);
+        if(_pending && rand() % 4 == 0) _isr();
+        if(rand() % 4) _work((uint32_t)rand() % WORK_MAX_CYC);
+
+        uint64_t before = _t;
+        uint64_t cyc = clock_get_cycles();
+        uint64_t us = clock_get_us();
+        uint64_t ms = clock_get_ms();
+
+        // 读数落在调用前后的真实时间之间
+        CHECK(cyc >= before && cyc <= _t);                  // 周期数自 dwt_init 起, 即真实周期数
+        CHECK(us >= (before - t0) / CPU_FREQ_MHZ && us <= (_t - t0) / CPU_FREQ_MHZ);
+        CHECK(ms >= (before - t0) / CLOCK_CYC_PER_MS && ms <= (_t - t0) / CLOCK_CYC_PER_MS);
+        // 单调不减
+        CHECK(cyc >= last_cyc && us >= last_us && ms >= last_ms);
+        // 32 位毫秒由中断更新, 中断最多被推迟 MASK_MAX_CYC
+        uint32_t ms32 = systick_get_ms();
+        CHECK(ms32 <= (uint32_t)ms && (uint32_t)ms - ms32 <= MASK_MAX_CYC / CLOCK_CYC_PER_MS + 1u);
+
+        if((uint32_t)_t < prev) wraps++;
+        prev = (uint32_t)_t;
+        last_cyc = cyc;
+        last_us = us;
+        last_ms = ms;
+        reads++;
+    }
+    CHECK(wraps >= 13);
+    _test_sleep_stall();
+
+    // 以无符号差值判断超时
+    CHECK(systick_is_timeout(systick_get_ms() - 10u, 10u));
+    CHECK(!systick_is_timeout(systick_get_ms() - 5u, 10u));
+
+    printf("clock: %lu reads over %d min, %lu DWT wraps, ms %llu\n", (unsigned long)reads, RUN_MINUTES,
+        (unsigned long)wraps, (unsigned long long)last_ms);
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file    test_comms.c
+ * @brief   s_wireless_comms 接收解析器的协议切换测试
+ *          噪声产生的单个 0x00 使解析器进入二进制协议后, ASCII 命令仍须执行: 帧内 '$' 起为完整 ASCII 命令时立即回到 ASCII,
+ *          帧超长时不等待下一个 0x00 即放弃; 负载中含 '$' 的正常二进制帧不受影响
+ */
+#include "s_wireless_comms.h"
+#include "s_pid_tuner.h"
+#include "s_proto_bin.h"
+#include "s_trace.h"
+#include "systick.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define RX_SIZE     4096
+
+#define CHECK(c) do { if(!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); exit(1); } } while(0)
+
+// 接收缓冲区 (线性, 测试数据不回绕)
+static uint8_t _rx[RX_SIZE];
+static uint16_t _rx_head = 0;
+static uint16_t _rx_tail = 0;
+
+static usart_t _usart;
+static Relay _relay;
+static Gripper _gripper;
+static RelayDir_e _dir = RelayDirStop;
+static uint32_t _dir_calls = 0;
+
+// ! ========================= 外 部 依 赖 替 身 ========================= ! //
+
+uint16_t usart_rx_count(usart_t* handle) { return (uint16_t)(_rx_head - _rx_tail); }
+uint32_t usart_rx_overflow(usart_t* handle) { return 0; }
+bool usart_write(usart_t* handle, const uint8_t* data, uint16_t len) { return true; }
+
+const uint8_t* usart_rx_peek(usart_t* handle, uint16_t* count) {
+    *count = usart_rx_count(handle);
+    return &_rx[_rx_tail];
+}
+
+void usart_rx_consume(usart_t* handle, uint16_t n) {
+    CHECK(n <= usart_rx_count(handle));
+    _rx_tail = (uint16_t)(_rx_tail + n);
+}
+
+ms_t systick_get_ms(void) { return 0; }
+uint32_t dwt_get_cycles(void) { static uint32_t cyc = 0; return cyc += 5; }
+PID* s_pid_tuner_get(uint8_t id) { return 0; }
+bool s_pid_tuner_set_stream(uint8_t id, bool enable) { return false; }
+void s_pid_tuner_report(uint8_t id) {}
+void s_trace_record(uint8_t ev, uint8_t a, uint16_t b, uint32_t c) {}
+
+static void _set_dir(Relay* r, RelayDir_e d) { _dir = d; _dir_calls++; }
+static void _stop(Relay* r) { _dir = RelayDirStop; _dir_calls++; }
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   写入接收缓冲区并处理到没有可扫描的数据
+ */
+static void _feed(const void* data, uint16_t len) {
+    CHECK(_rx_head + len <= RX_SIZE);
+    memcpy(&_rx[_rx_head], data, len);
+    _rx_head = (uint16_t)(_rx_head + len);
+    while(s_wireless_comms_rx_pending()) s_wireless_comms_process();
+}
+
+static void _feed_str(const char* s) {
+    _feed(s, (uint16_t)strlen(s));
+}
+
+/**
+ * @brief   单个 0x00 之后紧跟的 ASCII 命令立即执行, 之后的命令不受影响
+ */
+static void _test_stray_delim(void) {
+    _feed("\0", 1);
+    _feed_str("$LIFT_UP#");
+    CHECK(_dir == RelayDirA);
+
+    _feed_str("$LIFT_STOP#");
+    CHECK(_dir == RelayDirStop);
+
+    // 0x00 之前的噪声与 '$' 之前的字节
+    _feed("xy\0z", 4);
+    _feed_str("$LIFT_SET:12.5#$LIFT_DOWN#");
+    CHECK(lift_target_pos_mm == 12.5f && _dir == RelayDirB);
+    _feed_str("$LIFT_STOP#");
+}
+
+/**
+ * @brief   0x00 之后的超长噪声 (不含 '$'): 超过 PROTO_BIN_MAX_ENCODED 即放弃, 不等待下一个 0x00
+ */
+static void _test_overflow(void) {
+    uint8_t junk[PROTO_BIN_MAX_ENCODED + 20];
+    junk[0] = 0x00;
+    memset(junk + 1, 0x01, sizeof(junk) - 1);
+    _feed(junk, sizeof(junk));
+    _feed_str("$LIFT_UP#");
+    CHECK(_dir == RelayDirA);
+    _feed_str("$LIFT_STOP#");
+    CHECK(_dir == RelayDirStop);
+}
+
+/**
+ * @brief   负载中含 '$' 的二进制帧正常执行, 前后的 ASCII 命令不受影响
+ */
+static void _test_bin_dollar(void) {
+    static const uint8_t payload[4] = { '$', 0x01, 0x48, 0x42 };
+    uint8_t enc[PROTO_BIN_MAX_ENCODED];
+    float expect;
+    memcpy(&expect, payload, sizeof(expect));
+
+    uint16_t n = s_proto_bin_encode(COMMS_MSG_LIFT_SET, 7, payload, sizeof(payload), enc, sizeof(enc));
+    CHECK(n > 0 && memchr(enc, '$', n));
+    _feed(enc, n);
+    CHECK(lift_target_pos_mm == expect);
+
+    // 帧中途出错 (缺少 CRC): 帧内 '$' 起重新扫描, 后续 ASCII 命令照常执行
+    uint8_t bad[] = { 0x00, 0x05, COMMS_MSG_LIFT_UP, 0x01, '$', 0x02, 0x00 };
+    uint32_t calls = _dir_calls;
+    _feed(bad, sizeof(bad));
+    CHECK(_dir_calls == calls);
+    _feed_str("$LIFT_DOWN#");
+    CHECK(_dir == RelayDirB);
+    _feed_str("$LIFT_STOP#");
+}
+
+int main(void) {
+    _relay.set_dir = _set_dir;
+    _relay.stop = _stop;
+    s_wireless_comms_init(&_usart, &_relay, &_gripper);
+
+    _test_stray_delim();
+    _test_overflow();
+    _test_bin_dollar();
+    CHECK(_rx_head == _rx_tail);
+
+    printf("comms: %u bytes scanned\n", (unsigned)_rx_head);
+    printf("ALL OK\n");
+    return 0;
+}
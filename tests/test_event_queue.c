@@ -0,0 +1,194 @@
+/**
+ * @file    test_event_queue.c
+ * @brief   s_event_queue 交错抢占测试
+ *          主循环与 3 级嵌套中断同时投递, 中断在 LDREX 之后、STREX 之前以及写入数据与发布序号之间
+ *          (stub.c 的抢占注入点) 随机插入; 检查每条成功投递的事件恰好取出一次、同一生产者同一优先级保持顺序、
+ *          丢弃数与溢出计数一致, 且取出方看不到已抢占但未发布的槽位
+ */
+#include "s_event_queue.h"
+#include "stm32f10x.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define LEVELS      4           // 0 为主循环, 1~3 为逐级更高优先级的中断
+#define EXPECT_SIZE 64          // 每条流尚未取出的事件上限 (> EVQ_CAPACITY)
+#define STEPS       400000
+
+#define CHECK(c) do { if(!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); exit(1); } } while(0)
+
+/**
+ * @brief   一条事件流 (生产者 × 优先级): 已成功投递、尚未取出的序号
+ */
+typedef struct {
+    uint32_t seq;               // 下一次投递的序号
+    uint32_t fail;              // 队列满被拒绝
+    uint32_t q[EXPECT_SIZE];
+    uint32_t head, tail;
+} stream_t;
+
+static evq_t _q;
+static stream_t _s[LEVELS][EVQ_PRIO_COUNT];
+static int _level = 0;          // 当前执行上下文
+static bool _in_push[LEVELS];
+static bool _in_pop = false;
+static uint32_t _popped = 0;
+
+// 抢占统计
+static uint32_t _hits[3];
+static uint32_t _between;       // 在认领槽位与发布序号之间被抢占的投递
+static uint32_t _probe;         // 在主循环认领与发布之间执行的取出
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+static void _push(evq_prio_e prio) {
+    stream_t* s = &_s[_level][prio];
+    evq_arg_t arg;
+    arg.u = s->seq;
+
+    _in_push[_level] = true;
+    bool ok = s_event_queue_push(&_q, prio, (uint16_t)(_level * EVQ_PRIO_COUNT + prio), arg);
+    _in_push[_level] = false;
+
+    if(ok) {
+        CHECK(s->tail - s->head < EXPECT_SIZE);
+        s->q[s->tail++ % EXPECT_SIZE] = s->seq;
+    }
+    else {
+        s->fail++;
+    }
+    s->seq++;
+}
+
+static uint32_t _pop(uint32_t max) {
+    evq_item_t it;
+    uint32_t n = 0;
+
+    _in_pop = true;
+    while(n < max && s_event_queue_pop(&_q, &it)) {
+        uint16_t level = it.id / EVQ_PRIO_COUNT;
+        uint16_t prio = it.id % EVQ_PRIO_COUNT;
+        CHECK(level < LEVELS);
+        stream_t* s = &_s[level][prio];
+        // 取出的必须是该流中最早的已投递事件: 未发布 (push 尚未返回) 的事件不会出现在这里
+        CHECK(s->head != s->tail);
+        CHECK(it.arg.u == s->q[s->head % EXPECT_SIZE]);
+        s->head++;
+        n++;
+    }
+    _in_pop = false;
+    _popped += n;
+    return n;
+}
+
+/**
+ * @brief   抢占钩子: 以一定概率模拟一次更高优先级的中断
+ */
+static bool _irq(stub_site_e site) {
+    if(_level >= LEVELS - 1 || rand() % 4) return false;
+
+    int saved = _level;
+    _hits[site]++;
+    if(site == STUB_AT_DMB && _in_push[saved]) _between++;
+
+    _level = saved + 1 + rand() % (LEVELS - 1 - saved);
+    int n = 1 + rand() % 3;
+    for(int i = 0; i < n; ++i) _push((evq_prio_e)(rand() % EVQ_PRIO_COUNT));
+    _level = saved;
+
+    // 主循环在认领与发布之间被打断: 取出方此时执行 (取出方只有一个, 未与其他取出并发)
+    if(site == STUB_AT_DMB && saved == 0 && _in_push[0] && !_in_pop) {
+        _probe++;
+        _pop(EVQ_CAPACITY);
+    }
+    return true;
+}
+
+/**
+ * @brief   将队列的读写位置置于 base (用于跨越 32 位回绕)
+ */
+static void _rebase(uint32_t base) {
+    for(uint8_t p = 0; p < EVQ_PRIO_COUNT; ++p) {
+        evq_ring_t* ring = &_q.rings[p];
+        for(uint32_t i = 0; i < EVQ_CAPACITY; ++i) {
+            uint32_t pos = base + i;
+            ring->cells[pos & (EVQ_CAPACITY - 1)].seq = pos;
+        }
+        ring->enqueue_pos = base;
+        ring->dequeue_pos = base;
+    }
+}
+
+static void _run(uint32_t base) {
+    uint32_t fail[EVQ_PRIO_COUNT] = { 0 };
+
+    s_event_queue_init(&_q);
+    _rebase(base);
+    for(int l = 0; l < LEVELS; ++l) {
+        for(int p = 0; p < EVQ_PRIO_COUNT; ++p) {
+            stream_t* s = &_s[l][p];
+            s->fail = 0;
+            s->head = s->tail = 0;
+        }
+    }
+
+    stub_preempt = _irq;
+    for(uint32_t k = 0; k < STEPS; ++k) {
+        if(rand() % 3) _push((evq_prio_e)(rand() % EVQ_PRIO_COUNT));
+        else _pop((uint32_t)(rand() % 8));
+    }
+    stub_preempt = 0;
+    _pop(0xFFFFFFFFu);
+
+    CHECK(s_event_queue_empty(&_q));
+    for(int l = 0; l < LEVELS; ++l) {
+        for(int p = 0; p < EVQ_PRIO_COUNT; ++p) {
+            CHECK(_s[l][p].head == _s[l][p].tail);
+            fail[p] += _s[l][p].fail;
+        }
+    }
+    for(int p = 0; p < EVQ_PRIO_COUNT; ++p) {
+        CHECK(s_event_queue_overflow(&_q, (evq_prio_e)p) == fail[p]);
+    }
+}
+
+static void _capacity(void) {
+    evq_item_t it;
+    evq_arg_t arg;
+
+    s_event_queue_init(&_q);
+    for(uint32_t i = 0; i < EVQ_CAPACITY; ++i) {
+        arg.u = i;
+        CHECK(s_event_queue_push(&_q, EVQ_PRIO_NORMAL, 1, arg));
+    }
+    arg.u = 99;
+    CHECK(!s_event_queue_push(&_q, EVQ_PRIO_NORMAL, 1, arg));
+    CHECK(s_event_queue_overflow(&_q, EVQ_PRIO_NORMAL) == 1);
+    CHECK(s_event_queue_push(&_q, EVQ_PRIO_HIGH, 2, arg));
+
+    // 高优先级先出, 同优先级先进先出
+    CHECK(s_event_queue_pop(&_q, &it) && it.id == 2);
+    for(uint32_t i = 0; i < EVQ_CAPACITY; ++i) {
+        CHECK(s_event_queue_pop(&_q, &it) && it.id == 1 && it.arg.u == i);
+    }
+    CHECK(!s_event_queue_pop(&_q, &it));
+    CHECK(s_event_queue_empty(&_q));
+}
+
+int main(void) {
+    srand(1);
+    _capacity();
+    _run(0);
+    _run(0xFFFFFF00u);
+
+    // 每个注入点都发生过抢占, 且覆盖了认领与发布之间的窗口
+    CHECK(_hits[STUB_AT_LDREX] && _hits[STUB_AT_STREX] && _hits[STUB_AT_DMB]);
+    CHECK(_between && _probe);
+    printf("event_queue: popped %lu, preempted ldrex/strex/dmb %lu/%lu/%lu, claim-publish %lu, probes %lu\n",
+        (unsigned long)_popped, (unsigned long)_hits[STUB_AT_LDREX], (unsigned long)_hits[STUB_AT_STREX],
+        (unsigned long)_hits[STUB_AT_DMB], (unsigned long)_between, (unsigned long)_probe);
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,406 @@
+/**
+ * @file    test_fsm.c
+ * @brief   a_fsm 模拟时钟测试
+ *          以模拟毫秒时钟驱动状态机 (主循环每毫秒一次, 控制周期 10 ms), 升降台为按继电器方向匀速移动的模型;
+ *          检查升降到位、堵转与移动超时进入错误状态、定时事件 (单次 / 周期 / 重启 / 主循环推迟时的起算时刻)、
+ *          事件队列溢出与抓取流程
+ */
+#include "a_board.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define CHECK(c) do { if(!(c)) { printf("\nFAIL %s:%d: %s (t=%lu state=%s)\n", __FILE__, __LINE__, #c, \
+    (unsigned long)_ms, cur_state->name_); exit(1); } } while(0)
+
+// a_board.c 中的全局实例
+can_t can;
+usart_t usart1, usart2;
+Encoder lift_encoder;
+Relay lift_relay;
+Gripper gripper;
+PID lift_pid;
+float lift_target_pos_mm = 0.0f;
+
+static uint32_t _ms = 0;
+static uint32_t _cyc = 0;
+
+// 升降台模型
+static float _pos = 0.0f;
+static float _speed = 1.0f;         // 每个控制周期的位移 (mm)
+static RelayDir_e _dir = RelayDirStop;
+static float _grip_angle = 0.0f;
+static uint32_t _grip_opens = 0;
+static uint32_t _releases = 0;          // 急停锁定解除次数 (只允许 $ESTOP_RESET#)
+static uint32_t _timed_aborts = 0;
+
+// 完成通知 (最近一次状态与各状态次数) 与命令表
+static comms_status_e _done[COMMS_DONE_KINDS];
+static uint32_t _done_n[COMMS_DONE_KINDS][COMMS_ERR_FAULT + 1];
+static const comms_cmd_t* _tab;
+static uint8_t _tab_n;
+
+// ! ========================= 外 部 依 赖 替 身 ========================= ! //
+
+ms_t systick_get_ms(void) { return 0; }        // 仅作 _get_ms 的默认值; 状态机经 a_fsm_set_clock 读取模拟时钟
+uint32_t dwt_get_cycles(void) { return _cyc += 7; }
+void a_board_cpu_report(void) {}
+void s_sched_report(void) {}
+void s_sched_reset_stats(void) {}
+void s_trace_record(uint8_t ev, uint8_t a, uint16_t b, uint32_t c) {}
+void s_trace_fault(uint8_t code, uint16_t b, uint32_t c) {}
+
+void s_wireless_comms_complete(comms_done_e kind, comms_status_e status) {
+    _done[kind] = status;
+    _done_n[kind][status]++;
+}
+
+void s_wireless_comms_abort_timed(void) {
+    _timed_aborts++;
+}
+
+bool s_wireless_comms_register(const comms_cmd_t* table, uint8_t count) {
+    _tab = table;
+    _tab_n = count;
+    return true;
+}
+
+static uint32_t _clock(void) { return _ms; }
+static float _get_pos(const Encoder* e) { return _pos; }
+static float _get_speed(const Encoder* e) { return _dir == RelayDirStop ? 0.0f : _speed * 100.0f; }
+static void _set_dir(Relay* r, RelayDir_e d) { _dir = d; }
+static void _stop(Relay* r) { _dir = RelayDirStop; }
+static void _release(Relay* r) { _releases++; }
+static void _open(Gripper* g) { _grip_opens++; _grip_angle = 0.0f; }
+static void _set_angle(Gripper* g, float a) { _grip_angle = a; }
+static uint32_t _move_time(const Gripper* g) { return 300; }
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+/**
+ * @brief   一次主循环: 定时器任务投递到期事件, 状态机处理事件
+ */
+static void _loop(void) {
+    s_timer_task();
+    a_fsm_process();
+}
+
+/**
+ * @brief   推进模拟时间: 每毫秒一次主循环, 每 TICK_PERIOD_MS 一次控制周期 (先移动升降台模型)
+ */
+static void _run(uint32_t ms) {
+    for(uint32_t i = 0; i < ms; ++i) {
+        _ms++;
+        if(_ms % TICK_PERIOD_MS == 0) {
+            if(_dir == RelayDirA) _pos += _speed;
+            if(_dir == RelayDirB) _pos -= _speed;
+            a_fsm_control();
+        }
+        _loop();
+    }
+}
+
+static comms_status_e _cmd(const char* name, float a, float b, float c) {
+    comms_args_t args;
+    args.argc = 3;
+    args.v[0].f = a;
+    args.v[1].f = b;
+    args.v[2].f = c;
+    for(uint8_t i = 0; i < _tab_n; ++i) {
+        if(strcmp(_tab[i].name, name) == 0) return _tab[i].fn(&args);
+    }
+    CHECK(0);
+    return COMMS_ERR_UNKNOWN;
+}
+
+static void _set_target(float mm) {
+    lift_target_pos_mm = mm;
+    a_fsm_notify_lift_target(mm);
+}
+
+static void _init(void) {
+    lift_encoder.get_position = _get_pos;
+    lift_encoder.get_speed = _get_speed;
+    lift_relay.set_dir = _set_dir;
+    lift_relay.stop = _stop;
+    lift_relay.release = _release;
+    gripper.open = _open;
+    gripper.set_angle = _set_angle;
+    gripper.get_move_time_ms = _move_time;
+
+    lift_pid = pid_create();
+    pid_cfg_t cfg = { .mode = PID_MODE_P, .features = PID_FEAT_DEADBAND, .kp = 1.0f, .dead_band = 2.0f };
+    lift_pid.init_cfg(&lift_pid, &cfg);
+
+    a_fsm_set_clock(_clock);
+    s_timer_init(_clock, dwt_get_cycles);
+    a_fsm_init();
+    a_fsm_register_cmds();
+    _run(10);
+    CHECK(cur_state == &state_idle);
+}
+
+/**
+ * @brief   正常移动: 进入移动状态, 到位后回到空闲并完成 DONE_LIFT
+ */
+static void _test_move(void) {
+    _speed = 1.0f;
+    _set_target(100.0f);
+    _run(20);
+    CHECK(cur_state == &state_lift_moving);
+    CHECK(_dir == RelayDirA);
+
+    uint32_t n = _done_n[COMMS_DONE_LIFT][COMMS_OK];
+    _run(2000);
+    CHECK(cur_state == &state_idle);
+    CHECK(_dir == RelayDirStop);
+    CHECK(_pos >= 98.0f && _pos <= 102.0f);
+    CHECK(_done_n[COMMS_DONE_LIFT][COMMS_OK] > n);
+
+    // 向下移动
+    _set_target(40.0f);
+    _run(1000);
+    CHECK(cur_state == &state_idle && _pos <= 42.0f);
+
+    // 静止时控制周期不会使空闲状态重新检查 (主循环可休眠); 位置变化后重新检查
+    a_fsm_control();
+    a_fsm_process();
+    CHECK(!a_fsm_has_pending());
+    a_fsm_control();
+    CHECK(!a_fsm_has_pending());
+    _pos += 0.5f;
+    a_fsm_control();
+    CHECK(a_fsm_has_pending());
+    a_fsm_process();
+    CHECK(!a_fsm_has_pending() && cur_state == &state_idle);
+}
+
+/**
+ * @brief   堵转: 编码器不动, LIFT_STALL_TIMEOUT_MS 后进入错误状态并回到空闲, 继电器断开,
+ *          目标与排队中的定时命令作废, 急停锁定不被解除
+ */
+static void _test_stall(void) {
+    uint32_t opens = _grip_opens;
+    uint32_t aborts = _timed_aborts;
+    uint32_t faults = _done_n[COMMS_DONE_LIFT][COMMS_ERR_FAULT];
+
+    _speed = 0.0f;
+    uint32_t start = _ms;
+    _set_target(300.0f);
+    _run(20);
+    CHECK(cur_state == &state_lift_moving);
+    while(cur_state == &state_lift_moving && _ms - start < 5000) _run(1);
+
+    // 进入移动状态 (设定目标后 2 ms 内) 起 LIFT_STALL_TIMEOUT_MS 到期
+    CHECK(_ms - start >= 1000 && _ms - start <= 1002);
+    _run(5);
+    CHECK(cur_state == &state_idle);
+    CHECK(_dir == RelayDirStop);
+    CHECK(_grip_opens == opens + 1);
+    CHECK(_done_n[COMMS_DONE_LIFT][COMMS_ERR_FAULT] == faults + 1);
+    CHECK(lift_target_pos_mm == _pos);
+    CHECK(_timed_aborts == aborts + 1);
+    CHECK(_releases == 0);
+
+    // 错误恢复后不会重新驱动
+    _speed = 1.0f;
+    _run(200);
+    CHECK(cur_state == &state_idle && _dir == RelayDirStop);
+}
+
+/**
+ * @brief   移动超时: 持续移动但 LIFT_MOVE_TIMEOUT_MS 内未到位
+ */
+static void _test_move_timeout(void) {
+    uint32_t faults = _done_n[COMMS_DONE_LIFT][COMMS_ERR_FAULT];
+
+    _speed = 1.0f;
+    uint32_t start = _ms;
+    _set_target(_pos + 10000.0f);
+    _run(20);
+    CHECK(cur_state == &state_lift_moving);
+    while(cur_state == &state_lift_moving && _ms - start < 40000) _run(1);
+    CHECK(_ms - start >= 30000 && _ms - start <= 30002);
+    _run(5);
+    CHECK(cur_state == &state_idle && _dir == RelayDirStop);
+    CHECK(_done_n[COMMS_DONE_LIFT][COMMS_ERR_FAULT] == faults + 1);
+}
+
+/**
+ * @brief   定时事件: 单次按时投递, 周期不累积误差, 重启后重新计时, 取消后不再投递
+ * @note    以 EVENT_ERROR 为探针: 每次投递都经过错误状态 (张开夹爪) 回到空闲
+ */
+static void _test_timers(void) {
+    evq_arg_t arg;
+    arg.u = 0;
+    uint32_t opens = _grip_opens;
+
+    // 单次: 延时 25 ms
+    timer_handle_t h = a_fsm_schedule_event(EVENT_ERROR, arg, 25, 0);
+    CHECK(h >= 0);
+    _run(24);
+    CHECK(_grip_opens == opens);
+    _run(1);
+    CHECK(_grip_opens == opens + 1);
+    CHECK(!a_fsm_restart_event(h, 10));        // 到期后句柄已释放
+    _run(5);
+    CHECK(cur_state == &state_idle);
+
+    // 周期: 首次 3 ms, 之后每 5 ms; 103 ms 内共 21 次
+    opens = _grip_opens;
+    h = a_fsm_schedule_event(EVENT_ERROR, arg, 3, 5);
+    CHECK(h >= 0);
+    _run(103);
+    CHECK(_grip_opens == opens + 21);
+    a_fsm_cancel_event(h);
+    CHECK(!a_fsm_restart_event(h, 1));
+    _run(100);
+    CHECK(_grip_opens == opens + 21);
+
+    // 重启: 每 20 ms 重启为 30 ms, 一直不到期
+    opens = _grip_opens;
+    h = a_fsm_schedule_event(EVENT_ERROR, arg, 30, 0);
+    for(int k = 0; k < 5; ++k) {
+        _run(20);
+        CHECK(a_fsm_restart_event(h, 30));
+    }
+    a_fsm_cancel_event(h);
+    _run(100);
+    CHECK(_grip_opens == opens && cur_state == &state_idle);
+
+    // 无效句柄
+    CHECK(!a_fsm_restart_event(-1, 10));
+    a_fsm_cancel_event(-1);
+}
+
+/**
+ * @brief   定时器任务落后 (主循环被推迟) 时新建的定时器自当前时刻起算, 不会提前投递
+ */
+static void _test_late_base(void) {
+    evq_arg_t arg;
+    arg.u = 0;
+    uint32_t opens = _grip_opens;
+
+    _run(10);
+    _ms += 40;                                  // 40 ms 内未执行主循环
+    timer_handle_t h = a_fsm_schedule_event(EVENT_ERROR, arg, 20, 0);
+    CHECK(h >= 0);
+    for(int k = 0; k < 19; ++k) {
+        _ms++;
+        _loop();
+    }
+    CHECK(cur_state == &state_idle && _grip_opens == opens);
+    _ms++;
+    _loop();
+    a_fsm_process();
+    CHECK(_grip_opens == opens + 1);            // 第 20 ms 到期: 错误状态进入动作已执行
+    _run(5);
+    CHECK(cur_state == &state_idle);
+
+    // 重启同样以当前时刻为起点
+    h = a_fsm_schedule_event(EVENT_ERROR, arg, 50, 0);
+    _run(10);
+    _ms += 30;
+    CHECK(a_fsm_restart_event(h, 20));
+    for(int k = 0; k < 19; ++k) {
+        _ms++;
+        _loop();
+    }
+    CHECK(_grip_opens == opens + 1);
+    _run(2);
+    CHECK(_grip_opens == opens + 2);
+}
+
+/**
+ * @brief   事件队列溢出计数
+ */
+static void _test_overflow(void) {
+    uint32_t base = a_fsm_event_overflow(EVQ_PRIO_NORMAL);
+    for(int i = 0; i < EVQ_CAPACITY + 8; ++i) a_fsm_trigger_event(EVENT_LIFT_STOP);
+    CHECK(a_fsm_event_overflow(EVQ_PRIO_NORMAL) == base + 8);
+    _run(50);
+    CHECK(cur_state == &state_idle);
+}
+
+/**
+ * @brief   抓取流程: 接近 -> 夹取 -> 抬升 -> 释放 -> 空闲; 流程中及已受理未启动时拒绝新的 $PICK; 中止后停止驱动
+ */
+static void _test_pick(void) {
+    _speed = 1.0f;
+    _pos = 0.0f;
+    _set_target(_pos);
+    _run(50);
+    CHECK(_cmd("PICK", 50.0f, 0.5f, 150.0f) == COMMS_OK);
+    _run(5);
+    CHECK(cur_state == &state_pick_approach);
+    CHECK(_cmd("PICK", 50.0f, 0.5f, 150.0f) == COMMS_ERR_BUSY);
+    CHECK(a_fsm_motion_busy());
+    CHECK(a_fsm_lift_target() == 50.0f);
+    CHECK(lift_target_pos_mm == 0.0f);          // 流程目标不占用 lift_target_pos_mm
+
+    uint32_t start = _ms;
+    while(cur_state != &state_idle && _ms - start < 20000) _run(1);
+    CHECK(cur_state == &state_idle && !a_fsm_motion_busy());
+    CHECK(_done[COMMS_DONE_PICK] == COMMS_OK);
+    CHECK(_pos >= 148.0f && _pos <= 152.0f);
+    CHECK(_grip_angle == 0.0f);                 // 释放阶段已张开
+
+    // 结束后以当前位置为目标, 不会驱动回流程开始前的目标
+    CHECK(lift_target_pos_mm == _pos);
+    _run(500);
+    CHECK(cur_state == &state_idle && _dir == RelayDirStop);
+
+    CHECK(_cmd("PICK", 0.0f, 0.5f, 150.0f) == COMMS_OK);
+    _run(100);
+    CHECK(cur_state == &state_pick_approach && _dir == RelayDirB);
+    CHECK(_cmd("PICK_ABORT", 0.0f, 0.0f, 0.0f) == COMMS_OK);
+    _run(5);
+    CHECK(cur_state == &state_idle && _dir == RelayDirStop);
+    CHECK(_done[COMMS_DONE_PICK] == COMMS_ERR_ABORTED);
+    _run(200);
+    CHECK(_dir == RelayDirStop);
+
+    // 同一轮命令处理中的第二条 $PICK 被拒绝, 不覆盖第一条的参数
+    CHECK(_cmd("PICK", 30.0f, 0.5f, 150.0f) == COMMS_OK);
+    CHECK(_cmd("PICK", 80.0f, 0.5f, 150.0f) == COMMS_ERR_BUSY);
+    _run(5);
+    CHECK(cur_state == &state_pick_approach && a_fsm_lift_target() == 30.0f);
+    CHECK(_cmd("PICK_ABORT", 0.0f, 0.0f, 0.0f) == COMMS_OK);
+    _run(5);
+    CHECK(cur_state == &state_idle);
+
+    // 受理后先处理了移动事件: 流程未启动, 回复中止, 之后可再次受理
+    uint32_t aborted = _done_n[COMMS_DONE_PICK][COMMS_ERR_ABORTED];
+    a_fsm_trigger_event(EVENT_LIFT_MOVE);
+    CHECK(_cmd("PICK", 30.0f, 0.5f, 150.0f) == COMMS_OK);
+    _run(5);
+    CHECK(cur_state != &state_pick_approach);
+    CHECK(_done_n[COMMS_DONE_PICK][COMMS_ERR_ABORTED] == aborted + 1);
+    start = _ms;
+    while(cur_state != &state_idle && _ms - start < 5000) _run(1);
+    CHECK(cur_state == &state_idle);
+    CHECK(_cmd("PICK", 30.0f, 0.5f, 150.0f) == COMMS_OK);
+    _run(5);
+    CHECK(cur_state == &state_pick_approach);
+    CHECK(_cmd("PICK_ABORT", 0.0f, 0.0f, 0.0f) == COMMS_OK);
+    _run(200);
+    CHECK(cur_state == &state_idle && _dir == RelayDirStop);
+}
+
+int main(void) {
+    _ms = 0xFFFFFFFFu - 3000;                   // 运行中跨越 32 位毫秒回绕
+    _init();
+    _test_move();
+    _test_stall();
+    _test_timers();
+    _test_late_base();
+    _test_overflow();
+    _test_move_timeout();
+    _test_pick();
+    printf("\nfsm: simulated %lu ms\n", (unsigned long)(_ms + 3001u));
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,186 @@
+/**
+ * @file    test_num.c
+ * @brief   s_num 与 C 库 strtof / printf 的对照测试
+ *          固定用例检查结果与结束位置; 随机用例各 200000 条:
+ *          有效数字不超过 7 位且十进制指数绝对值不超过 10 时解析结果须与 strtof 逐位一致,
+ *          超出时允许少量 ulp 误差; 定点格式化须与 printf("%.*f") 逐字一致
+ * @note    超出范围时存在两次舍入: s_num 最多保留 9 位有效数字, (float)mant 超过 2^24 时舍入一次,
+ *          再按 1e10f 分段连乘/连除 (如 1e-25 即 /1e10f /1e10f /1e5f) 每步各舍入一次,
+ *          因此不能与 strtof 的一次正确舍入逐位一致
+ */
+#include "s_num.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define CASES       200000
+#define ULP_EXACT   0           // 有效数字 <= 7 且 |exp10| <= 10
+#define ULP_MAX     4           // 其余情况
+
+#define CHECK(c) do { if(!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); exit(1); } } while(0)
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+static uint32_t _ulp(float a, float b) {
+    int32_t x, y;
+    memcpy(&x, &a, 4);
+    memcpy(&y, &b, 4);
+    if((x ^ y) < 0) return (a == b) ? 0 : 0xFFFFFFFFu;      // 符号不同只允许 ±0
+    return (uint32_t)(x > y ? x - y : y - x);
+}
+
+/**
+ * @brief   统计有效数字位数与 s_num 内部的十进制指数 (mant * 10^exp10)
+ */
+static void _digits(const char* s, int* sig, int* exp10) {
+    int n = 0, e = 0, trail = 0;
+    bool started = false, frac = false;
+
+    for(; *s && *s != 'e' && *s != 'E'; ++s) {
+        if(*s == '.') { frac = true; continue; }
+        if(*s < '0' || *s > '9') continue;
+        if(*s != '0') started = true;
+        if(!started) { if(frac) e--; continue; }
+        n++;
+        if(frac) e--;
+        trail = (*s == '0') ? trail + 1 : 0;
+    }
+    if(*s) e += atoi(s + 1);
+    // 末尾的 0 不计入有效数字
+    *sig = n - trail;
+    *exp10 = e + trail;
+}
+
+static void _check_f32(const char* s, uint32_t* worst_exact, uint32_t* worst) {
+    float a, b;
+    const char* e1;
+    char* e2;
+    int sig, exp10;
+
+    CHECK(s_num_parse_f32(s, &e1, &a) == NUM_OK);
+    b = strtof(s, &e2);
+    CHECK(e1 == e2);
+
+    uint32_t u = _ulp(a, b);
+    _digits(s, &sig, &exp10);
+    if(sig <= 7 && exp10 >= -10 && exp10 <= 10) {
+        if(u > ULP_EXACT) printf("FAIL '%s': %.9g vs strtof %.9g\n", s, a, b);
+        CHECK(u <= ULP_EXACT);
+        if(u > *worst_exact) *worst_exact = u;
+    }
+    else {
+        if(u > ULP_MAX) printf("FAIL '%s': %.9g vs strtof %.9g\n", s, a, b);
+        CHECK(u <= ULP_MAX);
+        if(u > *worst) *worst = u;
+    }
+}
+
+static void _test_fixed_cases(void) {
+    static const char* const ok[] = {
+        "150.5", "-1.57", "0.001", "0", "-0", "1e3", "2.5E-3", "123456.7", "3.4e38", "0.1", "0.2", "0.3",
+        "100.0", "50.0", "500.0", "1.25", "0.01", "+7", ".5", "5.", "123456789012", "0.000000123", "1e-40",
+        "150.5#", "1.5,2", "-0.0e+0",
+    };
+    uint32_t w0 = 0, w1 = 0;
+    for(size_t i = 0; i < sizeof(ok) / sizeof(ok[0]); ++i) _check_f32(ok[i], &w0, &w1);
+
+    float f;
+    int32_t n;
+    uint32_t u;
+    const char* end;
+    CHECK(s_num_parse_f32("", 0, &f) == NUM_ERR_EMPTY);
+    CHECK(s_num_parse_f32("abc", 0, &f) == NUM_ERR_EMPTY);
+    CHECK(s_num_parse_f32("-", 0, &f) == NUM_ERR_EMPTY);
+    CHECK(s_num_parse_f32("1e", &end, &f) == NUM_ERR_SYNTAX);
+    CHECK(s_num_parse_f32("1e+", 0, &f) == NUM_ERR_SYNTAX);
+    CHECK(s_num_parse_f32("4e38", 0, &f) == NUM_ERR_RANGE);
+    CHECK(s_num_parse_f32("-1e39", 0, &f) == NUM_ERR_RANGE);
+
+    CHECK(s_num_parse_i32("2147483647", 0, &n) == NUM_OK && n == 2147483647);
+    CHECK(s_num_parse_i32("-2147483648", 0, &n) == NUM_OK && n == (-2147483647 - 1));
+    CHECK(s_num_parse_i32("2147483648", 0, &n) == NUM_ERR_RANGE);
+    CHECK(s_num_parse_i32("-2147483649", 0, &n) == NUM_ERR_RANGE);
+    CHECK(s_num_parse_i32("12,3", &end, &n) == NUM_OK && n == 12 && *end == ',');
+    CHECK(s_num_parse_u32("4294967295", 0, &u) == NUM_OK && u == 4294967295u);
+    CHECK(s_num_parse_u32("4294967296", 0, &u) == NUM_ERR_RANGE);
+
+    // 定点: 多余小数位四舍五入 (远离 0)
+    static const struct { const char* s; int32_t v; } fx[] = {
+        { "150.5", 15050 }, { "-1.575", -158 }, { "0.004", 0 }, { "0.005", 1 }, { "12", 1200 },
+        { ".25", 25 }, { "21474836.47", 2147483647 },
+    };
+    for(size_t i = 0; i < sizeof(fx) / sizeof(fx[0]); ++i) {
+        CHECK(s_num_parse_fixed(fx[i].s, 0, 2, &n) == NUM_OK);
+        if(n != fx[i].v) printf("FAIL fixed '%s': %ld\n", fx[i].s, (long)n);
+        CHECK(n == fx[i].v);
+    }
+    CHECK(s_num_parse_fixed("21474836.48", 0, 2, &n) == NUM_ERR_RANGE);
+    CHECK(s_num_parse_fixed("1", 0, 10, &n) == NUM_ERR_RANGE);
+
+    char buf[NUM_FMT_BUF_SIZE];
+    CHECK(s_num_fmt_i32(buf, -2147483647 - 1) == 11 && !strcmp(buf, "-2147483648"));
+    CHECK(s_num_fmt_u32(buf, 4294967295u) == 10 && !strcmp(buf, "4294967295"));
+    CHECK(s_num_fmt_u32(buf, 0) == 1 && !strcmp(buf, "0"));
+}
+
+/**
+ * @brief   随机定点写法 ("%.*f", |exp10| <= 10, 有效数字可超过 7 位)
+ */
+static void _test_random_fixed(void) {
+    char buf[64];
+    uint32_t w0 = 0, w1 = 0;
+
+    for(int i = 0; i < CASES; ++i) {
+        float v = (rand() / (float)RAND_MAX - 0.5f) * powf(10.0f, (float)(rand() % 12 - 4));
+        snprintf(buf, sizeof(buf), "%.*f", rand() % 7, v);
+        _check_f32(buf, &w0, &w1);
+    }
+    printf("num: parse fixed-notation %d cases, max ulp %lu (<=7 digits) / %lu (longer)\n",
+        CASES, (unsigned long)w0, (unsigned long)w1);
+}
+
+/**
+ * @brief   随机科学计数法 (覆盖整个 float 范围, 含 |exp10| > 10 的分段缩放)
+ */
+static void _test_random_sci(void) {
+    char buf[64];
+    uint32_t w0 = 0, w1 = 0;
+
+    for(int i = 0; i < CASES; ++i) {
+        float m = 1.0f + 9.0f * (rand() / (float)RAND_MAX);
+        int e = rand() % 75 - 37;
+        snprintf(buf, sizeof(buf), "%s%.*fe%d", (rand() & 1) ? "-" : "", rand() % 8, m, e);
+        _check_f32(buf, &w0, &w1);
+    }
+    printf("num: parse scientific %d cases, max ulp %lu (exact range) / %lu (outside)\n",
+        CASES, (unsigned long)w0, (unsigned long)w1);
+}
+
+static void _test_random_fmt(void) {
+    char a[NUM_FMT_BUF_SIZE], b[64];
+
+    for(int i = 0; i < CASES; ++i) {
+        float v = (rand() / (float)RAND_MAX - 0.5f) * powf(10.0f, (float)(rand() % 13 - 6));
+        int d = rand() % 7;
+        uint8_t n = s_num_fmt_f32(a, v, (uint8_t)d);
+        snprintf(b, sizeof(b), "%.*f", d, v);
+        if(strcmp(a, b)) printf("FAIL fmt %.9g/%d: '%s' vs printf '%s'\n", v, d, a, b);
+        CHECK(!strcmp(a, b) && n == strlen(b));
+    }
+    printf("num: format %d cases match printf\n", CASES);
+}
+
+int main(void) {
+    srand(1);
+    _test_fixed_cases();
+    _test_random_fixed();
+    _test_random_sci();
+    _test_random_fmt();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,233 @@
+/**
+ * @file    test_timer.c
+ * @brief   s_timer 模拟时钟测试
+ *          300 个定时器从 32 位毫秒回绕前夕开始随机启动 (单次 / 周期, 延时 0 ~ 11 h)、停止、重启与删除,
+ *          回调中再随机停止自身或启动其他定时器; 以模型检查每次回调恰好在到期毫秒执行、运行状态一致、
+ *          已删除的句柄被拒绝. 另测主循环推迟时的补齐、重启沿用原延时, 以及 10 / 100 / 300 个定时器时每毫秒推进的耗时
+ */
+#include "s_timer.h"
+#include "s_wireless_comms.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// ! ========================= 变 量 声 明 ========================= ! //
+
+#define TIMERS      300
+#define STEPS       3000000
+#define BENCH_STEPS 1000000
+
+#if TIMERS > TIMER_MAX
+#error "TIMER_MAX must be at least TIMERS"
+#endif
+
+#define CHECK(c) do { if(!(c)) { printf("FAIL %s:%d: %s (t=%lu)\n", __FILE__, __LINE__, #c, \
+    (unsigned long)_ms); exit(1); } } while(0)
+
+/**
+ * @brief   定时器模型
+ */
+typedef struct {
+    timer_handle_t h;
+    uint32_t expire;            // 下一次到期时刻
+    uint32_t period;
+    bool active;
+} model_t;
+
+static uint32_t _ms = 0;
+static uint32_t _cyc = 0;
+static model_t _m[TIMERS];
+static uint32_t _fired = 0;
+static bool _check = true;      // 关闭时回调只计数 (补齐与性能测试)
+
+// ! ========================= 外 部 依 赖 替 身 ========================= ! //
+
+bool s_wireless_comms_register(const comms_cmd_t* table, uint8_t count) {
+    return true;
+}
+
+static uint32_t _clock(void) { return _ms; }
+static uint32_t _cycles(void) { return _cyc += 7; }
+
+// ! ========================= 私 有 函 数 实 现 ========================= ! //
+
+static void _start(int i, uint32_t delay, uint32_t period) {
+    CHECK(s_timer_start(_m[i].h, delay, period));
+    _m[i].expire = _ms + (delay ? delay : 1);
+    _m[i].period = period;
+    _m[i].active = true;
+}
+
+static void _stop(int i) {
+    CHECK(s_timer_stop(_m[i].h));
+    _m[i].active = false;
+}
+
+/**
+ * @brief   回调: 检查到期时刻, 再随机停止自身或启动其他定时器
+ */
+static void _cb(void* arg) {
+    int i = (int)(intptr_t)arg;
+
+    _fired++;
+    if(!_check) return;
+    CHECK(_m[i].active);
+    CHECK(_ms == _m[i].expire);
+    if(_m[i].period)
+        _m[i].expire += _m[i].period;
+    else
+        _m[i].active = false;
+
+    int r = rand() % 20;
+    if(r == 0) _stop(i);
+    else if(r == 1) _start(rand() % TIMERS, 1u + (uint32_t)(rand() % 200), 0);
+}
+
+/**
+ * @brief   随机延时: 多数在 10 s 内, 少数跨越多层时间轮, 偶尔超出 2^24 ms
+ */
+static uint32_t _delay(void) {
+    int r = rand() % 10;
+    if(r < 5) return (uint32_t)(rand() % 100);
+    if(r < 8) return (uint32_t)(rand() % 10000);
+    if(r < 9) return (uint32_t)(rand() % 300000);
+    return (uint32_t)rand() % 40000000u;
+}
+
+static void _step(void) {
+    _ms++;
+    s_timer_task();
+}
+
+static void _test_random(void) {
+    for(int i = 0; i < TIMERS; ++i) {
+        _m[i].h = s_timer_create(_cb, (void*)(intptr_t)i);
+        CHECK(_m[i].h >= 0);
+    }
+    // 填满定时器池后创建失败, 再释放多余的
+    timer_handle_t extra[TIMER_MAX - TIMERS + 1];
+    int n = 0;
+    while((extra[n] = s_timer_create(_cb, 0)) >= 0) n++;
+    CHECK(n == TIMER_MAX - TIMERS);
+    CHECK(s_timer_get_stat()->used == TIMER_MAX);
+    for(int k = 0; k < n; ++k) CHECK(s_timer_delete(extra[k]));
+
+    for(uint32_t s = 0; s < STEPS; ++s) {
+        if(rand() % 4 == 0) {
+            int i = rand() % TIMERS;
+            int op = rand() % 6;
+            if(op < 2) {
+                _start(i, _delay(), 0);
+            }
+            else if(op == 2) {
+                _start(i, _delay(), 1u + (uint32_t)(rand() % 500));
+            }
+            else if(op == 3) {
+                _stop(i);
+            }
+            else if(op == 4) {
+                _start(i, 1u + (uint32_t)(rand() % 50), 0);     // 运行中重新启动为短延时
+            }
+            else {
+                timer_handle_t old = _m[i].h;
+                CHECK(s_timer_delete(old));
+                CHECK(!s_timer_start(old, 5, 0) && !s_timer_delete(old));
+                _m[i].h = s_timer_create(_cb, (void*)(intptr_t)i);
+                CHECK(_m[i].h >= 0 && _m[i].h != old);
+                _m[i].active = false;
+            }
+        }
+        _step();
+        if(s % 1000 == 0) {
+            uint16_t active = 0;
+            for(int i = 0; i < TIMERS; ++i) {
+                CHECK(s_timer_is_active(_m[i].h) == _m[i].active);
+                active += _m[i].active;
+            }
+            CHECK(s_timer_get_stat()->active == active);
+        }
+    }
+
+    // 没有错过的到期
+    for(int i = 0; i < TIMERS; ++i) CHECK(!_m[i].active || (int32_t)(_m[i].expire - _ms) > 0);
+    const timer_stat_t* st = s_timer_get_stat();
+    CHECK(st->fired == _fired && st->late_max == 0 && st->used == TIMERS);
+    printf("timer: %d timers, %d ms simulated, %lu callbacks\n", TIMERS, STEPS, (unsigned long)_fired);
+}
+
+/**
+ * @brief   主循环推迟 5 s 后一次补齐: 全部单次定时器到期, 周期定时器按到期时刻连续补发
+ */
+static void _test_catch_up(void) {
+    for(int i = 0; i < TIMERS; ++i) _stop(i);
+    for(int i = 0; i < TIMERS; ++i) s_timer_start(_m[i].h, 1u + (uint32_t)i * 10u, 0);
+    s_timer_start(_m[0].h, 100, 100);
+
+    uint32_t fired = _fired;
+    _check = false;
+    _ms += 5000;
+    s_timer_task();
+    _check = true;
+    CHECK(_fired - fired == TIMERS - 1 + 50);
+    CHECK(s_timer_get_stat()->active == 1 && s_timer_get_stat()->late_max >= 4900);
+    _stop(0);
+}
+
+/**
+ * @brief   重启以最近一次启动的延时重新计时; 从未启动的定时器不能重启
+ */
+static void _test_restart(void) {
+    timer_handle_t h = s_timer_create(_cb, 0);
+    CHECK(h >= 0 && !s_timer_restart(h));
+    CHECK(s_timer_delete(h));
+
+    _start(0, 30, 0);
+    for(int k = 0; k < 10; ++k) _step();
+    CHECK(s_timer_restart(_m[0].h));
+    _m[0].expire = _ms + 30;
+    uint32_t fired = _fired;
+    for(int k = 0; k < 29; ++k) _step();
+    CHECK(_fired == fired);
+    _step();
+    CHECK(_fired == fired + 1 && !_m[0].active);
+}
+
+/**
+ * @brief   每毫秒推进的耗时: 定时器均为周期 10 ms ~ 5 s, 开销应与定时器数量基本无关
+ */
+static void _bench(void) {
+    static const int counts[] = { 10, 100, TIMERS };
+
+    _check = false;
+    for(size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+        for(int i = 0; i < TIMERS; ++i) s_timer_stop(_m[i].h);
+        for(int i = 0; i < counts[c]; ++i) {
+            s_timer_start(_m[i].h, 1u + (uint32_t)(rand() % 1000), 10u + (uint32_t)(rand() % 5000));
+        }
+
+        uint32_t fired = _fired;
+        struct timespec a, b;
+        clock_gettime(CLOCK_MONOTONIC, &a);
+        for(int k = 0; k < BENCH_STEPS; ++k) _step();
+        clock_gettime(CLOCK_MONOTONIC, &b);
+
+        double ns = ((b.tv_sec - a.tv_sec) * 1e9 + (b.tv_nsec - a.tv_nsec)) / BENCH_STEPS;
+        printf("timer: bench %3d timers: %.1f ns per ms step, %.3f callbacks per step\n", counts[c], ns,
+            (_fired - fired) / (double)BENCH_STEPS);
+    }
+    _check = true;
+}
+
+int main(void) {
+    srand(1);
+    _ms = 0xFFFFFFFFu - 50000u;                 // 运行中跨越 32 位毫秒回绕
+    s_timer_init(_clock, _cycles);
+    _test_random();
+    _test_catch_up();
+    _test_restart();
+    _bench();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -0,0 +1,90 @@
+"""Robustness and throughput check for the USART1 command parser.
+
+Sends sequenced `$CLOCK@<seq>#` commands with random junk in between: stray
+'$' / '#' / '@', over-long lines and short binary junk frames (0x00 ... 0x00).
+Every command must be ACKed exactly once and in order. Afterwards it prints
+the scanner counters from `$COMMS_STATS#` (resyncs, bytes scanned and the
+scan rate in bytes/s at full CPU).
+
+Junk never contains upper-case letters or '_', so it cannot form a real
+command name; each round waits for its ACK, so the RX ring never overflows.
+
+Usage:
+    python comms_fuzz.py --port COM3 [--baud 115200] [--count 500] [--seed 1]
+"""
+
+import random
+import re
+import sys
+import time
+
+ACK = re.compile(rb"\$(ACK|NAK):(\d+)[,#]")
+COMMS = re.compile(rb"\$COMMS:([\d,]+)#")
+JUNK = b"0123456789abcdefxyz:,.-+ !@#$\r\n"
+LINE_MAX = 128  # COMMS_LINE_MAX
+
+
+def junk(rng):
+    kind = rng.randrange(4)
+    if kind == 0:
+        return b""
+    if kind == 1:
+        return bytes(rng.choice(JUNK) for _ in range(rng.randrange(1, 40)))
+    if kind == 2:
+        # over-long line: dropped by the controller, NAKed with its own seq
+        return b"$" + b"1" * rng.randrange(LINE_MAX, 3 * LINE_MAX) + b"@%d#" % rng.randrange(256)
+    # binary junk: the decoder leaves binary mode at the closing delimiter
+    return b"\x00" + bytes(rng.randrange(1, 256) for _ in range(rng.randrange(1, 40))) + b"\x00"
+
+
+def comms_stats(link):
+    link.reset_input_buffer()
+    link.write(b"$COMMS_STATS#")
+    t0, buf = time.perf_counter(), b""
+    while time.perf_counter() - t0 < 0.5:
+        buf += link.read(link.in_waiting or 1)
+        m = COMMS.search(buf)
+        if m:
+            return [int(v) for v in m.group(1).split(b",")]
+    return None
+
+
+def run(link, count, rng, timeout=0.5):
+    lost = dup = 0
+    for i in range(count):
+        seq = i & 0xFF
+        link.write(junk(rng) + b"$CLOCK@%d#" % seq)
+        t0, buf, got = time.perf_counter(), b"", 0
+        while time.perf_counter() - t0 < timeout:
+            buf += link.read(link.in_waiting or 1)
+            got = sum(1 for kind, s in ACK.findall(buf) if kind == b"ACK" and int(s) == seq)
+            if got and not link.in_waiting:
+                break
+        lost += got == 0
+        dup += max(0, got - 1)
+    return lost, dup
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    import serial  # pyserial
+
+    link = serial.Serial(_arg("--port", ""), _arg("--baud", 115200), timeout=0.01)
+    rng = random.Random(_arg("--seed", 1))
+    count = _arg("--count", 500)
+    before = comms_stats(link)
+    lost, dup = run(link, count, rng)
+    after = comms_stats(link)
+
+    print("%d commands: %d lost, %d duplicated ACKs" % (count, lost, dup))
+    if before and after and len(after) >= 15:
+        print("rx overflow %d bytes, resync %d, scanned %d bytes, scan rate %d bytes/s"
+              % (after[11] - before[11], after[12] - before[12], after[13] - before[13], after[14]))
+    sys.exit(1 if lost or dup else 0)
+
+
+if __name__ == "__main__":
+    main()
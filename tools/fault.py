@@ -0,0 +1,151 @@
+"""Decoder for the controller's fault report ($FAULT# reply or boot report).
+
+After a HardFault or failed assert the controller resets and, on the next
+boot, prints the snapshot it kept in no-init RAM:
+    $FAULT:<reset>,<kind>,<count>,<ms>,<state>#
+    $FAULT_REGS:<r0>,<r1>,<r2>,<r3>,<r12>,<lr>,<pc>,<xpsr>,<sp>,<exc_return>#
+    $FAULT_STATUS:<cfsr>,<hfsr>,<mmfar>,<bfar>#
+    $FAULT_ASSERT:<file>:<line>#          (assert only)
+    $FAULT_TRACE:<cyc>,<ev>,<a>,<b>,<c>#  (last trace records)
+This tool names the fault status bits, resolves pc/lr to source lines with
+addr2line when given the firmware ELF (.axf), and prints the trace records
+with the same decoding as trace.py.
+
+Usage:
+    python fault.py --port COM3 [--baud 115200] [--elf firmware.axf] [--addr2line arm-none-eabi-addr2line]
+    python fault.py --load boot.log [--elf firmware.axf]
+    python fault.py --selftest
+"""
+
+import os
+import re
+import subprocess
+import sys
+import time
+
+import trace
+
+LINE = re.compile(r"\$(FAULT(?:_REGS|_STATUS|_ASSERT|_TRACE)?):([^#]*)#")
+REGS = ["r0", "r1", "r2", "r3", "r12", "lr", "pc", "xpsr", "sp", "exc_return"]
+CFSR = {0: "IACCVIOL", 1: "DACCVIOL", 3: "MUNSTKERR", 4: "MSTKERR", 7: "MMARVALID",
+        8: "IBUSERR", 9: "PRECISERR", 10: "IMPRECISERR", 11: "UNSTKERR", 12: "STKERR", 15: "BFARVALID",
+        16: "UNDEFINSTR", 17: "INVSTATE", 18: "INVPC", 19: "NOCP", 24: "UNALIGNED", 25: "DIVBYZERO"}
+HFSR = {1: "VECTTBL", 30: "FORCED", 31: "DEBUGEVT"}
+CPU_MHZ = 72  # CPU_FREQ_MHZ in dwt.h
+
+
+def bits(value, names):
+    return " ".join(n for b, n in sorted(names.items()) if value >> b & 1) or "-"
+
+
+def parse(text):
+    """Returns the report as a dict, or None when the text holds no $FAULT line."""
+    rep = None
+    for tag, body in LINE.findall(text):
+        f = body.split(",")
+        if tag == "FAULT":
+            rep = {"reset": f[0], "kind": f[1], "trace": []}
+            if f[1] != "NONE":
+                rep.update(count=int(f[2]), ms=int(f[3]), state=int(f[4]))
+        elif rep is None:
+            continue
+        elif tag == "FAULT_REGS":
+            rep["regs"] = dict(zip(REGS, (int(x, 16) for x in f)))
+        elif tag == "FAULT_STATUS":
+            rep["cfsr"], rep["hfsr"], rep["mmfar"], rep["bfar"] = (int(x, 16) for x in f)
+        elif tag == "FAULT_ASSERT":
+            rep["assert"] = body
+        elif tag == "FAULT_TRACE":
+            rep["trace"].append(tuple(int(x) for x in f))
+    return rep
+
+
+def addr2line(tool, elf, addrs):
+    out = subprocess.check_output([tool, "-f", "-C", "-e", elf] + ["0x%08x" % a for a in addrs]).decode()
+    lines = out.splitlines()
+    return ["%s (%s)" % (lines[2 * i], lines[2 * i + 1]) for i in range(len(addrs))]
+
+
+def report(rep, elf="", tool="arm-none-eabi-addr2line", names=None):
+    print("reset cause: %s" % rep["reset"])
+    if rep["kind"] == "NONE":
+        print("no fault snapshot")
+        return
+    state = trace._state(rep["state"]) if rep["state"] != 0xFF else "?"
+    print("fault: %s (#%d since last $FAULT_CLEAR#) at %d ms, FSM state %s" % (rep["kind"], rep["count"], rep["ms"],
+                                                                                 state))
+    if "assert" in rep:
+        print("assert failed: %s" % rep["assert"])
+    regs = rep.get("regs", {})
+    print("  ".join("%s=%08x" % (r, regs[r]) for r in REGS if r in regs))
+    if rep["kind"] == "HARD" and "cfsr" in rep:
+        print("CFSR %08x: %s" % (rep["cfsr"], bits(rep["cfsr"], CFSR)))
+        print("HFSR %08x: %s" % (rep["hfsr"], bits(rep["hfsr"], HFSR)))
+        if rep["cfsr"] >> 7 & 1:
+            print("MMFAR %08x (faulting data address)" % rep["mmfar"])
+        if rep["cfsr"] >> 15 & 1:
+            print("BFAR  %08x (faulting data address)" % rep["bfar"])
+        if not 0x20000000 <= regs.get("sp", 0) <= 0x20010000 - 32:
+            print("stack pointer outside SRAM (stack overflow or corrupted SP), stacked registers not read")
+    if elf and regs:
+        for r, where in zip(("pc", "lr"), addr2line(tool, elf, [regs["pc"], regs["lr"]])):
+            print("%s: %s" % (r, where))
+    if rep["trace"]:
+        print("last trace records:")
+        recs = trace.timeline(rep["trace"], CPU_MHZ)
+        t_end = recs[-1]["t_us"]
+        for r in recs:
+            print("%12.1f us  %s" % (r["t_us"] - t_end, trace.describe(r, names or {})))
+
+
+def capture(port, baud, timeout=1.0):
+    import serial  # pyserial
+
+    link = serial.Serial(port, baud, timeout=0.05)
+    link.reset_input_buffer()
+    link.write(b"$FAULT#")
+    text, t0 = b"", time.perf_counter()
+    while time.perf_counter() - t0 < timeout:
+        text += link.read(4096)
+    return text.decode("ascii", "replace")
+
+
+def selftest():
+    text = ("[INFO] Board initialized!$FAULT:SW,HARD,2,8123,2#"
+            "$FAULT_REGS:00000000,00000001,20000f00,00000003,0000000c,08001235,08002468,21000000,20004fc0,fffffff9#"
+            "$FAULT_STATUS:00008200,40000000,e000ed34,cccccccc#"
+            "$FAULT_TRACE:1000,3,4,7,0#$FAULT_TRACE:1720,5,1,0,0#")
+    rep = parse(text)
+    assert rep["kind"] == "HARD" and rep["count"] == 2 and rep["state"] == 2
+    assert rep["regs"]["pc"] == 0x08002468 and rep["bfar"] == 0xCCCCCCCC
+    assert bits(rep["cfsr"], CFSR) == "PRECISERR BFARVALID" and bits(rep["hfsr"], HFSR) == "FORCED"
+    assert rep["trace"] == [(1000, 3, 4, 7, 0), (1720, 5, 1, 0, 0)]
+    rep = parse("$FAULT:PIN,ASSERT,1,50,255#$FAULT_REGS:0,0,0,0,0,08000101,0,0,0,0#"
+                "$FAULT_STATUS:0,0,0,0#$FAULT_ASSERT:s_fault.c:312#")
+    assert rep["assert"] == "s_fault.c:312" and rep["regs"]["lr"] == 0x08000101
+    assert parse("$FAULT:POR,NONE#") == {"reset": "POR", "kind": "NONE", "trace": []}
+    print("selftest OK")
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    if "--selftest" in sys.argv:
+        selftest()
+        return
+    if "--load" in sys.argv:
+        text = open(_arg("--load", ""), "rb").read().decode("ascii", "replace")
+    else:
+        text = capture(_arg("--port", ""), _arg("--baud", 115200))
+    rep = parse(text)
+    if rep is None:
+        print("no $FAULT reply")
+        sys.exit(1)
+    src = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src")
+    report(rep, _arg("--elf", ""), _arg("--addr2line", "arm-none-eabi-addr2line"), trace.command_names(src))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,84 @@
+"""Command round-trip latency on USART1, optionally under log load.
+
+Sends `$CLOCK@<seq>#` and times each `$ACK:<seq>#`. With --flood N the
+controller first emits N log lines per second ($LOG_FLOOD), so running it once
+per BOARD_LOG_USART2 setting shows what sharing USART1 with logs costs.
+
+Usage:
+    python latency.py --port COM3 [--baud 115200] [--flood 200] [--count 200]
+"""
+
+import re
+import sys
+import time
+
+ACK = re.compile(rb"\$ACK:(\d+)#")
+LOG = re.compile(rb"\$LOG:([\d,]+)#")
+CHANNELS = {0: "USART1 (shared)", 1: "USART2", 2: "USART2 (deferred)"}
+
+
+def percentile(values, p):
+    values = sorted(values)
+    return values[min(len(values) - 1, int(p / 100.0 * len(values)))]
+
+
+def measure(link, count, timeout=0.5):
+    rtts = []
+    lost = 0
+    buf = b""
+    for i in range(count):
+        seq = i & 0xFF
+        link.reset_input_buffer()
+        buf = b""
+        t0 = time.perf_counter()
+        link.write(b"$CLOCK@%d#" % seq)
+        while time.perf_counter() - t0 < timeout:
+            buf += link.read(link.in_waiting or 1)
+            m = ACK.search(buf)
+            if m and int(m.group(1)) == seq:
+                rtts.append((time.perf_counter() - t0) * 1000.0)
+                break
+        else:
+            lost += 1
+    return rtts, lost
+
+
+def log_stats(link):
+    link.reset_input_buffer()
+    link.write(b"$LOG_STATS#")
+    t0, buf = time.perf_counter(), b""
+    while time.perf_counter() - t0 < 0.5:
+        buf += link.read(link.in_waiting or 1)
+        m = LOG.search(buf)
+        if m:
+            return [int(v) for v in m.group(1).split(b",")]
+    return None
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    import serial  # pyserial
+
+    link = serial.Serial(_arg("--port", ""), _arg("--baud", 115200), timeout=0.01)
+    flood = _arg("--flood", 0)
+    link.write(b"$LOG_FLOOD:%d#" % flood)
+    time.sleep(0.5)
+    log_stats(link)  # clears the controller-side counters
+    rtts, lost = measure(link, _arg("--count", 200))
+    stats = log_stats(link)
+    link.write(b"$LOG_FLOOD:0#")
+
+    if rtts:
+        print("flood %d lines/s: %d pings, %d lost, rtt ms min %.2f p50 %.2f p99 %.2f max %.2f"
+              % (flood, len(rtts) + lost, lost, min(rtts), percentile(rtts, 50), percentile(rtts, 99), max(rtts)))
+    if stats:
+        channel, lines, nbytes, dropped, avg_cyc, max_cyc = stats[:6]
+        print("log on %s: %d lines, %d bytes, %d dropped, %d avg / %d max cycles per line"
+              % (CHANNELS.get(channel, channel), lines, nbytes, dropped, avg_cyc, max_cyc))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,91 @@
+"""Flash report for compile-time log filtering (LOG_LEVEL / LOG_LEVEL_<module>).
+
+Scans src/ for s_log_* calls, assigns each to its module (#define LOG_MODULE
+in the file, MISC otherwise) and shows which calls a given level setting
+compiles out, with the format-string bytes and per-site RAM (log_site_t)
+they take. Code size per call depends on the compiler; pass the ELF files of
+two builds to get the real flash difference (text + data) from `size`.
+
+Usage:
+    python log_size.py [--src ../src] [--level 3] [--module FSM=4 ...]
+    python log_size.py --elf release.elf debug.elf [--size-tool arm-none-eabi-size]
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+from logdec import LITERAL, unescape
+
+LEVELS = {"error": 1, "warn": 2, "info": 3, "debug": 4}
+NAMES = {v: k.upper() for k, v in LEVELS.items()}
+CALL = re.compile(rb"\bs_log_(debug|info|warn|error)\s*\(\s*((?:\"(?:[^\"\\]|\\.)*\"\s*)+)")
+MODULE = re.compile(rb"^#define\s+LOG_MODULE\s+(\w+)", re.M)
+SITE_RAM = 16  # sizeof(log_site_t): id, ready, argc, types[LOG_MAX_ARGS], padded
+
+
+def scan(src):
+    """Yield (module, level, fmt_bytes, file:line) for every log call under src."""
+    for root, _, files in os.walk(src):
+        for name in sorted(files):
+            if not name.endswith(".c"):
+                continue
+            path = os.path.join(root, name)
+            text = open(path, "rb").read()
+            m = MODULE.search(text)
+            module = m.group(1).decode() if m else "MISC"
+            for c in CALL.finditer(text):
+                fmt = b"".join(unescape(x) for x in LITERAL.findall(c.group(2)))
+                where = "%s:%d" % (os.path.relpath(path, src), text.count(b"\n", 0, c.start()) + 1)
+                yield module, LEVELS[c.group(1).decode()], len(fmt) + 1, where
+
+
+def report(src, level, modules):
+    rows = {}
+    for module, lvl, nbytes, where in scan(src):
+        kept = lvl <= modules.get(module, level)
+        r = rows.setdefault(module, [0, 0, 0, 0])
+        r[0 if kept else 2] += 1
+        r[1 if kept else 3] += nbytes
+    print("LOG_LEVEL=%d %s" % (level, " ".join("LOG_LEVEL_%s=%d" % kv for kv in sorted(modules.items()))))
+    print("%-8s %10s %12s %10s %12s" % ("module", "kept", "kept str B", "removed", "removed str B"))
+    total = [0, 0, 0, 0]
+    for module in sorted(rows):
+        r = rows[module]
+        total = [a + b for a, b in zip(total, r)]
+        print("%-8s %10d %12d %10d %12d" % (module, r[0], r[1], r[2], r[3]))
+    print("%-8s %10d %12d %10d %12d" % ("total", *total))
+    print("removed calls save %d B of format strings in flash and %d B of RAM, plus their call code"
+          % (total[3], total[2] * SITE_RAM))
+
+
+def flash(path, tool):
+    out = subprocess.check_output([tool, path]).decode().splitlines()
+    text, data = out[1].split()[:2]
+    return int(text) + int(data)
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    if "--elf" in sys.argv:
+        i = sys.argv.index("--elf")
+        a, b = sys.argv[i + 1], sys.argv[i + 2]
+        tool = _arg("--size-tool", "arm-none-eabi-size")
+        fa, fb = flash(a, tool), flash(b, tool)
+        print("%s: %d B flash\n%s: %d B flash\ndifference %+d B" % (a, fa, b, fb, fb - fa))
+        return
+    src = _arg("--src", os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+    modules = {}
+    for i, arg in enumerate(sys.argv):
+        if arg == "--module":
+            name, lvl = sys.argv[i + 1].split("=")
+            modules[name.upper()] = int(lvl)
+    report(src, _arg("--level", 3), modules)
+
+
+if __name__ == "__main__":
+    main()
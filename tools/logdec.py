@@ -0,0 +1,221 @@
+"""Host-side decoder for deferred binary logs (s_log with LOG_DEFERRED).
+
+The controller does not format log lines. Each s_log_debug/info/warn/error call
+sends a LOG frame (proto_bin type 0xA3):
+    level:u8, id:u32, ms:u32, raw arguments
+Here id is the FNV-1a hash of the format string. This tool builds the
+id -> format table by scanning the s_log_* calls in the source tree. Run it
+with --gen as a build step to save the table next to the firmware, or let it
+scan --src at decode time. Argument layout follows the format string:
+integers, chars and pointers are u32, %ll* is u64, floats are f32, and
+strings are u8 length + bytes. Gaps in the frame sequence number are records
+the controller dropped because its log ring was full.
+
+Usage:
+    python logdec.py --gen log_table.json [--src ../src]
+    python logdec.py --port COM4 [--baud 921600] [--table log_table.json | --src ../src]
+    python logdec.py --selftest
+"""
+
+import json
+import os
+import re
+import struct
+import sys
+
+import proto_bin
+
+LOG = 0xA3
+LEVELS = {1: "ERROR", 2: "WARN", 3: "INFO", 4: "DEBUG"}
+CALL = re.compile(rb"\bs_log_(?:debug|info|warn|error)\s*\(\s*((?:\"(?:[^\"\\]|\\.)*\"\s*)+)")
+LITERAL = re.compile(rb"\"((?:[^\"\\]|\\.)*)\"")
+SPEC = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d+))?(hh|h|ll|l|z|j|t)?([diuxXocpfFeEgGs%])")
+ESCAPES = {b"n": b"\n", b"t": b"\t", b"r": b"\r", b"0": b"\0", b"\\": b"\\", b"\"": b"\"", b"'": b"'"}
+
+
+def fnv1a(data):
+    h = 2166136261
+    for b in data:
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def unescape(lit):
+    """C string literal body -> bytes, as the compiler stores it (source is UTF-8)."""
+    out, i = bytearray(), 0
+    while i < len(lit):
+        if lit[i:i + 1] != b"\\":
+            out += lit[i:i + 1]
+            i += 1
+        elif lit[i + 1:i + 2] == b"x":
+            m = re.match(rb"[0-9a-fA-F]+", lit[i + 2:])
+            out.append(int(m.group(0), 16) & 0xFF)
+            i += 2 + len(m.group(0))
+        else:
+            out += ESCAPES.get(lit[i + 1:i + 2], lit[i + 1:i + 2])
+            i += 2
+    return bytes(out)
+
+
+def scan(src):
+    """Return {id: {"fmt", "file", "line"}} for every s_log_* call under src."""
+    table = {}
+    for root, _, files in os.walk(src):
+        for name in sorted(files):
+            if not name.endswith((".c", ".h")):
+                continue
+            path = os.path.join(root, name)
+            text = open(path, "rb").read()
+            for m in CALL.finditer(text):
+                fmt = b"".join(unescape(x) for x in LITERAL.findall(m.group(1)))
+                site = {"fmt": fmt.decode("utf-8", "replace"), "file": os.path.relpath(path, src),
+                        "line": text.count(b"\n", 0, m.start()) + 1}
+                old = table.setdefault(fnv1a(fmt), site)
+                if old["fmt"] != site["fmt"]:
+                    raise ValueError("log id collision: %s:%d and %s:%d"
+                                     % (old["file"], old["line"], site["file"], site["line"]))
+    return table
+
+
+def arg_types(fmt):
+    """Same classification as _parse_site in s_log.c: one letter per stored argument."""
+    types = []
+    for flags, width, prec, length, conv in SPEC.findall(fmt):
+        if conv == "%":
+            continue
+        types += ["i"] * ((width == "*") + (prec == "*"))
+        if conv in "fFeEgG":
+            types.append("f")
+        elif conv == "s":
+            types.append("s")
+        else:
+            types.append("l" if length == "ll" else "i")
+    return types[:8]  # LOG_MAX_ARGS
+
+
+def unpack_args(types, data):
+    args, pos = [], 0
+    for t in types:
+        if t == "s":
+            if pos >= len(data):
+                break
+            n = data[pos]
+            args.append(data[pos + 1:pos + 1 + n].decode("utf-8", "replace"))
+            pos += 1 + n
+            continue
+        size, code = {"i": (4, "<I"), "l": (8, "<Q"), "f": (4, "<f")}[t]
+        if pos + size > len(data):
+            break
+        args.append(struct.unpack_from(code, data, pos)[0])
+        pos += size
+    return args
+
+
+def render(fmt, args):
+    """printf-style formatting on the host; arguments the controller truncated show as '?'."""
+    it = iter(args)
+
+    def one(m):
+        flags, width, prec, length, conv = m.groups()
+        if conv == "%":
+            return "%"
+        try:
+            if width == "*":
+                width = str(next(it))
+            if prec == "*":
+                prec = str(next(it))
+            v = next(it)
+        except StopIteration:
+            return "?"
+        if conv in "di":
+            bits = 64 if length == "ll" else 32
+            v = v - (1 << bits) if v >= 1 << (bits - 1) else v
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if conv == "p":
+            return "0x%08x" % v
+        if conv == "c":
+            return chr(v & 0xFF)
+        return (spec + ("d" if conv in "diu" else conv)) % v
+
+    return SPEC.sub(one, fmt)
+
+
+class Stream:
+    """Feeds raw UART bytes, returns decoded log lines and counts dropped records."""
+
+    def __init__(self, table):
+        self.table = table
+        self.dec = proto_bin.Decoder()
+        self.records = 0
+        self.dropped = 0
+        self._last_seq = None
+
+    def feed(self, data):
+        lines = []
+        for msg_type, seq, payload in self.dec.feed(data):
+            if msg_type != LOG or len(payload) < 9:
+                continue
+            if self._last_seq is not None:
+                self.dropped += (seq - self._last_seq - 1) & 0xFF
+            self._last_seq = seq
+            self.records += 1
+            level, log_id, ms = struct.unpack_from("<BII", payload)
+            site = self.table.get(log_id)
+            if site is None:
+                lines.append("%10d [%s] <unknown id 0x%08x>" % (ms, LEVELS.get(level, level), log_id))
+                continue
+            text = render(site["fmt"], unpack_args(arg_types(site["fmt"]), payload[9:]))
+            lines.append("%10d [%s] %s" % (ms, LEVELS.get(level, level), text))
+        return lines
+
+
+def load_table(path):
+    return {int(k): v for k, v in json.load(open(path)).items()}
+
+
+def selftest():
+    assert fnv1a(b"") == 2166136261 and fnv1a(b"a") == 0xE40C292C
+    assert unescape(rb"a\n\x41\"") == b"a\nA\""
+    table = {fnv1a(b"pos %d mm, v=%.2f %s %%"): {"fmt": "pos %d mm, v=%.2f %s %%", "file": "x.c", "line": 1},
+             fnv1a(b"id %lu"): {"fmt": "id %lu", "file": "x.c", "line": 2}}
+    assert arg_types("%*d %llu %c %5.1f %s") == ["i", "i", "l", "i", "f", "s"]
+    rec1 = struct.pack("<BII", 3, fnv1a(b"pos %d mm, v=%.2f %s %%"), 1500) + struct.pack("<if", -12, 2.5) + b"\x02ok"
+    rec2 = struct.pack("<BII", 2, fnv1a(b"id %lu"), 1501)  # argument truncated
+    wire = proto_bin.encode(LOG, 0, rec1) + proto_bin.encode(LOG, 3, rec2)
+    stream = Stream(table)
+    lines = stream.feed(wire)
+    assert lines == ["      1500 [INFO] pos -12 mm, v=2.50 ok %", "      1501 [WARN] id ?"], lines
+    assert stream.records == 2 and stream.dropped == 2
+    print("selftest OK")
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    src = _arg("--src", os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+    if "--selftest" in sys.argv:
+        selftest()
+        return
+    if "--gen" in sys.argv:
+        table = scan(src)
+        json.dump({str(k): v for k, v in sorted(table.items())}, open(_arg("--gen", ""), "w"), indent=1)
+        print("%d log sites" % len(table))
+        return
+
+    import serial  # pyserial
+
+    table = load_table(_arg("--table", "")) if "--table" in sys.argv else scan(src)
+    link = serial.Serial(_arg("--port", ""), _arg("--baud", 921600), timeout=0.05)
+    stream = Stream(table)
+    try:
+        while True:
+            for line in stream.feed(link.read(4096)):
+                print(line)
+    except KeyboardInterrupt:
+        print("%d records, %d dropped" % (stream.records, stream.dropped))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,134 @@
+"""Reader for the controller's cycle profiler ($PROF# reply).
+
+The controller answers $PROF# with
+    $PROF_INFO:<cpu_mhz>,<probe_overhead>,<bins>#
+    $PROF:<name>,<n>,<min>,<mean>,<max>,<hist_0>,...,<hist_bins-1>#   (one per probe)
+Times are CPU cycles with the probe overhead already removed. Histogram bin 0
+counts 0-cycle samples, bin k counts [2^(k-1), 2^k) cycles and the last bin
+everything longer. This tool prints the table in microseconds with p99 taken
+from the histogram (upper bin edge capped at the maximum, so an upper bound),
+and compares two captures to check a performance change.
+
+Usage:
+    python prof.py --port COM3 [--baud 115200] [--clear] [--wait 10] [--save after.txt] [--compare before.txt] [--hist]
+    python prof.py --load after.txt [--compare before.txt] [--hist]
+    python prof.py --selftest
+"""
+
+import re
+import sys
+import time
+
+LINE = re.compile(r"\$(PROF_INFO|PROF):([^#]*)#")
+
+
+def parse(text):
+    """Returns {"mhz", "overhead", "probes": {name: {...}}}, or None when the text holds no $PROF_INFO line."""
+    rep = None
+    for tag, body in LINE.findall(text):
+        f = body.split(",")
+        if tag == "PROF_INFO":
+            rep = {"mhz": int(f[0]), "overhead": int(f[1]), "probes": {}}
+        elif rep is not None and len(f) > 5:
+            n, lo, mean, hi = (int(x) for x in f[1:5])
+            rep["probes"][f[0]] = {"n": n, "min": lo, "mean": mean, "max": hi, "hist": [int(x) for x in f[5:]]}
+    return rep
+
+
+def percentile(hist, q):
+    """Upper edge (cycles) of the bin holding the q-quantile sample."""
+    total = sum(hist)
+    if not total:
+        return 0
+    seen = 0
+    for k, c in enumerate(hist):
+        seen += c
+        if seen >= q * total:
+            return (1 << k) - 1 if k < len(hist) - 1 else float("inf")
+    return float("inf")
+
+
+def _us(cyc, mhz):
+    return "inf" if cyc == float("inf") else "%.2f" % (cyc / mhz)
+
+
+def report(rep, base=None, hist=False):
+    mhz = rep["mhz"]
+    print("%d MHz, probe overhead %d cycles (removed)" % (mhz, rep["overhead"]))
+    print("%-12s %9s %10s %10s %10s %10s %10s" % ("probe", "n", "min us", "mean us", "p99<= us", "max us",
+                                                  "mean vs base"))
+    for name, p in rep["probes"].items():
+        if not p["n"]:
+            print("%-12s %9d" % (name, 0))
+            continue
+        delta = ""
+        b = (base or {}).get("probes", {}).get(name)
+        if b and b["n"] and b["mean"]:
+            delta = "%+.1f%%" % (100.0 * (p["mean"] - b["mean"]) / b["mean"])
+        p99 = min(percentile(p["hist"], 0.99), p["max"])
+        print("%-12s %9d %10s %10s %10s %10s %10s" % (name, p["n"], _us(p["min"], mhz), _us(p["mean"], mhz),
+                                                      _us(p99, mhz), _us(p["max"], mhz), delta))
+        if hist:
+            top = max(p["hist"])
+            for k, c in enumerate(p["hist"]):
+                if c:
+                    lo = 0 if k == 0 else 1 << (k - 1)
+                    print("    %9s cyc  %8d %s" % (">=%d" % lo, c, "#" * max(1, 40 * c // top)))
+
+
+def capture(port, baud, clear=False, wait=0.0, timeout=1.0):
+    import serial  # pyserial
+
+    link = serial.Serial(port, baud, timeout=0.05)
+    if clear:
+        link.write(b"$PROF_CLR#")
+        time.sleep(wait)
+    link.reset_input_buffer()
+    link.write(b"$PROF#")
+    text, t0 = b"", time.perf_counter()
+    while time.perf_counter() - t0 < timeout:
+        text += link.read(4096)
+    return text.decode("ascii", "replace")
+
+
+def selftest():
+    hist = [0] * 24
+    hist[9], hist[10] = 99, 1
+    text = ("$ACK:1#$PROF_INFO:72,1,24#$PROF:PID_CALC,100,300,520,700,%s#$PROF:CAN_SEND,0,0,0,0,%s#"
+            % (",".join(map(str, hist)), ",".join(["0"] * 24)))
+    rep = parse(text)
+    assert rep["mhz"] == 72 and rep["overhead"] == 1
+    p = rep["probes"]["PID_CALC"]
+    assert (p["n"], p["min"], p["mean"], p["max"]) == (100, 300, 520, 700) and len(p["hist"]) == 24
+    assert percentile(p["hist"], 0.5) == 511 and percentile(p["hist"], 0.995) == 1023
+    assert rep["probes"]["CAN_SEND"]["n"] == 0
+    assert parse("$PROF:OFF#") is None
+    print("selftest OK")
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    if "--selftest" in sys.argv:
+        selftest()
+        return
+    if "--load" in sys.argv:
+        text = open(_arg("--load", ""), "rb").read().decode("ascii", "replace")
+    else:
+        text = capture(_arg("--port", ""), _arg("--baud", 115200), "--clear" in sys.argv, _arg("--wait", 10.0))
+    rep = parse(text)
+    if rep is None:
+        print("no $PROF reply (profiler disabled with PROF_ENABLE=0?)")
+        sys.exit(1)
+    if "--save" in sys.argv:
+        open(_arg("--save", ""), "w").write(text)
+    base = None
+    if "--compare" in sys.argv:
+        base = parse(open(_arg("--compare", ""), "rb").read().decode("ascii", "replace"))
+    report(rep, base, "--hist" in sys.argv)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,370 @@
+"""Host-side codec for the Lift-Gripper-Controller binary protocol.
+
+Frame (before COBS): [type:u8][seq:u8][payload][crc16:u16 LE]
+CRC-16/CCITT-FALSE over type + seq + payload. Frames are COBS encoded and
+sent as 0x00 <cobs> 0x00; the leading 0x00 switches the controller's parser
+from ASCII to binary. Layouts match src/service/s_wireless_comms.h.
+
+Usage:
+    python proto_bin.py            # print bytes-per-command and codec timing
+    python proto_bin.py --selftest
+"""
+
+import struct
+import sys
+import time
+
+DELIM = 0x00
+MAX_PAYLOAD = 48
+WINDOW = 4  # COMMS_WINDOW: commands in flight without an ACK/NAK
+
+# Message types (comms_msg_e)
+LIFT_UP = 0x01
+LIFT_DOWN = 0x02
+LIFT_STOP = 0x03
+LIFT_SET = 0x04
+CLOCK = 0x05
+ESTOP = 0x06
+GRIP_OPEN = 0x10
+GRIP_CLOSE = 0x11
+GRIP_SET = 0x12
+PID_GET = 0x20
+PID_GAIN = 0x21
+PID_PARAM = 0x22
+PID_STREAM = 0x23
+AT = 0x30
+ACK = 0x80
+DONE = 0x81
+RX_OVF = 0x82
+PID_INFO = 0xA0
+CLOCK_INFO = 0xA2
+PID_SAMPLE = 0xA6  # PID stream on the log channel (s_pid_tuner.h)
+WAVE = 0xA7  # s_log_wave frames on the log channel (s_log.h)
+
+# Status codes (comms_status_e)
+STATUS = {0: "OK", 1: "UNKNOWN", 2: "LENGTH", 3: "ARG", 4: "BUSY", 5: "ABORTED", 6: "FAULT"}
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) & 0xFFFF if crc & 0x8000 else (crc << 1) & 0xFFFF
+    return crc
+
+
+def cobs_encode(raw):
+    out = bytearray()
+    block = bytearray()
+    for b in raw:
+        if b == 0:
+            out.append(len(block) + 1)
+            out += block
+            block = bytearray()
+        else:
+            block.append(b)
+            if len(block) == 254:
+                out.append(255)
+                out += block
+                block = bytearray()
+    out.append(len(block) + 1)
+    out += block
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0:
+            raise ValueError("bad COBS block")
+        block = data[i + 1:i + code]
+        if len(block) != code - 1:
+            raise ValueError("truncated COBS block")
+        out += block
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def encode(msg_type, seq, payload=b""):
+    """Build a complete wire frame including both delimiters."""
+    if len(payload) > MAX_PAYLOAD:
+        raise ValueError("payload too long")
+    raw = bytes([msg_type, seq & 0xFF]) + bytes(payload)
+    raw += struct.pack("<H", crc16(raw))
+    return bytes([DELIM]) + cobs_encode(raw) + bytes([DELIM])
+
+
+class Decoder:
+    """Incremental decoder: feed() bytes, get back (type, seq, payload) tuples."""
+
+    def __init__(self):
+        self._buf = bytearray()
+        self.crc_errors = 0
+        self.frame_errors = 0
+
+    def feed(self, data):
+        frames = []
+        for b in data:
+            if b != DELIM:
+                self._buf.append(b)
+                continue
+            if not self._buf:
+                continue
+            chunk, self._buf = bytes(self._buf), bytearray()
+            try:
+                raw = cobs_decode(chunk)
+            except ValueError:
+                self.frame_errors += 1
+                continue
+            if len(raw) < 4:
+                self.frame_errors += 1
+                continue
+            body, crc = raw[:-2], struct.unpack("<H", raw[-2:])[0]
+            if crc16(body) != crc:
+                self.crc_errors += 1
+                continue
+            frames.append((body[0], body[1], body[2:]))
+        return frames
+
+
+# Command builders ---------------------------------------------------------
+
+def lift_up(seq):
+    return encode(LIFT_UP, seq)
+
+
+def lift_down(seq):
+    return encode(LIFT_DOWN, seq)
+
+
+def lift_stop(seq):
+    return encode(LIFT_STOP, seq)
+
+
+def lift_set(seq, mm):
+    return encode(LIFT_SET, seq, struct.pack("<f", mm))
+
+
+def grip_open(seq):
+    return encode(GRIP_OPEN, seq)
+
+
+def grip_close(seq):
+    return encode(GRIP_CLOSE, seq)
+
+
+def grip_set(seq, rad):
+    return encode(GRIP_SET, seq, struct.pack("<f", rad))
+
+
+def pid_get(seq, pid_id):
+    return encode(PID_GET, seq, struct.pack("<B", pid_id))
+
+
+def pid_gain(seq, pid_id, kp, ki, kd):
+    return encode(PID_GAIN, seq, struct.pack("<B3f", pid_id, kp, ki, kd))
+
+
+def pid_param(seq, pid_id, max_out, isep, dead_band, alpha, rate):
+    return encode(PID_PARAM, seq, struct.pack("<B5f", pid_id, max_out, isep, dead_band, alpha, rate))
+
+
+def pid_stream(seq, pid_id, enable):
+    return encode(PID_STREAM, seq, struct.pack("<BB", pid_id, 1 if enable else 0))
+
+
+def clock(seq):
+    return encode(CLOCK, seq)
+
+
+def estop(seq):
+    """Emergency stop: recognized by the controller's RX interrupt, which opens
+    the relay at once; the frame is then ACKed like any other command."""
+    return encode(ESTOP, seq)
+
+
+def at(t_ms, frame):
+    """Wrap a command frame built above so it executes at controller time t_ms.
+
+    The controller ACKs when the command is queued and sends DONE when it has
+    run (motion commands: when the move ends)."""
+    msg_type, seq, payload = Decoder().feed(frame)[0]
+    return encode(AT, seq, struct.pack("<IB", t_ms & 0xFFFFFFFF, msg_type) + payload)
+
+
+# Reply parsers -------------------------------------------------------------
+
+def parse_reply(msg_type, seq, payload):
+    if msg_type in (ACK, DONE) and len(payload) == 2:
+        kind = "DONE" if msg_type == DONE else ("ACK" if payload[1] == 0 else "NAK")
+        return {"type": kind, "seq": seq, "cmd": payload[0], "status": STATUS.get(payload[1], payload[1])}
+    if msg_type == CLOCK_INFO and len(payload) == 4:
+        return {"type": "CLOCK", "seq": seq, "ms": struct.unpack("<I", payload)[0]}
+    if msg_type == RX_OVF and len(payload) == 4:
+        return {"type": "RX_OVF", "dropped": struct.unpack("<I", payload)[0]}
+    if msg_type == PID_INFO and len(payload) == 35:
+        pid_id, mode, features = payload[0], payload[1], payload[2]
+        names = ("kp", "ki", "kd", "max_out", "integral_separation", "dead_band", "diff_filter_alpha", "output_max_rate")
+        values = struct.unpack("<8f", payload[3:])
+        reply = {"type": "PID_INFO", "seq": seq, "id": pid_id, "mode": mode, "features": features}
+        reply.update(zip(names, values))
+        return reply
+    if msg_type == PID_SAMPLE and len(payload) == 29:
+        names = ("target", "actual", "p_out", "i_out", "d_out", "output")
+        tick = struct.unpack("<I", payload[1:5])[0]
+        reply = {"type": "PID_SAMPLE", "seq": seq, "id": payload[0], "tick_ms": tick}
+        reply.update(zip(names, struct.unpack("<6f", payload[5:])))
+        return reply
+    return {"type": msg_type, "seq": seq, "payload": payload}
+
+
+# Pipelining ---------------------------------------------------------------
+
+class Window:
+    """Tracks commands in flight so at most WINDOW are sent without an ACK/NAK.
+
+    send(seq, frame) queues a frame; call pop_ready() to get frames that may go
+    on the wire now and on_reply() with each parsed reply. Commands answered by
+    NAK, or still un-ACKed after an RX_OVF notification, are returned by
+    on_reply() for the caller to resend or report.
+    """
+
+    def __init__(self, size=WINDOW):
+        self.size = size
+        self._queue = []
+        self._in_flight = {}
+        self.done = {}
+
+    def send(self, seq, frame):
+        self._queue.append((seq & 0xFF, frame))
+
+    def pop_ready(self):
+        ready = []
+        while self._queue and len(self._in_flight) < self.size:
+            seq, frame = self._queue.pop(0)
+            self._in_flight[seq] = frame
+            ready.append(frame)
+        return ready
+
+    def on_reply(self, reply):
+        kind = reply.get("type")
+        if kind == "ACK":
+            self._in_flight.pop(reply["seq"], None)
+        elif kind == "NAK":
+            frame = self._in_flight.pop(reply["seq"], None)
+            return [(reply["seq"], frame, reply["status"])]
+        elif kind == "DONE":
+            self.done[reply["seq"]] = reply["status"]
+        elif kind == "RX_OVF":
+            lost = [(seq, frame, "RX_OVF") for seq, frame in self._in_flight.items()]
+            self._in_flight.clear()
+            return lost
+        return []
+
+    @property
+    def in_flight(self):
+        return len(self._in_flight)
+
+
+# Clock sync ---------------------------------------------------------------
+
+class ClockSync:
+    """Estimates controller time from host time using CLOCK round trips.
+
+    For each CLOCK command call add(t_send, ctrl_ms, t_recv) with host times in
+    seconds. The controller stamps its reply at some point in the round trip,
+    so the offset is taken at the midpoint of the fastest round trip seen; its
+    error is at most half that round trip.
+    """
+
+    def __init__(self):
+        self.offset_ms = None
+        self.rtt_ms = None
+
+    def add(self, t_send, ctrl_ms, t_recv):
+        rtt = (t_recv - t_send) * 1000.0
+        if self.rtt_ms is None or rtt < self.rtt_ms:
+            self.rtt_ms = rtt
+            self.offset_ms = ctrl_ms - (t_send + t_recv) * 500.0
+
+    def to_controller(self, t_host):
+        """Controller time in ms for a host time.perf_counter() value."""
+        return int(round(t_host * 1000.0 + self.offset_ms)) & 0xFFFFFFFF
+
+
+# Benchmark -----------------------------------------------------------------
+
+_CASES = [
+    ("$LIFT_UP#", lambda s: lift_up(s)),
+    ("$LIFT_STOP#", lambda s: lift_stop(s)),
+    ("$LIFT_SET:150.5#", lambda s: lift_set(s, 150.5)),
+    ("$GRIP_SET:1.57#", lambda s: grip_set(s, 1.57)),
+    ("$PID_GET:0#", lambda s: pid_get(s, 0)),
+    ("$PID_GAIN:0,1.250000,0.010000,0.100000#", lambda s: pid_gain(s, 0, 1.25, 0.01, 0.1)),
+    ("$PID_PARAM:0,100.0,50.0,5.0,0.2,500.0#", lambda s: pid_param(s, 0, 100.0, 50.0, 5.0, 0.2, 500.0)),
+    ("$PID_STREAM:0,1#", lambda s: pid_stream(s, 0, True)),
+]
+
+
+def bench():
+    print("%-42s %6s %6s" % ("command", "ascii", "binary"))
+    for ascii_cmd, build in _CASES:
+        print("%-42s %6d %6d" % (ascii_cmd, len(ascii_cmd), len(build(1))))
+
+    frames = [build(i) for i, (_, build) in enumerate(_CASES)]
+    stream = b"".join(frames) * 200
+    dec = Decoder()
+    t0 = time.perf_counter()
+    n = len(dec.feed(stream))
+    dt = time.perf_counter() - t0
+    print("host decode: %d frames, %.1f us/frame" % (n, dt * 1e6 / max(n, 1)))
+    print("target parse cycles: send $COMMS_STATS# after a run "
+          "(ascii avg/max vs binary avg/max, bytes per command = bytes / count)")
+
+
+def selftest():
+    for n in (0, 1, 253, 254, 255, 600):
+        raw = bytes((i % 255) + 1 if i % 7 else 0 for i in range(n))
+        assert cobs_decode(cobs_encode(raw)) == raw, n
+    assert crc16(b"123456789") == 0x29B1
+    dec = Decoder()
+    wire = pid_gain(7, 0, 1.0, 2.0, 3.0) + lift_stop(8)
+    frames = dec.feed(wire)
+    assert [(t, s) for t, s, _ in frames] == [(PID_GAIN, 7), (LIFT_STOP, 8)]
+    sample = struct.pack("<BI6f", 0, 1234, 10.0, 9.5, 1.0, 0.25, -0.5, 0.75)
+    (msg_type, seq, payload), = dec.feed(encode(PID_SAMPLE, 3, sample))
+    reply = parse_reply(msg_type, seq, payload)
+    assert reply["type"] == "PID_SAMPLE" and reply["tick_ms"] == 1234 and reply["output"] == 0.75
+    corrupt = bytearray(lift_set(9, 10.0))
+    corrupt[3] ^= 0x01
+    assert dec.feed(bytes(corrupt)) == [] and dec.crc_errors == 1
+    win = Window(2)
+    for seq in range(3):
+        win.send(seq, lift_stop(seq))
+    assert len(win.pop_ready()) == 2 and win.pop_ready() == []
+    win.on_reply(parse_reply(ACK, 0, bytes([LIFT_STOP, 0])))
+    assert len(win.pop_ready()) == 1
+    assert win.on_reply(parse_reply(ACK, 1, bytes([LIFT_STOP, 4])))[0][2] == "BUSY"
+    win.on_reply(parse_reply(DONE, 2, bytes([LIFT_SET, 5])))
+    assert win.done[2] == "ABORTED" and win.in_flight == 1
+    timed = dec.feed(at(123456, grip_set(10, 1.5)))[0]
+    assert timed[:2] == (AT, 10) and timed[2] == struct.pack("<IBf", 123456, GRIP_SET, 1.5)
+    assert parse_reply(CLOCK_INFO, 11, struct.pack("<I", 5000))["ms"] == 5000
+    sync = ClockSync()
+    sync.add(10.000, 5020, 10.050)
+    sync.add(11.000, 6003, 11.004)
+    assert sync.rtt_ms < 5 and sync.to_controller(12.0) == 7001
+    # the RX interrupt matches e-stop frames by length: 4 raw bytes, always 5 after COBS
+    assert all(len(estop(seq)) == 7 for seq in range(256))
+    print("selftest OK")
+
+
+if __name__ == "__main__":
+    if "--selftest" in sys.argv:
+        selftest()
+    else:
+        bench()
@@ -0,0 +1,119 @@
+"""Host-side decoder and link budget for Lift-Gripper-Controller telemetry.
+
+Telemetry frames use the binary protocol of proto_bin.py with type TELEMETRY
+(0xA1); the payload layout matches src/service/s_telemetry.h:
+    tick_ms:u32, pos_mm, speed_mm_s, target_mm, grip_rad: f32, relay_dir:u8, state_id:u8
+
+Usage:
+    python telemetry.py                      # link budget per baud rate
+    python telemetry.py --port COM4 [--baud 921600] [--cmd-port COM3] [--rate 100] [--seconds 5]
+
+Telemetry is sent on the log channel (USART2 when BOARD_LOG_USART2 is set),
+while $TLM_RATE goes to the command port (USART1); --cmd-port defaults to
+--port for boards that share USART1.
+    python telemetry.py --selftest
+"""
+
+import struct
+import sys
+import time
+
+import proto_bin
+
+TELEMETRY = 0xA1
+PAYLOAD = struct.Struct("<I4fBB")
+MAX_HZ = 100  # TELEMETRY_MAX_HZ
+BAUDS = (115200, 230400, 460800, 921600)
+RELAY_DIR = {0: "STOP", 1: "A", 2: "B"}
+
+
+def parse(payload):
+    tick, pos, speed, target, grip, relay, state = PAYLOAD.unpack(payload)
+    return {"tick_ms": tick, "pos_mm": pos, "speed_mm_s": speed, "target_mm": target,
+            "grip_rad": grip, "relay_dir": RELAY_DIR.get(relay, relay), "state_id": state}
+
+
+class Stream:
+    """Feeds raw UART bytes, yields telemetry samples and counts lost frames by seq."""
+
+    def __init__(self):
+        self.dec = proto_bin.Decoder()
+        self.frames = 0
+        self.lost = 0
+        self._last_seq = None
+
+    def feed(self, data):
+        samples = []
+        for msg_type, seq, payload in self.dec.feed(data):
+            if msg_type != TELEMETRY or len(payload) != PAYLOAD.size:
+                continue
+            if self._last_seq is not None:
+                self.lost += (seq - self._last_seq - 1) & 0xFF
+            self._last_seq = seq
+            self.frames += 1
+            samples.append(parse(payload))
+        return samples
+
+
+def frame_bytes():
+    """Worst-case wire size of one telemetry frame (COBS overhead is fixed below 254 bytes)."""
+    return len(proto_bin.encode(TELEMETRY, 0, bytes(PAYLOAD.size)))
+
+
+def budget():
+    n = frame_bytes()
+    print("telemetry frame: %d payload bytes, %d bytes on the wire (8N1 = 10 bits/byte)" % (PAYLOAD.size, n))
+    print("%8s %10s %12s" % ("baud", "max Hz", "load@%dHz" % MAX_HZ))
+    for baud in BAUDS:
+        bytes_per_s = baud / 10.0
+        print("%8d %10d %11.1f%%" % (baud, bytes_per_s // n, 100.0 * MAX_HZ * n / bytes_per_s))
+
+
+def capture(port, baud, cmd_port, rate, seconds):
+    import serial  # pyserial, only needed for live capture
+
+    link = serial.Serial(port, baud, timeout=0.05)
+    cmd = link if cmd_port in ("", port) else serial.Serial(cmd_port, 115200, timeout=0.05)
+    cmd.write(b"$TLM_RATE:%d#" % rate)
+    stream = Stream()
+    first = last = None
+    total = 0
+    t0 = time.perf_counter()
+    while time.perf_counter() - t0 < seconds:
+        data = link.read(4096)
+        total += len(data)
+        for s in stream.feed(data):
+            first = s if first is None else first
+            last = s
+    cmd.write(b"$TLM_RATE:0#")
+    dt = time.perf_counter() - t0
+    print("%d frames, %d lost, %.1f Hz, %.0f B/s (%.1f%% of link)"
+          % (stream.frames, stream.lost, stream.frames / dt, total / dt, 100.0 * total * 10 / dt / baud))
+    if first and last:
+        print("target ticks %d -> %d ms, last sample %s" % (first["tick_ms"], last["tick_ms"], last))
+
+
+def selftest():
+    sample = PAYLOAD.pack(1234, 10.5, -2.5, 150.5, 1.57, 2, 5)
+    wire = b"".join(proto_bin.encode(TELEMETRY, seq, sample) for seq in (0, 1, 3))
+    stream = Stream()
+    got = stream.feed(wire + proto_bin.lift_stop(9))
+    assert len(got) == 3 and stream.lost == 1
+    assert got[0]["tick_ms"] == 1234 and got[0]["relay_dir"] == "B" and got[0]["state_id"] == 5
+    assert abs(got[0]["target_mm"] - 150.5) < 1e-6
+    assert frame_bytes() == PAYLOAD.size + 7
+    print("selftest OK")
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+if __name__ == "__main__":
+    if "--selftest" in sys.argv:
+        selftest()
+    elif "--port" in sys.argv:
+        capture(_arg("--port", ""), _arg("--baud", 921600), _arg("--cmd-port", ""), _arg("--rate", MAX_HZ),
+                _arg("--seconds", 5.0))
+    else:
+        budget()
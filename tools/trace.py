@@ -0,0 +1,243 @@
+"""Host-side decoder for s_trace dumps: event timeline and latencies.
+
+$TRACE_DUMP# makes the controller send its trace ring on the log channel as
+one TRACE_INFO frame (0xA4) followed by TRACE frames (0xA5), each holding up
+to 4 records of 12 bytes (layout in src/service/s_trace.h):
+    cyc:u32 (DWT), ev:u8, a:u8, b:u16, c:u32
+Timestamps are unwrapped with signed 32-bit deltas and tied to controller
+milliseconds by the CLOCK records the controller writes every 10 s. ASCII
+command names are recovered from their FNV-1a hash by scanning the command
+tables in src/.
+
+Usage:
+    python trace.py --port COM4 [--baud 921600] [--cmd-port COM3] [--save dump.bin]
+    python trace.py --load dump.bin [--src ../src]
+    python trace.py --selftest
+"""
+
+import os
+import re
+import struct
+import sys
+import time
+
+import proto_bin
+from logdec import fnv1a
+
+TRACE_INFO = 0xA4
+TRACE = 0xA5
+REC = struct.Struct("<IBBHI")
+INFO = struct.Struct("<IHIBB")
+
+EVENTS = {1: "CLOCK", 2: "FSM", 3: "CMD", 4: "REPLY", 5: "RELAY", 6: "CAN_TX", 7: "CAN_RX", 8: "FAULT"}
+FAULTS = {1: "ESTOP", 2: "FSM_ERROR", 3: "CAN_TX"}
+# a_fsm.c _states[] order and event_e
+STATES = ["normal", "idle", "lift_moving", "error", "pick", "pick_approach", "pick_grasp", "pick_retract",
+          "pick_release"]
+FSM_EVENTS = ["NONE", "OK", "ERROR", "LIFT_MOVE", "LIFT_STOP", "PICK_START", "PICK_NEXT", "PICK_ABORT"]
+RELAY = {0: "STOP", 1: "A", 2: "B"}
+MSG = {getattr(proto_bin, k): k for k in ("LIFT_UP", "LIFT_DOWN", "LIFT_STOP", "LIFT_SET", "CLOCK", "ESTOP", "GRIP_OPEN",
+                                          "GRIP_CLOSE", "GRIP_SET", "PID_GET", "PID_GAIN", "PID_PARAM", "PID_STREAM", "AT")}
+MOTION = {proto_bin.LIFT_UP, proto_bin.LIFT_DOWN, proto_bin.LIFT_STOP, proto_bin.LIFT_SET, proto_bin.ESTOP}
+SEQ_NONE, SEQ_TIMED = 0x100, 0x200
+CMD_NAME = re.compile(rb"\{\s*\"([A-Z0-9_]+)\"\s*,")
+
+
+def command_names(src):
+    names = {}
+    for root, _, files in os.walk(src):
+        for name in files:
+            if name.endswith(".c"):
+                for m in CMD_NAME.finditer(open(os.path.join(root, name), "rb").read()):
+                    names[fnv1a(m.group(1))] = m.group(1).decode()
+    return names
+
+
+class Dump:
+    """Collects one dump from raw log-channel bytes."""
+
+    def __init__(self):
+        self.dec = proto_bin.Decoder()
+        self.info = None
+        self.raw = []
+        self.lost_frames = 0
+        self._next_seq = 0
+
+    def feed(self, data):
+        for msg_type, seq, payload in self.dec.feed(data):
+            if msg_type == TRACE_INFO and len(payload) == INFO.size:
+                end, count, lost, mhz, frozen = INFO.unpack(payload)
+                self.info = {"end": end, "count": count, "lost": lost, "mhz": mhz, "frozen": frozen}
+                self.raw, self._next_seq = [], 1
+            elif msg_type == TRACE and self.info is not None:
+                self.lost_frames += (seq - self._next_seq) & 0xFF
+                self._next_seq = (seq + 1) & 0xFF
+                self.raw += [REC.unpack_from(payload, i) for i in range(0, len(payload) - REC.size + 1, REC.size)]
+
+    def done(self):
+        return self.info is not None and len(self.raw) >= self.info["count"]
+
+
+def timeline(raw, mhz):
+    """Records with t_us (unwrapped, from the first record) and ms (controller time, None before any CLOCK)."""
+    recs, t, prev = [], 0, None
+    for cyc, ev, a, b, c in raw:
+        if prev is not None:
+            t += struct.unpack("<i", struct.pack("<I", (cyc - prev) & 0xFFFFFFFF))[0]
+        prev = cyc
+        recs.append({"t_us": t / float(mhz), "ev": ev, "a": a, "b": b, "c": c, "ms": None})
+    anchors = [(r["t_us"], r["c"]) for r in recs if r["ev"] == 1]
+    for r in recs:
+        if anchors:
+            t0, ms0 = min(anchors, key=lambda x: abs(x[0] - r["t_us"]))
+            r["ms"] = ms0 + (r["t_us"] - t0) / 1000.0
+    return recs
+
+
+def _seq(b):
+    s = "-" if b & SEQ_NONE else "%d" % (b & 0xFF)
+    return s + (" (timed)" if b & SEQ_TIMED else "")
+
+
+def _state(i):
+    return STATES[i] if i < len(STATES) else "?%d" % i
+
+
+def describe(r, names):
+    ev, a, b, c = r["ev"], r["a"], r["b"], r["c"]
+    if ev == 1:
+        return "CLOCK   %d ms" % c
+    if ev == 2:
+        event = FSM_EVENTS[a] if a < len(FSM_EVENTS) else a
+        return "FSM     %s -> %s on %s (arg %d)" % (_state(b >> 8), _state(b & 0xFF), event, c)
+    if ev == 3:
+        name = names.get(c, "0x%08x" % c) if c else MSG.get(a, "0x%02x" % a)
+        return "CMD     %s seq %s" % (name, _seq(b))
+    if ev == 4:
+        return "REPLY   seq %s %s" % (_seq(b), proto_bin.STATUS.get(a, a))
+    if ev == 5:
+        return "RELAY   %s%s" % (RELAY.get(a, a), " (e-stop latch)" if b else "")
+    if ev in (6, 7):
+        return "%-7s id 0x%03x len %d data %08x" % (EVENTS[ev], b, a, c)
+    if ev == 8:
+        detail = {1: "%d cycles to relay open" % c, 2: "event %d arg %d" % (b, c),
+                  3: "id 0x%03x %s" % (b, "timeout" if c else "no mailbox")}.get(a, "b %d c %d" % (b, c))
+        return "FAULT   %s %s" % (FAULTS.get(a, a), detail)
+    return "EV%d    a %d b %d c %d" % (ev, a, b, c)
+
+
+def latencies(recs, mhz):
+    """Pairs related events; returns {name: [latency_us, ...]}."""
+    out = {"cmd -> reply": [], "motion cmd -> relay": [], "estop -> relay open": [], "can tx -> rx": []}
+    pending_cmd, motion_t, can_t = {}, None, None
+    for r in recs:
+        ev = r["ev"]
+        if ev == 3:
+            if not r["b"] & SEQ_NONE:
+                pending_cmd[r["b"] & 0xFF] = r["t_us"]
+            if r["a"] in MOTION:
+                motion_t = r["t_us"]
+        elif ev == 4 and not r["b"] & SEQ_NONE and (r["b"] & 0xFF) in pending_cmd:
+            out["cmd -> reply"].append(r["t_us"] - pending_cmd.pop(r["b"] & 0xFF))
+        elif ev == 5 and motion_t is not None:
+            out["motion cmd -> relay"].append(r["t_us"] - motion_t)
+            motion_t = None
+        elif ev == 8 and r["a"] == 1:
+            out["estop -> relay open"].append(r["c"] / float(mhz))
+        elif ev == 6:
+            can_t = r["t_us"]
+        elif ev == 7 and can_t is not None:
+            out["can tx -> rx"].append(r["t_us"] - can_t)
+            can_t = None
+    # time spent in each state, between consecutive FSM records
+    fsm = [r for r in recs if r["ev"] == 2]
+    for x, y in zip(fsm, fsm[1:]):
+        out.setdefault("in state %s" % _state(x["b"] & 0xFF), []).append(y["t_us"] - x["t_us"])
+    return out
+
+
+def report(dump, names):
+    info = dump.info
+    print("trace: %d records (end %d), %d not recorded while paused/frozen, %s, %d frames lost"
+          % (len(dump.raw), info["end"], info["lost"], "frozen after fault" if info["frozen"] else "running",
+             dump.lost_frames))
+    recs = timeline(dump.raw, info["mhz"])
+    for r in recs:
+        ms = "%10.3f" % r["ms"] if r["ms"] is not None else "%10s" % "?"
+        print("%s ms %12.1f us  %s" % (ms, r["t_us"], describe(r, names)))
+    print("\n%-24s %5s %10s %10s %10s" % ("latency (us)", "n", "min", "avg", "max"))
+    for name, v in latencies(recs, info["mhz"]).items():
+        if v:
+            print("%-24s %5d %10.1f %10.1f %10.1f" % (name, len(v), min(v), sum(v) / len(v), max(v)))
+
+
+def capture(port, baud, cmd_port, timeout=3.0):
+    import serial  # pyserial
+
+    link = serial.Serial(port, baud, timeout=0.05)
+    cmd = link if cmd_port in ("", port) else serial.Serial(cmd_port, 115200, timeout=0.05)
+    link.reset_input_buffer()
+    cmd.write(b"$TRACE_DUMP#")
+    dump, blob = Dump(), b""
+    t0 = time.perf_counter()
+    while not dump.done() and time.perf_counter() - t0 < timeout:
+        data = link.read(4096)
+        blob += data
+        dump.feed(data)
+    return dump, blob
+
+
+def selftest():
+    names = {fnv1a(b"TRACE_DUMP"): "TRACE_DUMP"}
+    base = 0xFFFFFF00                                                       # CLOCK just before the DWT wrap
+    raw = [(0, 1, 0, 0, 5000),
+           (720, 3, proto_bin.LIFT_SET, 7, 0),                              # +10 us binary LIFT_SET seq 7
+           (1440, 4, 0, 7, proto_bin.LIFT_SET),                             # ACK after the wrap
+           (2160, 2, 3, (1 << 8) | 2, 0),                                   # idle -> lift_moving
+           (7200, 5, 1, 0, 0),                                              # relay A
+           (72000, 8, 1, 0, 360),                                           # e-stop, 5 us to relay open
+           (72100, 5, 0, 1, 0),
+           (73000, 2, 2, (2 << 8) | 3, 0)]                                  # lift_moving -> error
+    raw = [((base + r[0]) & 0xFFFFFFFF,) + r[1:] for r in raw]
+    info = INFO.pack(0x1234, len(raw), 2, 72, 1)
+    wire = proto_bin.encode(TRACE_INFO, 0, info)
+    for i in range(0, len(raw), 4):
+        wire += proto_bin.encode(TRACE, 1 + i // 4, b"".join(REC.pack(*r) for r in raw[i:i + 4]))
+    dump = Dump()
+    dump.feed(wire)
+    assert dump.done() and dump.info["frozen"] == 1 and dump.lost_frames == 0 and len(dump.raw) == 8
+    recs = timeline(dump.raw, 72)
+    assert abs(recs[2]["t_us"] - 20.0) < 1e-6 and abs(recs[7]["t_us"] - 73000 / 72.0) < 1e-6
+    assert abs(recs[1]["ms"] - 5000.01) < 1e-6
+    lat = latencies(recs, 72)
+    assert abs(lat["cmd -> reply"][0] - 10.0) < 1e-6
+    assert lat["estop -> relay open"] == [5.0] and len(lat["motion cmd -> relay"]) == 1
+    assert describe(recs[3], names).startswith("FSM     idle -> lift_moving on LIFT_MOVE")
+    assert describe({"ev": 3, "a": 0, "b": SEQ_NONE, "c": fnv1a(b"TRACE_DUMP")}, names) == "CMD     TRACE_DUMP seq -"
+    print("selftest OK")
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+def main():
+    if "--selftest" in sys.argv:
+        selftest()
+        return
+    src = _arg("--src", os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "src"))
+    if "--load" in sys.argv:
+        dump = Dump()
+        dump.feed(open(_arg("--load", ""), "rb").read())
+    else:
+        dump, blob = capture(_arg("--port", ""), _arg("--baud", 921600), _arg("--cmd-port", ""))
+        if "--save" in sys.argv:
+            open(_arg("--save", ""), "wb").write(blob)
+    if not dump.info:
+        print("no TRACE_INFO frame received")
+        sys.exit(1)
+    report(dump, command_names(src))
+
+
+if __name__ == "__main__":
+    main()
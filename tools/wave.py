@@ -0,0 +1,144 @@
+"""Waveform stream decoder and format benchmark for s_log_wave.
+
+On the log channel (USART2) s_log_wave sends binary WAVE frames by default:
+the binary protocol of proto_bin.py with type WAVE (0xA7) and n little-endian
+f32 values as payload. They share the COBS stream with LOG, TELEMETRY, TRACE
+and PID_SAMPLE frames; the sequence number counts lost frames. $WAVE_FMT:0#
+switches back to text lines "[WAVE] : v1,v2,...". Commands go to USART1.
+
+Usage:
+    python wave.py --cmd-port COM3 --bench           # $WAVE_BENCH for 1..16 channels, bytes/cycles per sample
+    python wave.py --port COM4 [--baud 921600] [--cmd-port COM3] [--seconds 5]
+    python wave.py --selftest
+"""
+
+import re
+import struct
+import sys
+import time
+
+import proto_bin
+
+WAVE = 0xA7
+BENCH = re.compile(rb"\$WAVE_BENCH:([\d,]+)#")
+WAVE_STATS = re.compile(rb"\$WAVE:([\d,]+)#")
+CPU_HZ = 72000000
+MAX_CH = 12  # LOG_WAVE_MAX_CH
+
+
+def encode(values, seq=0):
+    return proto_bin.encode(WAVE, seq, struct.pack("<%df" % len(values), *values))
+
+
+class Stream:
+    """Feeds raw UART bytes, returns WAVE frames as lists of floats.
+
+    Frames of other types on the same port (LOG, TELEMETRY, ...) are skipped;
+    CRC/COBS errors (partial frames at start-up, text lines) are counted as
+    junk. Lost frames are counted from gaps in the sequence number.
+    """
+
+    def __init__(self):
+        self.dec = proto_bin.Decoder()
+        self.channels = None
+        self.frames = 0
+        self.lost = 0
+        self._last_seq = None
+
+    @property
+    def junk(self):
+        return self.dec.crc_errors + self.dec.frame_errors
+
+    def feed(self, data):
+        frames = []
+        for msg_type, seq, payload in self.dec.feed(data):
+            if msg_type != WAVE or not payload or len(payload) % 4:
+                continue
+            if self._last_seq is not None:
+                self.lost += (seq - self._last_seq - 1) & 0xFF
+            self._last_seq = seq
+            self.channels = len(payload) // 4
+            self.frames += 1
+            frames.append(list(struct.unpack("<%df" % self.channels, payload)))
+        return frames
+
+
+def _query(link, cmd, pattern, timeout=0.5):
+    link.reset_input_buffer()
+    link.write(cmd)
+    t0, buf = time.perf_counter(), b""
+    while time.perf_counter() - t0 < timeout:
+        buf += link.read(link.in_waiting or 1)
+        m = pattern.search(buf)
+        if m:
+            return [int(v) for v in m.group(1).split(b",")]
+    return None
+
+
+def bench(cmd):
+    print("%3s | %14s %14s | %14s %14s | %s" % ("ch", "text B/sample", "text cyc/smp", "float B/sample",
+                                                "float cyc/smp", "max Hz @921600 text/float"))
+    for ch in (1, 2, 4, 8, MAX_CH):
+        r = _query(cmd, b"$WAVE_BENCH:%d#" % ch, BENCH)
+        if not r:
+            print("%3d | no reply" % ch)
+            continue
+        _, tb, tc, fb, fc = r
+        print("%3d | %14.1f %14.0f | %14.1f %14.0f | %d / %d"
+              % (ch, tb / ch, tc / ch, fb / ch, fc / ch, 92160 // tb, 92160 // fb))
+
+
+def capture(port, baud, cmd_port, seconds):
+    import serial  # pyserial
+
+    link = serial.Serial(port, baud, timeout=0.05)
+    cmd = serial.Serial(cmd_port, 115200, timeout=0.05) if cmd_port else None
+    if cmd:
+        _query(cmd, b"$WAVE_STATS#", WAVE_STATS)  # clears the controller-side counters
+    stream = Stream()
+    total, last = 0, None
+    t0 = time.perf_counter()
+    while time.perf_counter() - t0 < seconds:
+        data = link.read(4096)
+        total += len(data)
+        for frame in stream.feed(data):
+            last = frame
+    dt = time.perf_counter() - t0
+    print("%d frames x %s channels, %.1f Hz, %.0f B/s (%.1f%% of link), %d lost, %d junk segments"
+          % (stream.frames, stream.channels, stream.frames / dt, total / dt, 100.0 * total * 10 / dt / baud,
+             stream.lost, stream.junk))
+    if last:
+        print("last frame %s" % ["%.4f" % v for v in last])
+    if cmd:
+        stats = _query(cmd, b"$WAVE_STATS#", WAVE_STATS)
+        if stats:
+            fmt, frames, nbytes, dropped, avg_cyc, max_cyc = stats
+            print("controller: %s, %d frames, %d bytes, %d dropped, %d avg / %d max cycles per frame (%.1f us)"
+                  % ("WAVE frames" if fmt else "text", frames, nbytes, dropped, avg_cyc, max_cyc,
+                     avg_cyc * 1e6 / CPU_HZ))
+
+
+def selftest():
+    wire = encode([1.5, -2.25, 100.0], 0) + proto_bin.encode(0xA3, 0, b"log") + encode([0.0, 0.0, 1.0], 2)
+    stream = Stream()
+    got = stream.feed(b"\x12\x34\x00" + wire[:7])  # junk before the first delimiter, then a split frame
+    got += stream.feed(wire[7:] + b"[WAVE] : 1.0\r\n\x00")
+    assert got == [[1.5, -2.25, 100.0], [0.0, 0.0, 1.0]], got
+    assert stream.channels == 3 and stream.frames == 2 and stream.lost == 1 and stream.junk == 2
+    assert len(encode([0.0] * 4)) == 23
+    print("selftest OK")
+
+
+def _arg(name, default):
+    return type(default)(sys.argv[sys.argv.index(name) + 1]) if name in sys.argv else default
+
+
+if __name__ == "__main__":
+    if "--selftest" in sys.argv:
+        selftest()
+    elif "--bench" in sys.argv:
+        import serial  # pyserial
+
+        bench(serial.Serial(_arg("--cmd-port", ""), 115200, timeout=0.05))
+    else:
+        capture(_arg("--port", ""), _arg("--baud", 921600), _arg("--cmd-port", ""), _arg("--seconds", 5.0))